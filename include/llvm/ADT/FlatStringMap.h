@@ -0,0 +1,288 @@
+//===--- FlatStringMap.h - Open-addressing string map -----------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the FlatStringMap class, a drop-in alternative to
+// StringMap for large, lookup-heavy symbol tables.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_FLATSTRINGMAP_H
+#define LLVM_ADT_FLATSTRINGMAP_H
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm {
+
+/// FlatStringMapImpl - This is the base class of FlatStringMap that is shared
+/// among all of its instantiations.
+///
+/// Besides the array of entry pointers, which is laid out exactly like the
+/// one of StringMap so that the StringMap iterators can walk it, the table
+/// keeps one control byte per bucket.  A control byte is either EmptyCtrl,
+/// DeletedCtrl or seven bits of the hash of the key in the bucket.  Buckets
+/// are probed a group of GroupSize control bytes at a time, with SSE2 when
+/// it is available, so that a lookup usually touches one cache line of
+/// control bytes and one entry.
+class FlatStringMapImpl {
+protected:
+  // Array of NumBuckets pointers to entries, null pointers are holes.
+  // TheTable[NumBuckets] contains a sentinel value for easy iteration.
+  // Followed by an array of NumBuckets control bytes.
+  StringMapEntryBase **TheTable;
+  unsigned NumBuckets;
+  unsigned NumItems;
+  unsigned NumTombstones;
+  unsigned ItemSize;
+
+  static const unsigned GroupSize = 16;
+  static const int8_t EmptyCtrl = -128;
+  static const int8_t DeletedCtrl = -2;
+
+protected:
+  explicit FlatStringMapImpl(unsigned itemSize) : ItemSize(itemSize) {
+    // Initialize the map with zero buckets to allocation.
+    TheTable = 0;
+    NumBuckets = 0;
+    NumItems = 0;
+    NumTombstones = 0;
+  }
+  FlatStringMapImpl(unsigned InitSize, unsigned ItemSize);
+  void RehashTable();
+
+  /// LookupBucketFor - Look up the bucket that the specified string should
+  /// end up in.  If it already exists as a key in the map, the Item pointer
+  /// for the specified bucket will be non-null and not a tombstone.
+  /// Otherwise, the caller must fill in the returned bucket, whose control
+  /// byte has already been set.
+  unsigned LookupBucketFor(StringRef Key);
+
+  /// FindKey - Look up the bucket that contains the specified key. If it
+  /// exists in the map, return the bucket number of the key.  Otherwise
+  /// return -1.  This does not modify the map.
+  int FindKey(StringRef Key) const;
+
+  /// RemoveKey - Remove the specified StringMapEntry from the table, but do
+  /// not delete it.  This aborts if the value isn't in the table.
+  void RemoveKey(StringMapEntryBase *V);
+
+  /// RemoveKey - Remove the StringMapEntry for the specified key from the
+  /// table, returning it.  If the key is not in the table, this returns null.
+  StringMapEntryBase *RemoveKey(StringRef Key);
+
+  /// clearTable - Mark every bucket empty without touching the entries.
+  void clearTable();
+
+  int8_t *getCtrl() const {
+    return reinterpret_cast<int8_t*>(TheTable + NumBuckets + 1);
+  }
+
+private:
+  void init(unsigned Size);
+  void RemoveBucket(unsigned BucketNo);
+
+public:
+  unsigned getNumBuckets() const { return NumBuckets; }
+  unsigned getNumItems() const { return NumItems; }
+
+  bool empty() const { return NumItems == 0; }
+  unsigned size() const { return NumItems; }
+
+  void swap(FlatStringMapImpl &Other) {
+    std::swap(TheTable, Other.TheTable);
+    std::swap(NumBuckets, Other.NumBuckets);
+    std::swap(NumItems, Other.NumItems);
+    std::swap(NumTombstones, Other.NumTombstones);
+  }
+};
+
+/// FlatStringMap - A string map with the interface of StringMap, whose
+/// buckets are found by probing groups of control bytes.  Lookups take a
+/// StringRef and never copy the key.  Entries are StringMapEntry objects, so
+/// entries may be moved between a StringMap and a FlatStringMap that use the
+/// same allocator.  By default they are allocated from a BumpPtrAllocator
+/// owned by the map and only freed when the map is destroyed.
+template<typename ValueTy, typename AllocatorTy = BumpPtrAllocator>
+class FlatStringMap : public FlatStringMapImpl {
+  AllocatorTy Allocator;
+public:
+  typedef StringMapEntry<ValueTy> MapEntryTy;
+
+  FlatStringMap()
+    : FlatStringMapImpl(static_cast<unsigned>(sizeof(MapEntryTy))) {}
+  explicit FlatStringMap(unsigned InitialSize)
+    : FlatStringMapImpl(InitialSize,
+                        static_cast<unsigned>(sizeof(MapEntryTy))) {}
+
+  explicit FlatStringMap(AllocatorTy A)
+    : FlatStringMapImpl(static_cast<unsigned>(sizeof(MapEntryTy))),
+      Allocator(A) {}
+
+  FlatStringMap(unsigned InitialSize, AllocatorTy A)
+    : FlatStringMapImpl(InitialSize,
+                        static_cast<unsigned>(sizeof(MapEntryTy))),
+      Allocator(A) {}
+
+  FlatStringMap(const FlatStringMap &RHS)
+    : FlatStringMapImpl(static_cast<unsigned>(sizeof(MapEntryTy))) {
+    assert(RHS.empty() &&
+           "Copy ctor from non-empty stringmap not implemented yet!");
+    (void)RHS;
+  }
+  void operator=(const FlatStringMap &RHS) {
+    assert(RHS.empty() &&
+           "assignment from non-empty stringmap not implemented yet!");
+    (void)RHS;
+    clear();
+  }
+
+  typedef typename ReferenceAdder<AllocatorTy>::result AllocatorRefTy;
+  typedef typename ReferenceAdder<const AllocatorTy>::result AllocatorCRefTy;
+  AllocatorRefTy getAllocator() { return Allocator; }
+  AllocatorCRefTy getAllocator() const { return Allocator; }
+
+  typedef const char* key_type;
+  typedef ValueTy mapped_type;
+  typedef StringMapEntry<ValueTy> value_type;
+  typedef size_t size_type;
+
+  typedef StringMapConstIterator<ValueTy> const_iterator;
+  typedef StringMapIterator<ValueTy> iterator;
+
+  iterator begin() {
+    return iterator(TheTable, NumBuckets == 0);
+  }
+  iterator end() {
+    return iterator(TheTable+NumBuckets, true);
+  }
+  const_iterator begin() const {
+    return const_iterator(TheTable, NumBuckets == 0);
+  }
+  const_iterator end() const {
+    return const_iterator(TheTable+NumBuckets, true);
+  }
+
+  iterator find(StringRef Key) {
+    int Bucket = FindKey(Key);
+    if (Bucket == -1) return end();
+    return iterator(TheTable+Bucket, true);
+  }
+
+  const_iterator find(StringRef Key) const {
+    int Bucket = FindKey(Key);
+    if (Bucket == -1) return end();
+    return const_iterator(TheTable+Bucket, true);
+  }
+
+  /// lookup - Return the entry for the specified key, or a default
+  /// constructed value if no such entry exists.
+  ValueTy lookup(StringRef Key) const {
+    int Bucket = FindKey(Key);
+    if (Bucket == -1)
+      return ValueTy();
+    return static_cast<MapEntryTy*>(TheTable[Bucket])->getValue();
+  }
+
+  ValueTy &operator[](StringRef Key) {
+    return GetOrCreateValue(Key).getValue();
+  }
+
+  size_type count(StringRef Key) const {
+    return FindKey(Key) == -1 ? 0 : 1;
+  }
+
+  /// insert - Insert the specified key/value pair into the map.  If the key
+  /// already exists in the map, return false and ignore the request,
+  /// otherwise insert it and return true.
+  bool insert(MapEntryTy *KeyValue) {
+    unsigned BucketNo = LookupBucketFor(KeyValue->getKey());
+    StringMapEntryBase *&Bucket = TheTable[BucketNo];
+    if (Bucket && Bucket != StringMapImpl::getTombstoneVal())
+      return false;  // Already exists in map.
+
+    if (Bucket == StringMapImpl::getTombstoneVal())
+      --NumTombstones;
+    Bucket = KeyValue;
+    ++NumItems;
+    assert(NumItems + NumTombstones <= NumBuckets);
+
+    RehashTable();
+    return true;
+  }
+
+  // clear - Empties out the FlatStringMap
+  void clear() {
+    if (empty()) return;
+
+    for (unsigned I = 0, E = NumBuckets; I != E; ++I) {
+      StringMapEntryBase *Bucket = TheTable[I];
+      if (Bucket && Bucket != StringMapImpl::getTombstoneVal())
+        static_cast<MapEntryTy*>(Bucket)->Destroy(Allocator);
+    }
+    clearTable();
+  }
+
+  /// GetOrCreateValue - Look up the specified key in the table.  If a value
+  /// exists, return it.  Otherwise, default construct a value, insert it, and
+  /// return.
+  template <typename InitTy>
+  MapEntryTy &GetOrCreateValue(StringRef Key, InitTy Val) {
+    unsigned BucketNo = LookupBucketFor(Key);
+    StringMapEntryBase *&Bucket = TheTable[BucketNo];
+    if (Bucket && Bucket != StringMapImpl::getTombstoneVal())
+      return *static_cast<MapEntryTy*>(Bucket);
+
+    MapEntryTy *NewItem =
+      MapEntryTy::Create(Key.begin(), Key.end(), Allocator, Val);
+
+    if (Bucket == StringMapImpl::getTombstoneVal())
+      --NumTombstones;
+    ++NumItems;
+    assert(NumItems + NumTombstones <= NumBuckets);
+
+    // Fill in the bucket for the hash table.  The control byte was already
+    // filled in by LookupBucketFor.
+    Bucket = NewItem;
+
+    RehashTable();
+    return *NewItem;
+  }
+
+  MapEntryTy &GetOrCreateValue(StringRef Key) {
+    return GetOrCreateValue(Key, ValueTy());
+  }
+
+  /// remove - Remove the specified key/value pair from the map, but do not
+  /// erase it.  This aborts if the key is not in the map.
+  void remove(MapEntryTy *KeyValue) {
+    RemoveKey(KeyValue);
+  }
+
+  void erase(iterator I) {
+    MapEntryTy &V = *I;
+    remove(&V);
+    V.Destroy(Allocator);
+  }
+
+  bool erase(StringRef Key) {
+    iterator I = find(Key);
+    if (I == end()) return false;
+    erase(I);
+    return true;
+  }
+
+  ~FlatStringMap() {
+    clear();
+    free(TheTable);
+  }
+};
+
+}
+
+#endif
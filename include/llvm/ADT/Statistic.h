@@ -31,6 +31,7 @@
 
 namespace llvm {
 class raw_ostream;
+class StringRef; // @LOCALMOD
 
 class Statistic {
 public:
@@ -38,8 +39,17 @@ public:
   const char *Desc;
   volatile llvm::sys::cas_flag Value;
   bool Initialized;
-
-  llvm::sys::cas_flag getValue() const { return Value; }
+  // @LOCALMOD-BEGIN
+  /// Index - The slot of this statistic in the per-thread counter shards,
+  /// assigned when the statistic is registered.
+  unsigned Index;
+  // @LOCALMOD-END
+
+  // @LOCALMOD-BEGIN
+  /// getValue - Return the sum of the counts of all threads.  This does not
+  /// take a lock; the counts of threads still running may be out of date.
+  llvm::sys::cas_flag getValue() const;
+  // @LOCALMOD-END
   const char *getName() const { return Name; }
   const char *getDesc() const { return Desc; }
 
@@ -47,66 +57,62 @@ public:
   void construct(const char *name, const char *desc) {
     Name = name; Desc = desc;
     Value = 0; Initialized = 0;
+    Index = 0; // @LOCALMOD
   }
 
   // Allow use of this class as the value itself.
-  operator unsigned() const { return Value; }
+  operator unsigned() const { return getValue(); } // @LOCALMOD
 
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
-   const Statistic &operator=(unsigned Val) {
-    Value = Val;
-    return init();
+  // @LOCALMOD-BEGIN
+  // Each thread counts in its own shard, without atomic operations; the
+  // shards are summed when the value is read.  The postfix operators return
+  // the previous count of the calling thread's shard, not the total.
+  const Statistic &operator=(unsigned Val) {
+    setValue(Val);
+    return *this;
   }
 
   const Statistic &operator++() {
-    // FIXME: This function and all those that follow carefully use an
-    // atomic operation to update the value safely in the presence of
-    // concurrent accesses, but not to read the return value, so the
-    // return value is not thread safe.
-    sys::AtomicIncrement(&Value);
-    return init();
+    ++getCounter();
+    return *this;
   }
 
   unsigned operator++(int) {
-    init();
-    unsigned OldValue = Value;
-    sys::AtomicIncrement(&Value);
-    return OldValue;
+    return getCounter()++;
   }
 
   const Statistic &operator--() {
-    sys::AtomicDecrement(&Value);
-    return init();
+    --getCounter();
+    return *this;
   }
 
   unsigned operator--(int) {
-    init();
-    unsigned OldValue = Value;
-    sys::AtomicDecrement(&Value);
-    return OldValue;
+    return getCounter()--;
   }
 
   const Statistic &operator+=(const unsigned &V) {
     if (!V) return *this;
-    sys::AtomicAdd(&Value, V);
-    return init();
+    getCounter() += V;
+    return *this;
   }
 
   const Statistic &operator-=(const unsigned &V) {
     if (!V) return *this;
-    sys::AtomicAdd(&Value, -V);
-    return init();
+    getCounter() -= V;
+    return *this;
   }
 
   const Statistic &operator*=(const unsigned &V) {
-    sys::AtomicMul(&Value, V);
-    return init();
+    setValue(getValue() * V);
+    return *this;
   }
 
   const Statistic &operator/=(const unsigned &V) {
-    sys::AtomicDiv(&Value, V);
-    return init();
+    setValue(getValue() / V);
+    return *this;
   }
+  // @LOCALMOD-END
 
 #else  // Statistics are disabled in release builds.
 
@@ -157,12 +163,21 @@ protected:
     return *this;
   }
   void RegisterStatistic();
+  // @LOCALMOD-BEGIN
+  /// getCounter - Return the counter of this statistic in the calling
+  /// thread's shard.
+  unsigned &getCounter();
+  /// setValue - Set the total to Val.  This resets the counts of every
+  /// thread, so it may only be called while no other thread that has counted
+  /// statistics is running.
+  void setValue(unsigned Val);
+  // @LOCALMOD-END
 };
 
 // STATISTIC - A macro to make definition of statistics really simple.  This
 // automatically passes the DEBUG_TYPE of the file into the statistic.
 #define STATISTIC(VARNAME, DESC) \
-  static llvm::Statistic VARNAME = { DEBUG_TYPE, DESC, 0, 0 }
+  static llvm::Statistic VARNAME = { DEBUG_TYPE, DESC, 0, 0, 0 } // @LOCALMOD
 
 /// \brief Enable the collection and printing of statistics.
 void EnableStatistics();
@@ -176,6 +191,24 @@ void PrintStatistics();
 /// \brief Print statistics to the given output stream.
 void PrintStatistics(raw_ostream &OS);
 
+// @LOCALMOD-BEGIN
+/// \brief Print statistics to the given output stream as JSON.
+void PrintStatisticsJSON(raw_ostream &OS);
+
+/// \brief Check if statistics are printed as JSON, with -stats-json.
+/// Statistics printed outside of the Statistic class, as plain text, must
+/// not be printed then.
+bool AreStatisticsPrintedAsJSON();
+
+/// \brief Start attributing the statistics bumped by the calling thread to
+/// one function.  Does nothing unless -stats-per-function is given.
+void beginFunctionStatistics();
+
+/// \brief Record what the calling thread counted since the matching
+/// beginFunctionStatistics() under the name of Fn.
+void endFunctionStatistics(StringRef Fn);
+// @LOCALMOD-END
+
 } // End llvm namespace
 
 #endif
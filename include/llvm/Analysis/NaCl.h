@@ -20,6 +20,7 @@ namespace llvm {
 class FunctionPass;
 class ModulePass;
 extern cl::opt<bool> PNaClABIAllowDebugMetadata;
+extern cl::opt<bool> PNaClABIAllowZeroCostEH;
 
 class PNaClABIErrorReporter {
   PNaClABIErrorReporter(const PNaClABIErrorReporter&) LLVM_DELETED_FUNCTION;
@@ -17,8 +17,11 @@
 #define LLVM_BITCODE_NACL_NACLREADERWRITER_H
 
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/DataTypes.h"
+#include "llvm/Support/Mutex.h"
 
 #include <string>
+#include <vector>
 
 namespace llvm {
   class MemoryBuffer;
@@ -37,6 +40,40 @@ namespace llvm {
   /// \brief Defines the integer bit size used to model pointers in PNaCl.
   static const unsigned PNaClIntPtrTypeBitSize = 32;
 
+  /// NaClStreamSharedInfo - Module-level information about a PNaCl bitcode
+  /// stream that is shared between several readers of the same stream, each
+  /// parsing into its own LLVMContext (e.g. the threads of a split-module
+  /// translation).  Currently this records the bit offset of every function
+  /// body, indexed by the position of the function among the functions with
+  /// bodies, so that once one reader has skipped over a body no other reader
+  /// needs to scan the stream for it.  All methods are thread-safe.
+  class NaClStreamSharedInfo {
+  public:
+    NaClStreamSharedInfo() {}
+
+    /// Record that the body of the Index'th defined function starts at Bit.
+    void setFunctionBodyBit(unsigned Index, uint64_t Bit) {
+      sys::SmartScopedLock<false> Lock(InfoLock);
+      if (Index >= FunctionBodyBits.size())
+        FunctionBodyBits.resize(Index + 1, 0);
+      FunctionBodyBits[Index] = Bit;
+    }
+
+    /// Returns the bit where the body of the Index'th defined function
+    /// starts, or 0 if no reader has found it yet.
+    uint64_t getFunctionBodyBit(unsigned Index) const {
+      sys::SmartScopedLock<false> Lock(InfoLock);
+      return Index < FunctionBodyBits.size() ? FunctionBodyBits[Index] : 0;
+    }
+
+  private:
+    mutable sys::SmartMutex<false> InfoLock;
+    std::vector<uint64_t> FunctionBodyBits;
+
+    NaClStreamSharedInfo(const NaClStreamSharedInfo&) LLVM_DELETED_FUNCTION;
+    void operator=(const NaClStreamSharedInfo&) LLVM_DELETED_FUNCTION;
+  };
+
   /// getNaClLazyBitcodeModule - Read the header of the specified bitcode buffer
   /// and prepare for lazy deserialization of function bodies.  If successful,
   /// this takes ownership of 'buffer' and returns a non-null pointer.  On
@@ -63,11 +100,20 @@ namespace llvm {
   ///
   /// See getNaClLazyBitcodeModule for an explanation of argument
   /// AcceptSupportedOnly.
+  ///
+  /// If SharedInfo is non-null, function body offsets found by this reader
+  /// are published to it, and offsets found by other readers of the same
+  /// stream are used instead of scanning for them.  If GlobalsAsDeclarations
+  /// is true, global variables are created as external declarations of the
+  /// right type and their initializers are not built; this is sufficient for
+  /// a module that only compiles function bodies.
   Module *getNaClStreamedBitcodeModule(const std::string &name,
                                        StreamingMemoryObject *streamer,
                                        LLVMContext &Context,
                                        std::string *ErrMsg = 0,
-                                       bool AcceptSupportedOnly = true);
+                                       bool AcceptSupportedOnly = true,
+                                       NaClStreamSharedInfo *SharedInfo = 0,
+                                       bool GlobalsAsDeclarations = false);
 
   /// NaClParseBitcodeFile - Read the specified bitcode file,
   /// returning the module.  If an error occurs, this returns null and
@@ -33,6 +33,7 @@ namespace {
 
       (void) llvm::createFastRegisterAllocator();
       (void) llvm::createBasicRegisterAllocator();
+      (void) llvm::createLinearScanRegisterAllocator(); // @LOCALMOD
       (void) llvm::createGreedyRegisterAllocator();
 #if !defined(__native_client__)
       // Not needed by sandboxed translator.
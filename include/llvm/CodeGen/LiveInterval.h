@@ -529,7 +529,8 @@ namespace llvm {
   public:
     typedef LiveRange super;
 
-    const unsigned reg;  // the register or stack slot of this interval.
+    // @LOCALMOD: Not const; LiveIntervals recycles LiveInterval objects.
+    unsigned reg;        // the register or stack slot of this interval.
     float weight;        // weight of this interval
 
     LiveInterval(unsigned Reg, float Weight)
@@ -94,6 +94,18 @@ namespace llvm {
     /// interference.
     SmallVector<LiveRange*, 0> RegUnitRanges;
 
+    // @LOCALMOD-BEGIN
+    /// Cleared LiveInterval and register unit LiveRange objects, kept across
+    /// functions so that their segment storage is reused instead of going
+    /// back to the heap for every function.
+    SmallVector<LiveInterval*, 0> FreeIntervals;
+    SmallVector<LiveRange*, 0> FreeRegUnitRanges;
+
+    /// Intervals removed from the current function. They only become free at
+    /// releaseMemory(), as LiveIntervalUnion queries cache interval pointers.
+    SmallVector<LiveInterval*, 0> RemovedIntervals;
+    // @LOCALMOD-END
+
   public:
     static char ID; // Pass identification, replacement for typeid
     LiveIntervals();
@@ -133,7 +145,12 @@ namespace llvm {
 
     // Interval removal.
     void removeInterval(unsigned Reg) {
-      delete VirtRegIntervals[Reg];
+      // @LOCALMOD-BEGIN
+      if (LiveInterval *LI = VirtRegIntervals[Reg]) {
+        LI->clear();
+        RemovedIntervals.push_back(LI);
+      }
+      // @LOCALMOD-END
       VirtRegIntervals[Reg] = 0;
     }
 
@@ -368,7 +385,7 @@ namespace llvm {
       LiveRange *LR = RegUnitRanges[Unit];
       if (!LR) {
         // Compute missing ranges on demand.
-        RegUnitRanges[Unit] = LR = new LiveRange();
+        RegUnitRanges[Unit] = LR = createRegUnitRange(); // @LOCALMOD
         computeRegUnitRange(*LR, Unit);
       }
       return *LR;
@@ -391,7 +408,11 @@ namespace llvm {
     /// Compute RegMaskSlots and RegMaskBits.
     void computeRegMasks();
 
-    static LiveInterval* createInterval(unsigned Reg);
+    // @LOCALMOD-BEGIN
+    LiveInterval* createInterval(unsigned Reg);
+    LiveRange *createRegUnitRange();
+    void recycleInterval(LiveInterval *LI);
+    // @LOCALMOD-END
 
     void printInstrs(raw_ostream &O) const;
     void dumpInstrs() const;
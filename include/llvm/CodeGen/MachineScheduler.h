@@ -85,6 +85,11 @@ namespace llvm {
 
 extern cl::opt<bool> ForceTopDown;
 extern cl::opt<bool> ForceBottomUp;
+// @LOCALMOD-BEGIN
+// Limits on the scheduling of huge blocks, 0 when off.
+extern cl::opt<unsigned> MISchedWindow;  // -misched-window
+extern cl::opt<unsigned> HugeMemRegion;  // -sched-huge-mem-region
+// @LOCALMOD-END
 
 class AliasAnalysis;
 class LiveIntervals;
@@ -428,6 +428,14 @@ namespace llvm {
   ///
   FunctionPass *createBasicRegisterAllocator();
 
+  // @LOCALMOD-BEGIN
+  /// LinearScanRegisterAllocation Pass - This pass implements a linear scan
+  /// register allocator on top of LiveIntervals and LiveRegMatrix, trading
+  /// some code quality for allocation speed.
+  ///
+  FunctionPass *createLinearScanRegisterAllocator();
+  // @LOCALMOD-END
+
   /// Greedy register allocation pass - This pass implements a global register
   /// allocator for optimized builds.
   ///
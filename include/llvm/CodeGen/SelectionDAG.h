@@ -1131,6 +1131,10 @@ public:
   unsigned InferPtrAlignment(SDValue Ptr) const;
 
 private:
+  // @LOCALMOD-BEGIN
+  SDNode *newSDNode(unsigned Opcode, SDLoc DL, SDVTList VTs,
+                    const SDValue *Ops, unsigned NumOps);
+  // @LOCALMOD-END
   bool RemoveNodeFromCSEMaps(SDNode *N);
   void AddModifiedNodeToCSEMaps(SDNode *N);
   SDNode *FindModifiedNodeSlot(SDNode *N, SDValue Op, void *&InsertPos);
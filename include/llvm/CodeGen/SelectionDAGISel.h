@@ -254,6 +254,11 @@ private:
 
   /// \brief Perform instruction selection on all basic blocks in the function.
   void SelectAllBasicBlocks(const Function &Fn);
+  // @LOCALMOD-BEGIN
+  /// \brief Select a block consisting only of an unconditional branch with
+  /// FastISel, returning false (and emitting nothing) if that fails.
+  bool SelectTrivialBlock(FastISel *FastIS, const Instruction *Term);
+  // @LOCALMOD-END
 
   /// \brief Perform instruction selection on a single basic block, for
   /// instructions between \p Begin and \p End.  \p HadTailCall will be set
@@ -351,11 +351,19 @@ private:
   // this ordering.
   unsigned IROrder;
 
+  // @LOCALMOD-BEGIN
+  /// CSEHash - The FoldingSetNodeID hash of this node, cached while the node
+  /// is in the SelectionDAG's CSE map so that bucket collisions can be
+  /// rejected without re-profiling the node's operands. Zero if not computed.
+  unsigned CSEHash;
+  // @LOCALMOD-END
+
   /// getValueTypeList - Return a pointer to the specified value type.
   static const EVT *getValueTypeList(EVT VT);
 
   friend class SelectionDAG;
   friend struct ilist_traits<SDNode>;
+  friend struct FoldingSetTrait<SDNode>; // @LOCALMOD
 
 public:
   //===--------------------------------------------------------------------===//
@@ -705,7 +713,7 @@ protected:
       OperandList(NumOps ? new SDUse[NumOps] : 0),
       ValueList(VTs.VTs), UseList(NULL),
       NumOperands(NumOps), NumValues(VTs.NumVTs),
-      debugLoc(dl), IROrder(Order) {
+      debugLoc(dl), IROrder(Order), CSEHash(0) {
     for (unsigned i = 0; i != NumOps; ++i) {
       OperandList[i].setUser(this);
       OperandList[i].setInitial(Ops[i]);
@@ -719,7 +727,7 @@ protected:
     : NodeType(Opc), OperandsNeedDelete(false), HasDebugValue(false),
       SubclassData(0), NodeId(-1), OperandList(0),
       ValueList(VTs.VTs), UseList(NULL), NumOperands(0), NumValues(VTs.NumVTs),
-      debugLoc(dl), IROrder(Order) {}
+      debugLoc(dl), IROrder(Order), CSEHash(0) {}
 
   /// InitOperands - Initialize the operands list of this with 1 operand.
   void InitOperands(SDUse *Ops, const SDValue &Op0) {
@@ -1859,6 +1867,28 @@ public:
   const SDNode *getNode() const { return Node; }
 };
 
+// @LOCALMOD-BEGIN
+/// FoldingSetTrait<SDNode> - Compare nodes in the CSE map by their cached
+/// hash first; most bucket collisions are then rejected without profiling.
+template<> struct FoldingSetTrait<SDNode> : DefaultFoldingSetTrait<SDNode> {
+  static unsigned ComputeHash(SDNode &X, FoldingSetNodeID &TempID) {
+    if (!X.CSEHash) {
+      X.Profile(TempID);
+      X.CSEHash = TempID.ComputeHash();
+    }
+    return X.CSEHash;
+  }
+  static bool Equals(SDNode &X, const FoldingSetNodeID &ID, unsigned IDHash,
+                     FoldingSetNodeID &TempID) {
+    if (ComputeHash(X, TempID) != IDHash)
+      return false;
+    TempID.clear();
+    X.Profile(TempID);
+    return TempID == ID;
+  }
+};
+// @LOCALMOD-END
+
 template <> struct GraphTraits<SDNode*> {
   typedef SDNode NodeType;
   typedef SDNodeIterator ChildIteratorType;
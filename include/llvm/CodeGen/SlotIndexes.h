@@ -356,7 +356,21 @@ namespace llvm {
     // IndexListEntry allocator.
     BumpPtrAllocator ileAllocator;
 
+    // @LOCALMOD-BEGIN
+    /// Entries released by releaseMemory(). They still live in ileAllocator
+    /// and are handed out again by createEntry for the next function.
+    IndexList freeEntries;
+    // @LOCALMOD-END
+
     IndexListEntry* createEntry(MachineInstr *mi, unsigned index) {
+      // @LOCALMOD-BEGIN
+      if (!freeEntries.empty()) {
+        IndexListEntry *entry = freeEntries.remove(freeEntries.begin());
+        entry->setInstr(mi);
+        entry->setIndex(index);
+        return entry;
+      }
+      // @LOCALMOD-END
       IndexListEntry *entry =
         static_cast<IndexListEntry*>(
           ileAllocator.Allocate(sizeof(IndexListEntry),
@@ -92,6 +92,20 @@ public:
   void emitError(const Instruction *I, const Twine &ErrorStr);
   void emitError(const Twine &ErrorStr);
 
+  // @LOCALMOD-BEGIN
+  /// enableThreadSafeUniquing - Guard the type, constant, metadata and
+  /// attribute uniquing tables of this context with locks, so that several
+  /// threads may create types and constants in it concurrently (e.g. while
+  /// materializing and compiling different functions of one module). Must be
+  /// called before the context is shared. Other state, such as the use lists
+  /// of shared constants and value handles, is still not thread-safe.
+  void enableThreadSafeUniquing();
+
+  /// isThreadSafeUniquing - Return true if enableThreadSafeUniquing was
+  /// called on this context.
+  bool isThreadSafeUniquing() const;
+  // @LOCALMOD-END
+
 private:
   LLVMContext(LLVMContext&) LLVM_DELETED_FUNCTION;
   void operator=(LLVMContext&) LLVM_DELETED_FUNCTION;
@@ -14,7 +14,7 @@
 #ifndef LLVM_IR_VALUESYMBOLTABLE_H
 #define LLVM_IR_VALUESYMBOLTABLE_H
 
-#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/FlatStringMap.h" // @LOCALMOD
 #include "llvm/IR/Value.h"
 #include "llvm/Support/DataTypes.h"
 
@@ -43,7 +43,11 @@ class ValueSymbolTable {
 /// @{
 public:
   /// @brief A mapping of names to values.
-  typedef StringMap<Value*> ValueMap;
+  // @LOCALMOD-BEGIN
+  // Names are malloc'ed so that a Value keeps its ValueName when it is moved
+  // out of the table or into another one.
+  typedef FlatStringMap<Value*, MallocAllocator> ValueMap;
+  // @LOCALMOD-END
 
   /// @brief An iterator over a ValueMap.
   typedef ValueMap::iterator iterator;
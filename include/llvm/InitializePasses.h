@@ -286,6 +286,7 @@ void initializeFixVectorLoadStoreAlignmentPass(PassRegistry&);
 void initializeFlattenGlobalsPass(PassRegistry&);
 void initializeGlobalCleanupPass(PassRegistry&);
 void initializeGlobalizeConstantVectorsPass(PassRegistry&);
+void initializeHoistNaClReadTpPass(PassRegistry&);
 void initializeInsertDivideCheckPass(PassRegistry&);
 void initializeNaClCcRewritePass(PassRegistry&);
 void initializePNaClABIVerifyFunctionsPass(PassRegistry&);
@@ -917,13 +917,27 @@ private:
   bool fragmentNeedsRelaxation(const MCRelaxableFragment *IF,
                                const MCAsmLayout &Layout) const;
 
+  // @LOCALMOD-BEGIN
+  /// The fragments of one section which may still change size during
+  /// relaxation, in layout order.
+  typedef std::vector<MCFragment *> RelaxCandidateList;
+
+  /// \brief Collect the relaxation candidates of every section, indexed by
+  /// section layout order. Sections without candidates get an empty list and
+  /// are skipped by the layout loop.
+  void collectRelaxCandidates(const MCAsmLayout &Layout,
+                              std::vector<RelaxCandidateList> &Candidates);
+
   /// \brief Perform one layout iteration and return true if any offsets
   /// were adjusted.
-  bool layoutOnce(MCAsmLayout &Layout);
+  bool layoutOnce(MCAsmLayout &Layout,
+                  std::vector<RelaxCandidateList> &Candidates);
 
   /// \brief Perform one layout iteration of the given section and return true
-  /// if any offsets were adjusted.
-  bool layoutSectionOnce(MCAsmLayout &Layout, MCSectionData &SD);
+  /// if any offsets were adjusted. Candidates which can no longer grow are
+  /// removed from \p Candidates.
+  bool layoutSectionOnce(MCAsmLayout &Layout, RelaxCandidateList &Candidates);
+  // @LOCALMOD-END
 
   bool relaxInstruction(MCAsmLayout &Layout, MCRelaxableFragment &IF);
 
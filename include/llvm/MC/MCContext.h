@@ -11,9 +11,9 @@
 #define LLVM_MC_MCCONTEXT_H
 
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FlatStringMap.h" // @LOCALMOD
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/SmallVector.h"
-#include "llvm/ADT/StringMap.h"
 #include "llvm/MC/MCDwarf.h"
 #include "llvm/MC/SectionKind.h"
 #include "llvm/Support/Allocator.h"
@@ -47,7 +47,9 @@ namespace llvm {
     MCContext(const MCContext&) LLVM_DELETED_FUNCTION;
     MCContext &operator=(const MCContext&) LLVM_DELETED_FUNCTION;
   public:
-    typedef StringMap<MCSymbol*, BumpPtrAllocator&> SymbolTable;
+    // @LOCALMOD-BEGIN
+    typedef FlatStringMap<MCSymbol*, BumpPtrAllocator&> SymbolTable;
+    // @LOCALMOD-END
   private:
     /// The SourceMgr for this object, if any.
     const SourceMgr *SrcMgr;
@@ -72,7 +74,7 @@ namespace llvm {
 
     /// UsedNames - Keeps tracks of names that were used both for used declared
     /// and artificial symbols.
-    StringMap<bool, BumpPtrAllocator&> UsedNames;
+    FlatStringMap<bool, BumpPtrAllocator&> UsedNames; // @LOCALMOD
 
     /// NextUniqueID - The next ID to dole out to an unnamed assembler temporary
     /// symbol.
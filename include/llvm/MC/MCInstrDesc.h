@@ -18,7 +18,9 @@
 #include "llvm/MC/MCInst.h"
 #include "llvm/MC/MCRegisterInfo.h"
 #include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/Support/Compiler.h" // @LOCALMOD
 #include "llvm/Support/DataTypes.h"
+#include <cstddef> // @LOCALMOD
 
 namespace llvm {
 
@@ -129,6 +131,31 @@ namespace MCID {
   };
 }
 
+// @LOCALMOD-BEGIN
+/// MCInstrTablePtr - A pointer into the instruction tables of a target,
+/// stored as a byte offset from the MCInstrTablePtr itself; 0 is the null
+/// pointer.  TableGen emits the instruction descriptors and the operand info
+/// and implicit register lists they refer to as a single object, so the
+/// offsets are constants and the tables need no load-time relocations in
+/// position-independent code.  Their pages then stay clean and are shared by
+/// all the processes that map the same translator.
+///
+/// Because the offset is relative to its own address, an object containing
+/// an MCInstrTablePtr, such as an MCInstrDesc, must not be copied.
+template <typename T>
+struct MCInstrTablePtr {
+  int32_t Offset;
+
+  const T *get() const {
+    if (Offset == 0)
+      return 0;
+    return reinterpret_cast<const T*>(reinterpret_cast<const char*>(this) +
+                                      Offset);
+  }
+  operator const T*() const { return get(); }
+};
+// @LOCALMOD-END
+
 /// MCInstrDesc - Describe properties that are true of each instruction in the
 /// target description file.  This captures information about side effects,
 /// register use and many other things.  There is one instance of this struct
@@ -143,14 +170,28 @@ public:
   unsigned short  Size;          // Number of bytes in encoding.
   unsigned        Flags;         // Flags identifying machine instr class
   uint64_t        TSFlags;       // Target Specific Flag values
-  const uint16_t *ImplicitUses;  // Registers implicitly read by this instr
-  const uint16_t *ImplicitDefs;  // Registers implicitly defined by this instr
-  const MCOperandInfo *OpInfo;   // 'NumOperands' entries about operands
+  // @LOCALMOD-BEGIN
+  MCInstrTablePtr<uint16_t> ImplicitUses; // Registers implicitly read
+  MCInstrTablePtr<uint16_t> ImplicitDefs; // Registers implicitly defined
+  MCInstrTablePtr<MCOperandInfo> OpInfo;  // 'NumOperands' operand entries
+  // @LOCALMOD-END
   uint64_t DeprecatedFeatureMask;// Feature bits that this is deprecated on, if any
   // A complex method to determine is a certain is deprecated or not, and return
   // the reason for deprecation.
   bool (*ComplexDeprecationInfo)(MCInst &, MCSubtargetInfo &, std::string &);
 
+  // @LOCALMOD-BEGIN
+  // A copy would resolve the MCInstrTablePtr offsets from its own address.
+  // A declared copy constructor would stop TableGen from emitting the tables
+  // as aggregates in C++03, so the check is only made by C++11 compilers.
+#if __has_feature(cxx_deleted_functions) || defined(__GXX_EXPERIMENTAL_CXX0X__)
+private:
+  MCInstrDesc(const MCInstrDesc &) LLVM_DELETED_FUNCTION;
+  void operator=(const MCInstrDesc &) LLVM_DELETED_FUNCTION;
+public:
+#endif
+  // @LOCALMOD-END
+
   /// \brief Returns the value of the specific constraint if
   /// it is set. Returns -1 if it is not set.
   int getOperandConstraint(unsigned OpNum,
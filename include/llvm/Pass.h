@@ -307,6 +307,14 @@ public:
 
   ///  Return what kind of Pass Manager can manage this pass.
   virtual PassManagerType getPotentialPassManagerType() const;
+
+  // @LOCALMOD-BEGIN
+  /// skipOptnoneFunction - Optional passes call this function to check
+  /// whether the pass should be skipped. This is the case when the function
+  /// has the optnone attribute, e.g. because pnacl-llc moved it to the fast
+  /// path after it exceeded the compile budget.
+  bool skipOptnoneFunction(const Function &F) const;
+  // @LOCALMOD-END
 };
 
 
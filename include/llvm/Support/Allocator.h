@@ -71,6 +71,10 @@ public:
 /// MallocSlabAllocator - The default slab allocator for the bump allocator
 /// is an adapter class for MallocAllocator that just forwards the method
 /// calls and translates the arguments.
+// @LOCALMOD-BEGIN
+/// If a process-wide slab allocator has been installed with
+/// setGlobalSlabAllocator(), slabs are obtained from that instead.
+// @LOCALMOD-END
 class MallocSlabAllocator : public SlabAllocator {
   /// Allocator - The underlying allocator that we forward to.
   ///
@@ -83,6 +87,56 @@ public:
   virtual void Deallocate(MemSlab *Slab) LLVM_OVERRIDE;
 };
 
+// @LOCALMOD-BEGIN
+/// HugePageSlabAllocator - Carves slabs whose size is a power of two, up to
+/// 2MB, out of 2MB-aligned regions that the OS is asked to back with huge
+/// pages.  Freed slabs are kept for reuse and the regions are never
+/// returned.  Other sizes are forwarded to malloc.  Thread-safe.
+class HugePageSlabAllocator : public SlabAllocator {
+  void *Impl;
+
+public:
+  HugePageSlabAllocator();
+  virtual ~HugePageSlabAllocator();
+  virtual MemSlab *Allocate(size_t Size) LLVM_OVERRIDE;
+  virtual void Deallocate(MemSlab *Slab) LLVM_OVERRIDE;
+};
+
+/// RecyclingSlabAllocator - Keeps freed slabs whose size is a power of two
+/// in a per-thread cache, so short-lived bump allocators reuse slabs instead
+/// of going back to the underlying allocator every time.  At most
+/// MaxCachedBytes are cached per thread; a thread's cache is handed back to
+/// the underlying allocator when the thread exits.  Thread-safe as long as
+/// the underlying allocator is.
+class RecyclingSlabAllocator : public SlabAllocator {
+  SlabAllocator &Underlying;
+  size_t MaxCachedBytes;
+  void *Key;
+
+public:
+  explicit RecyclingSlabAllocator(SlabAllocator &Underlying,
+                                  size_t MaxCachedBytes = 8 << 20);
+  virtual ~RecyclingSlabAllocator();
+  virtual MemSlab *Allocate(size_t Size) LLVM_OVERRIDE;
+  virtual void Deallocate(MemSlab *Slab) LLVM_OVERRIDE;
+
+  SlabAllocator &getUnderlying() const { return Underlying; }
+  size_t getMaxCachedBytes() const { return MaxCachedBytes; }
+};
+
+/// setGlobalSlabAllocator - Route the slabs of every bump allocator that was
+/// not given an explicit SlabAllocator through A.  A must live until the
+/// end of the process, must be able to free slabs that came from malloc,
+/// and must be installed before any thread is started; it cannot be
+/// uninstalled.
+void setGlobalSlabAllocator(SlabAllocator *A);
+
+/// enableSlabRecycling - Install a process-lifetime RecyclingSlabAllocator,
+/// optionally on top of a HugePageSlabAllocator, as the global slab
+/// allocator.  Calling it again has no effect.
+void enableSlabRecycling(bool UseHugePages);
+// @LOCALMOD-END
+
 /// BumpPtrAllocator - This allocator is useful for containers that need
 /// very simple memory allocation strategies.  In particular, this just keeps
 /// allocating memory, and never deletes it until the entire block is dead. This
@@ -0,0 +1,84 @@
+//===-- llvm/Support/Trace.h - Low-overhead trace scopes --------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares TraceScope, a cheap alternative to Timer for profiling
+// the phases of a compilation.  Each thread records the scopes it leaves in a
+// ring buffer of its own, using only the monotonic clock, and the buffers are
+// written out as Chrome trace-event JSON (chrome://tracing) when tracing is
+// stopped.  Scopes nest, so a trace shows the phases, the functions compiled
+// in each phase and the passes run on each function.
+//
+// Tracing is enabled with -trace-file=<path> or startTracing().  When it is
+// disabled a TraceScope costs a test of a global flag.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_TRACE_H
+#define LLVM_SUPPORT_TRACE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Atomic.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm {
+
+/// TraceEnabled - Non-zero while trace scopes are being recorded.  Other
+/// threads may be inside trace scopes when it changes.  Only read this
+/// through TraceScope.
+extern volatile sys::cas_flag TraceEnabled;
+
+/// TraceScope - Records the time between its construction and its
+/// destruction as an event with the given category and name.  The category
+/// and a name given as a C string must outlive the trace, as pass names and
+/// string literals do; a name given as a StringRef is copied.
+class TraceScope {
+  const char *Category;
+  const char *Name;
+  uint64_t Start;
+
+  TraceScope(const TraceScope &) LLVM_DELETED_FUNCTION;
+  void operator=(const TraceScope &) LLVM_DELETED_FUNCTION;
+
+  void begin(const char *Cat, const char *N);
+  void begin(const char *Cat, StringRef N);
+  void end();
+
+public:
+  TraceScope(const char *Cat, const char *N) : Category(0) {
+    if (LLVM_UNLIKELY(TraceEnabled))
+      begin(Cat, N);
+  }
+  TraceScope(const char *Cat, StringRef N) : Category(0) {
+    if (LLVM_UNLIKELY(TraceEnabled))
+      begin(Cat, N);
+  }
+  ~TraceScope() {
+    if (LLVM_UNLIKELY(Category != 0))
+      end();
+  }
+};
+
+/// startTracing - Start recording trace scopes; stopTracing writes them to
+/// Path.  This is done automatically for -trace-file.  Other threads may be
+/// running; the events they recorded before are discarded.
+void startTracing(StringRef Path);
+
+/// stopTracing - Stop recording and write the events recorded so far by all
+/// threads to the trace file.  Must not race with threads that are still
+/// inside trace scopes.  Returns false if the file could not be written.
+bool stopTracing();
+
+/// setTraceThreadName - Name the calling thread in the trace.  This does not
+/// allocate the thread's event ring, which is only done once tracing is on.
+void setTraceThreadName(StringRef Name);
+
+} // End llvm namespace
+
+#endif
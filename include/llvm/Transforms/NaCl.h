@@ -10,6 +10,7 @@
 #ifndef LLVM_TRANSFORMS_NACL_H
 #define LLVM_TRANSFORMS_NACL_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/CodeGen/Passes.h"
 
 namespace llvm {
@@ -31,6 +32,7 @@ BasicBlockPass *createFixVectorLoadStoreAlignmentPass();
 BasicBlockPass *createPromoteI1OpsPass();
 FunctionPass *createExpandConstantExprPass();
 FunctionPass *createExpandStructRegsPass();
+FunctionPass *createHoistNaClReadTpPass();
 FunctionPass *createInsertDivideCheckPass();
 FunctionPass *createPromoteIntegersPass();
 FunctionPass *createRemoveAsmMemoryPass();
@@ -63,6 +65,11 @@ void PNaClABISimplifyAddPostOptPasses(PassManagerBase &PM);
 Instruction *PhiSafeInsertPt(Use *U);
 void PhiSafeReplaceUses(Use *U, Value *NewVal);
 
+// Replace all uses of each key of Map with its mapped value, as if by
+// calling replaceAllUsesWith() on every entry.  No mapped value may
+// itself be a key of Map.
+void ReplaceAllUsesWithMap(const DenseMap<Value *, Value *> &Map);
+
 // Copy debug information from Original to NewInst, and return NewInst.
 Instruction *CopyDebug(Instruction *NewInst, Instruction *Original);
 
@@ -16,6 +16,7 @@
 #include "llvm/ADT/Twine.h"
 #include "llvm/Analysis/NaCl.h"
 #include "llvm/Analysis/NaCl/PNaClABITypeChecker.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
@@ -73,6 +74,41 @@ static bool isValidPointerType(Type *Ty) {
   return false;
 }
 
+// The {i8*, i32} exception and selector pair produced by landingpad.
+static bool isLandingPadType(const Type *Ty) {
+  const StructType *STy = dyn_cast<StructType>(Ty);
+  if (!STy || STy->getNumElements() != 2)
+    return false;
+  const PointerType *PtrTy = dyn_cast<PointerType>(STy->getElementType(0));
+  return PtrTy && PtrTy->getElementType()->isIntegerTy(8) &&
+         STy->getElementType(1)->isIntegerTy(32);
+}
+
+// The exception pointer extracted from a landingpad's result.
+static bool isExceptionPtr(const Value *Val) {
+  if (!PNaClABIAllowZeroCostEH)
+    return false;
+  const ExtractValueInst *EV = dyn_cast<ExtractValueInst>(Val);
+  return EV && isa<LandingPadInst>(EV->getAggregateOperand()) &&
+         EV->getIndices()[0] == 0;
+}
+
+// Landing pad clauses name the type_info of the caught types: a null
+// pointer for catch (...), or a reference to a global variable.  Filter
+// clauses are arrays of these.
+static bool isValidLandingPadClause(const Constant *C) {
+  if (isa<ConstantAggregateZero>(C))
+    return true;
+  if (const ConstantArray *Filter = dyn_cast<ConstantArray>(C)) {
+    for (unsigned I = 0, E = Filter->getNumOperands(); I != E; ++I)
+      if (!isValidLandingPadClause(Filter->getOperand(I)))
+        return false;
+    return true;
+  }
+  return C->isNullValue() ||
+         isa<GlobalVariable>(C->stripPointerCasts());
+}
+
 static bool isIntrinsicFunc(const Value *Val) {
   if (const Function *F = dyn_cast<Function>(Val))
     return F->isIntrinsic();
@@ -85,11 +121,12 @@ static bool isIntrinsicFunc(const Value *Val) {
 // InherentPtrs exclude intrinsic functions in order to prevent taking
 // the address of an intrinsic function.  InherentPtrs include
 // intrinsic calls because some intrinsics return pointer types
-// (e.g. nacl.read.tp returns i8*).
+// (e.g. nacl.read.tp returns i8*), and the exception pointer of a
+// landing pad.
 static bool isInherentPtr(const Value *Val) {
   return isa<AllocaInst>(Val) ||
          (isa<GlobalValue>(Val) && !isIntrinsicFunc(Val)) ||
-         isa<IntrinsicInst>(Val);
+         isa<IntrinsicInst>(Val) || isExceptionPtr(Val);
 }
 
 // NormalizedPtrs may be used where pointer types are required -- for
@@ -177,8 +214,47 @@ static bool hasAllowedAtomicRMWOperation(
   return true;
 }
 
+// Returns whether memory order \p MO can be used by the atomic
+// intrinsic \p ID, following C11/C++11.  \p Success is the success
+// memory order when \p MO is the failure memory order of a compare
+// exchange, and MemoryOrderInvalid otherwise.
+static bool isAllowedMemoryOrder(Intrinsic::ID ID, NaCl::MemoryOrder MO,
+                                 NaCl::MemoryOrder Success) {
+  switch (ID) {
+  default:
+    return false;
+  case Intrinsic::nacl_atomic_load:
+    return MO != NaCl::MemoryOrderRelease &&
+           MO != NaCl::MemoryOrderAcquireRelease;
+  case Intrinsic::nacl_atomic_store:
+    return MO == NaCl::MemoryOrderRelaxed ||
+           MO == NaCl::MemoryOrderRelease ||
+           MO == NaCl::MemoryOrderSequentiallyConsistent;
+  case Intrinsic::nacl_atomic_rmw:
+    return true;
+  case Intrinsic::nacl_atomic_cmpxchg:
+    if (Success == NaCl::MemoryOrderInvalid)
+      return true;
+    // The failure memory order can't have a release part, and can't be
+    // stronger than the success memory order without its release part.
+    if (MO == NaCl::MemoryOrderRelease ||
+        MO == NaCl::MemoryOrderAcquireRelease)
+      return false;
+    if (Success == NaCl::MemoryOrderRelease)
+      Success = NaCl::MemoryOrderRelaxed;
+    else if (Success == NaCl::MemoryOrderAcquireRelease)
+      Success = NaCl::MemoryOrderAcquire;
+    return MO <= Success;
+  case Intrinsic::nacl_atomic_fence:
+    // A relaxed fence has no effect, and can't be expressed in LLVM IR.
+    return MO != NaCl::MemoryOrderRelaxed;
+  }
+}
+
 static bool hasAllowedAtomicMemoryOrder(
     const NaCl::AtomicIntrinsics::AtomicIntrinsic *I, const CallInst *Call) {
+  Intrinsic::ID ID = I->ID;
+  NaCl::MemoryOrder Success = NaCl::MemoryOrderInvalid;
   for (size_t P = 0; P != I->NumParams; ++P) {
     if (I->ParamType[P] != NaCl::AtomicIntrinsics::Mem)
       continue;
@@ -192,13 +268,11 @@ static bool hasAllowedAtomicMemoryOrder(
     const APInt &I = C->getUniqueInteger();
     if (I.ule(NaCl::MemoryOrderInvalid) || I.uge(NaCl::MemoryOrderNum))
       return false;
-    // TODO For now only sequential consistency is allowed. When more
-    //      are allowed we need to validate that the memory order is
-    //      allowed on the specific atomic operation (e.g. no store
-    //      acquire, and relationship between success/failure memory
-    //      order on compare exchange).
-    if (I != NaCl::MemoryOrderSequentiallyConsistent)
+    NaCl::MemoryOrder MO = NaCl::MemoryOrder(I.getLimitedValue());
+    if (!isAllowedMemoryOrder(ID, MO, Success))
       return false;
+    // Compare exchange's failure memory order follows its success one.
+    Success = MO;
   }
   return true;
 }
@@ -247,17 +321,10 @@ const char *PNaClABIVerifyFunctions::checkInstruction(const DataLayout *DL,
     case Instruction::GetElementPtr:
     // VAArg is expanded out by ExpandVarArgs.
     case Instruction::VAArg:
-    // Zero-cost C++ exception handling is not supported yet.
-    case Instruction::Invoke:
-    case Instruction::LandingPad:
-    case Instruction::Resume:
     // indirectbr may interfere with streaming
     case Instruction::IndirectBr:
     // TODO(jfb) Figure out ShuffleVector.
     case Instruction::ShuffleVector:
-    // ExtractValue and InsertValue operate on struct values.
-    case Instruction::ExtractValue:
-    case Instruction::InsertValue:
     // Atomics should become NaCl intrinsics.
     case Instruction::AtomicCmpXchg:
     case Instruction::AtomicRMW:
@@ -473,6 +540,62 @@ const char *PNaClABIVerifyFunctions::checkInstruction(const DataLayout *DL,
       break;
     }
 
+    // Zero-cost C++ exception handling is not part of the stable ABI.
+    // It is only allowed for bitcode that is translated by the same
+    // toolchain that produced it.
+    case Instruction::Invoke: {
+      if (!PNaClABIAllowZeroCostEH)
+        return "bad instruction opcode";
+      const InvokeInst *Invoke = cast<InvokeInst>(Inst);
+      if (!Invoke->getAttributes().isEmpty())
+        return "bad call attributes";
+      if (const char *Error = verifyCallingConv(Invoke->getCallingConv()))
+        return Error;
+      // The callee precedes the normal and unwind destinations.
+      PtrOperandIndex = Inst->getNumOperands() - 3;
+      if (!isNormalizedPtr(Inst->getOperand(PtrOperandIndex)))
+        return "bad function callee operand";
+      break;
+    }
+    case Instruction::LandingPad: {
+      if (!PNaClABIAllowZeroCostEH)
+        return "bad instruction opcode";
+      const LandingPadInst *LP = cast<LandingPadInst>(Inst);
+      if (!isLandingPadType(LP->getType()))
+        return "bad landingpad type";
+      if (!isa<Function>(LP->getPersonalityFn()->stripPointerCasts()))
+        return "bad personality function";
+      for (unsigned I = 0, E = LP->getNumClauses(); I != E; ++I)
+        if (!isValidLandingPadClause(cast<Constant>(LP->getClause(I))))
+          return "bad landingpad clause";
+      // Allow the instruction and skip the later checks.
+      return NULL;
+    }
+    case Instruction::Resume:
+      if (!PNaClABIAllowZeroCostEH ||
+          !isLandingPadType(Inst->getOperand(0)->getType()) ||
+          !isa<Instruction>(Inst->getOperand(0)))
+        return "bad instruction opcode";
+      return NULL;
+
+    // ExtractValue and InsertValue operate on struct values, which are
+    // only left for the results of landing pads.
+    case Instruction::ExtractValue:
+      if (!PNaClABIAllowZeroCostEH ||
+          !isa<LandingPadInst>(Inst->getOperand(0)))
+        return "bad instruction opcode";
+      return NULL;
+    case Instruction::InsertValue: {
+      const Value *Agg = Inst->getOperand(0);
+      const Value *Field = Inst->getOperand(1);
+      if (!PNaClABIAllowZeroCostEH || !isLandingPadType(Inst->getType()) ||
+          !(isa<UndefValue>(Agg) || isa<InsertValueInst>(Agg)))
+        return "bad instruction opcode";
+      if (!(isValidScalarOperand(Field) || isNormalizedPtr(Field)))
+        return "bad operand";
+      return NULL;
+    }
+
     case Instruction::Switch: {
       // SwitchInst represents switch cases using array and vector
       // constants, which we normally reject, so we must check
@@ -545,7 +668,9 @@ bool PNaClABIVerifyFunctions::runOnFunction(Function &F) {
       if (!Error && !(PNaClABITypeChecker::isValidScalarType(Inst->getType()) ||
                       PNaClABITypeChecker::isValidVectorType(Inst->getType()) ||
                       isNormalizedPtr(Inst) ||
-                      isa<AllocaInst>(Inst))) {
+                      isa<AllocaInst>(Inst) ||
+                      (PNaClABIAllowZeroCostEH &&
+                       isLandingPadType(Inst->getType())))) {
         Error = "bad result type";
         BadResult = true;
       }
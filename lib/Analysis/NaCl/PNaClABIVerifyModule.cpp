@@ -31,6 +31,12 @@ PNaClABIAllowDebugMetadata("pnaclabi-allow-debug-metadata",
   cl::desc("Allow debug metadata during PNaCl ABI verification."),
   cl::init(false));
 
+cl::opt<bool>
+PNaClABIAllowZeroCostEH("pnaclabi-allow-zero-cost-eh",
+  cl::desc("Allow the invoke, landingpad and resume instructions left by "
+           "-enable-pnacl-zero-cost-eh during PNaCl ABI verification."),
+  cl::init(false));
+
 }
 
 // TODO(mseaborn): This option no longer has any effect, so remove it
@@ -183,10 +189,11 @@ PNaClAllowedIntrinsics(LLVMContext *Context) : Context(Context) {
 }
 
 bool PNaClAllowedIntrinsics::isAllowed(const Function *Func) {
-  // Keep 3 categories of intrinsics for now.
+  // Keep 4 categories of intrinsics for now.
   // (1) Allowed always, provided the exact name and type match.
   // (2) Never allowed.
   // (3) Debug info intrinsics.
+  // (4) Zero-cost exception handling intrinsics.
   //
   // Please keep these sorted or grouped in a sensible way, within
   // each category.
@@ -213,7 +220,6 @@ bool PNaClAllowedIntrinsics::isAllowed(const Function *Func) {
     case Intrinsic::eh_sjlj_longjmp:
     case Intrinsic::eh_sjlj_lsda:
     case Intrinsic::eh_sjlj_setjmp:
-    case Intrinsic::eh_typeid_for:
     case Intrinsic::eh_unwind_init:
     // We do not want to expose addresses to the user.
     case Intrinsic::frameaddress:
@@ -267,6 +273,10 @@ bool PNaClAllowedIntrinsics::isAllowed(const Function *Func) {
     case Intrinsic::dbg_declare:
     case Intrinsic::dbg_value:
       return PNaClABIAllowDebugMetadata;
+
+    // (4) Exception handling intrinsics used by landing pads.
+    case Intrinsic::eh_typeid_for:
+      return PNaClABIAllowZeroCostEH;
   }
 }
 
@@ -27,6 +27,7 @@
 #include "llvm/Support/DataStream.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Trace.h"
 #include "llvm/Support/raw_ostream.h"
 using namespace llvm;
 
@@ -45,6 +46,7 @@ void NaClBitcodeReader::FreeState() {
 
   std::vector<Function*>().swap(FunctionsWithBodies);
   DeferredFunctionInfo.clear();
+  FunctionBodyIndex.clear();
 }
 
 //===----------------------------------------------------------------------===//
@@ -318,6 +320,8 @@ bool NaClBitcodeReader::ParseGlobalVars() {
   bool VarIsConstant = false;
   // The initializer for the global variable.
   SmallVector<Constant *, 10> VarInit;
+  // The types of the initializers for the global variable.
+  SmallVector<Type *, 10> VarInitTypes;
   // The number of initializers needed for the global variable.
   unsigned VarInitializersNeeded = 0;
   unsigned FirstValueNo = ValueList.size();
@@ -361,7 +365,7 @@ bool NaClBitcodeReader::ParseGlobalVars() {
       // Global variable has multiple initializers. Changes the
       // default number of initializers to the given value in
       // Record[0].
-      if (!ProcessingGlobal || !VarInit.empty() ||
+      if (!ProcessingGlobal || !VarInitTypes.empty() ||
           VarInitializersNeeded != 1 || Record.size() != 1)
         return Error("Bad GLOBALVAR_COMPOUND record");
       VarInitializersNeeded = Record[0];
@@ -371,8 +375,9 @@ bool NaClBitcodeReader::ParseGlobalVars() {
       if (!ProcessingGlobal || Record.size() != 1)
         return Error("Bad GLOBALVAR_ZEROFILL record");
       Type *Ty = ArrayType::get(Type::getInt8Ty(Context), Record[0]);
-      Constant *Zero = ConstantAggregateZero::get(Ty);
-      VarInit.push_back(Zero);
+      VarInitTypes.push_back(Ty);
+      if (!GlobalsAsDeclarations)
+        VarInit.push_back(ConstantAggregateZero::get(Ty));
       break;
     }
     case naclbitc::GLOBALVAR_DATA: {
@@ -380,6 +385,11 @@ bool NaClBitcodeReader::ParseGlobalVars() {
       if (!ProcessingGlobal || Record.size() < 1)
         return Error("Bad GLOBALVAR_DATA record");
       unsigned Size = Record.size();
+      if (GlobalsAsDeclarations) {
+        VarInitTypes.push_back(
+            ArrayType::get(Type::getInt8Ty(Context), Size));
+        break;
+      }
       uint8_t *Buf = new uint8_t[Size];
       assert(Buf);
       for (unsigned i = 0; i < Size; ++i)
@@ -387,6 +397,7 @@ bool NaClBitcodeReader::ParseGlobalVars() {
       Constant *Init = ConstantDataArray::get(
           Context, ArrayRef<uint8_t>(Buf, Buf + Size));
       VarInit.push_back(Init);
+      VarInitTypes.push_back(Init->getType());
       delete[] Buf;
       break;
     }
@@ -394,6 +405,10 @@ bool NaClBitcodeReader::ParseGlobalVars() {
       // Define a relocation initializer.
       if (!ProcessingGlobal || Record.size() < 1 || Record.size() > 2)
         return Error("Bad GLOBALVAR_RELOC record");
+      if (GlobalsAsDeclarations) {
+        VarInitTypes.push_back(IntegerType::get(Context, 32));
+        break;
+      }
       Constant *BaseVal =
           ValueList.getOrCreateGlobalVarRef(Record[0], TheModule);
       if (BaseVal == 0)
@@ -406,6 +421,7 @@ bool NaClBitcodeReader::ParseGlobalVars() {
                                                          Addend));
       }
       VarInit.push_back(Val);
+      VarInitTypes.push_back(IntPtrType);
       break;
     }
     case naclbitc::GLOBALVAR_COUNT:
@@ -416,23 +432,42 @@ bool NaClBitcodeReader::ParseGlobalVars() {
     }
 
     // If more initializers needed for global variable, continue processing.
-    if (!ProcessingGlobal || VarInit.size() < VarInitializersNeeded)
+    if (!ProcessingGlobal || VarInitTypes.size() < VarInitializersNeeded)
       continue;
 
-    Constant *Init = 0;
-    switch (VarInit.size()) {
-    case 0:
-      return Error("No initializer for global variable in global vars block");
-    case 1:
-      Init = VarInit[0];
-      break;
-    default:
-      Init = ConstantStruct::getAnon(Context, VarInit, true);
-      break;
+    GlobalVariable *GV = 0;
+    if (GlobalsAsDeclarations) {
+      // Only the type of the initializer is needed for a declaration.
+      Type *Ty = 0;
+      switch (VarInitTypes.size()) {
+      case 0:
+        return Error(
+            "No initializer for global variable in global vars block");
+      case 1:
+        Ty = VarInitTypes[0];
+        break;
+      default:
+        Ty = StructType::get(Context, VarInitTypes, true);
+        break;
+      }
+      GV = new GlobalVariable(*TheModule, Ty, VarIsConstant,
+                              GlobalValue::ExternalLinkage, 0, "");
+    } else {
+      Constant *Init = 0;
+      switch (VarInit.size()) {
+      case 0:
+        return Error(
+            "No initializer for global variable in global vars block");
+      case 1:
+        Init = VarInit[0];
+        break;
+      default:
+        Init = ConstantStruct::getAnon(Context, VarInit, true);
+        break;
+      }
+      GV = new GlobalVariable(*TheModule, Init->getType(), VarIsConstant,
+                              GlobalValue::InternalLinkage, Init, "");
     }
-    GlobalVariable *GV = new GlobalVariable(
-        *TheModule, Init->getType(), VarIsConstant,
-        GlobalValue::InternalLinkage, Init, "");
     GV->setAlignment(VarAlignment);
     ValueList.AssignGlobalVar(GV, NextValueNo);
     ++NextValueNo;
@@ -441,6 +476,7 @@ bool NaClBitcodeReader::ParseGlobalVars() {
     VarIsConstant = false;
     VarInitializersNeeded = 0;
     VarInit.clear();
+    VarInitTypes.clear();
   }
 }
 
@@ -589,6 +625,9 @@ bool NaClBitcodeReader::RememberAndSkipFunctionBody() {
   // Save the current stream state.
   uint64_t CurBit = Stream.GetCurrentBitNo();
   DeferredFunctionInfo[Fn] = CurBit;
+  if (SharedInfo)
+    SharedInfo->setFunctionBodyBit(NumFunctionBodiesSeen, CurBit);
+  ++NumFunctionBodiesSeen;
 
   // Skip over the function block for now.
   if (Stream.SkipBlock())
@@ -673,6 +712,7 @@ void NaClBitcodeReader::AddPointerTypesToIntrinsicParams() {
 
 bool NaClBitcodeReader::ParseModule(bool Resume) {
   DEBUG(dbgs() << "-> ParseModule\n");
+  TraceScope Trace("bitcode", "ParseModule");
   if (Resume)
     Stream.JumpToBit(NextUnreadBit);
   else if (Stream.EnterSubBlock(naclbitc::MODULE_BLOCK_ID))
@@ -799,6 +839,8 @@ bool NaClBitcodeReader::ParseModule(bool Resume) {
       // If this is a function with a body, remember the prototype we are
       // creating now, so that we can match up the body with them later.
       if (!isProto) {
+        if (SharedInfo)
+          FunctionBodyIndex[Func] = FunctionsWithBodies.size();
         FunctionsWithBodies.push_back(Func);
         if (LazyStreamer) DeferredFunctionInfo[Func] = 0;
       }
@@ -935,6 +977,7 @@ Value *NaClBitcodeReader::ConvertOpToType(Value *Op, Type *T,
 /// ParseFunctionBody - Lazily parse the specified function body block.
 bool NaClBitcodeReader::ParseFunctionBody(Function *F) {
   DEBUG(dbgs() << "-> ParseFunctionBody\n");
+  TraceScope Trace("bitcode", F->getName());
   if (Stream.EnterSubBlock(naclbitc::FUNCTION_BLOCK_ID))
     return Error("Malformed block record");
 
@@ -1487,7 +1530,9 @@ error_code NaClBitcodeReader::Materialize(GlobalValue *GV) {
   DenseMap<Function*, uint64_t>::iterator DFII = DeferredFunctionInfo.find(F);
   assert(DFII != DeferredFunctionInfo.end() && "Deferred function not found!");
   // If its position is recorded as 0, its body is somewhere in the stream
-  // but we haven't seen it yet.
+  // but we haven't seen it yet. Another reader of the same stream may have.
+  if (DFII->second == 0 && SharedInfo)
+    DFII->second = SharedInfo->getFunctionBodyBit(FunctionBodyIndex[F]);
   if (DFII->second == 0) {
     if (FindFunctionInStream(F, DFII)) {
       // Refactoring upstream in LLVM 3.4 means we can no longer
@@ -1651,10 +1696,14 @@ Module *llvm::getNaClStreamedBitcodeModule(const std::string &name,
                                            StreamingMemoryObject *Streamer,
                                            LLVMContext &Context,
                                            std::string *ErrMsg,
-                                           bool AcceptSupportedOnly) {
+                                           bool AcceptSupportedOnly,
+                                           NaClStreamSharedInfo *SharedInfo,
+                                           bool GlobalsAsDeclarations) {
   Module *M = new Module(name, Context);
   NaClBitcodeReader *R =
       new NaClBitcodeReader(Streamer, Context, AcceptSupportedOnly);
+  R->setSharedInfo(SharedInfo);
+  R->setGlobalsAsDeclarations(GlobalsAsDeclarations);
   M->setMaterializer(R);
   if (R->ParseBitcodeInto(M)) {
     if (ErrMsg)
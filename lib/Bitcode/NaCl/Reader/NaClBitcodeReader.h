@@ -19,6 +19,7 @@
 #include "llvm/Bitcode/NaCl/NaClBitcodeHeader.h"
 #include "llvm/Bitcode/NaCl/NaClBitstreamReader.h"
 #include "llvm/Bitcode/NaCl/NaClLLVMBitCodes.h"
+#include "llvm/Bitcode/NaCl/NaClReaderWriter.h"
 #include "llvm/GVMaterializer.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Instruction.h"
@@ -188,6 +189,21 @@ class NaClBitcodeReader : public GVMaterializer {
   /// stream.
   DenseMap<Function*, uint64_t> DeferredFunctionInfo;
 
+  /// \brief Function body offsets shared with other readers of the same
+  /// stream, or null.
+  NaClStreamSharedInfo *SharedInfo;
+
+  /// \brief Maps each function with a body to its position among the
+  /// functions with bodies. Only used when SharedInfo is set.
+  DenseMap<Function*, unsigned> FunctionBodyIndex;
+
+  /// \brief The number of function bodies skipped so far.
+  unsigned NumFunctionBodiesSeen;
+
+  /// \brief True if global variables should be created as declarations,
+  /// without building their initializers.
+  bool GlobalsAsDeclarations;
+
   /// \brief True if we should only accept supported bitcode format.
   bool AcceptSupportedBitcodeOnly;
 
@@ -201,6 +217,7 @@ public:
       LazyStreamer(0), NextUnreadBit(0), SeenValueSymbolTable(false),
       ValueList(C),
       SeenFirstFunctionBody(false),
+      SharedInfo(0), NumFunctionBodiesSeen(0), GlobalsAsDeclarations(false),
       AcceptSupportedBitcodeOnly(AcceptSupportedOnly),
       IntPtrType(IntegerType::get(C, PNaClIntPtrTypeBitSize)) {
   }
@@ -211,6 +228,7 @@ public:
       LazyStreamer(streamer), NextUnreadBit(0), SeenValueSymbolTable(false),
       ValueList(C),
       SeenFirstFunctionBody(false),
+      SharedInfo(0), NumFunctionBodiesSeen(0), GlobalsAsDeclarations(false),
       AcceptSupportedBitcodeOnly(AcceptSupportedOnly),
       IntPtrType(IntegerType::get(C, PNaClIntPtrTypeBitSize)) {
   }
@@ -224,6 +242,14 @@ public:
   /// when the reader is destroyed.
   void setBufferOwned(bool Owned) { BufferOwned = Owned; }
 
+  /// setSharedInfo - Share function body offsets with the other readers of
+  /// the same stream through Info.  Must be called before parsing.
+  void setSharedInfo(NaClStreamSharedInfo *Info) { SharedInfo = Info; }
+
+  /// setGlobalsAsDeclarations - If true, global variables are read as
+  /// external declarations without initializers.
+  void setGlobalsAsDeclarations(bool Value) { GlobalsAsDeclarations = Value; }
+
   virtual bool isMaterializable(const GlobalValue *GV) const;
   virtual bool isDematerializable(const GlobalValue *GV) const;
   virtual error_code Materialize(GlobalValue *GV);
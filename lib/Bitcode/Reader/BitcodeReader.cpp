@@ -24,6 +24,7 @@
 #include "llvm/Support/DataStream.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Trace.h" // @LOCALMOD
 #include "llvm/Support/raw_ostream.h"
 using namespace llvm;
 
@@ -1638,6 +1639,7 @@ error_code BitcodeReader::GlobalCleanup() {
 }
 
 error_code BitcodeReader::ParseModule(bool Resume) {
+  TraceScope Trace("bitcode", "ParseModule"); // @LOCALMOD
   if (Resume)
     Stream.JumpToBit(NextUnreadBit);
   else if (Stream.EnterSubBlock(bitc::MODULE_BLOCK_ID))
@@ -2124,6 +2126,7 @@ error_code BitcodeReader::ParseMetadataAttachment() {
 
 /// ParseFunctionBody - Lazily parse the specified function body block.
 error_code BitcodeReader::ParseFunctionBody(Function *F) {
+  TraceScope Trace("bitcode", F->getName()); // @LOCALMOD
   if (Stream.EnterSubBlock(bitc::FUNCTION_BLOCK_ID))
     return Error(InvalidRecord);
 
@@ -83,6 +83,9 @@ INITIALIZE_PASS(BranchFolderPass, "branch-folder",
                 "Control Flow Optimizer", false, false)
 
 bool BranchFolderPass::runOnMachineFunction(MachineFunction &MF) {
+  if (skipOptnoneFunction(*MF.getFunction())) // @LOCALMOD
+    return false;
+
   TargetPassConfig *PassConfig = &getAnalysis<TargetPassConfig>();
   BranchFolder Folder(PassConfig->getEnableTailMerge(), /*CommonHoist=*/true);
   return Folder.OptimizeFunction(MF,
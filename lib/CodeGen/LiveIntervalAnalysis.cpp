@@ -84,19 +84,33 @@ LiveIntervals::LiveIntervals() : MachineFunctionPass(ID),
 
 LiveIntervals::~LiveIntervals() {
   delete LRCalc;
+  // @LOCALMOD-BEGIN
+  DeleteContainerPointers(FreeIntervals);
+  DeleteContainerPointers(FreeRegUnitRanges);
+  DeleteContainerPointers(RemovedIntervals);
+  // @LOCALMOD-END
 }
 
 void LiveIntervals::releaseMemory() {
-  // Free the live intervals themselves.
+  // @LOCALMOD-BEGIN
+  // Keep the live intervals themselves for the next function.
   for (unsigned i = 0, e = VirtRegIntervals.size(); i != e; ++i)
-    delete VirtRegIntervals[TargetRegisterInfo::index2VirtReg(i)];
+    recycleInterval(VirtRegIntervals[TargetRegisterInfo::index2VirtReg(i)]);
+  FreeIntervals.append(RemovedIntervals.begin(), RemovedIntervals.end());
+  RemovedIntervals.clear();
+  // @LOCALMOD-END
   VirtRegIntervals.clear();
   RegMaskSlots.clear();
   RegMaskBits.clear();
   RegMaskBlocks.clear();
 
+  // @LOCALMOD-BEGIN
   for (unsigned i = 0, e = RegUnitRanges.size(); i != e; ++i)
-    delete RegUnitRanges[i];
+    if (LiveRange *LR = RegUnitRanges[i]) {
+      LR->clear();
+      FreeRegUnitRanges.push_back(LR);
+    }
+  // @LOCALMOD-END
   RegUnitRanges.clear();
 
   // Release VNInfo memory regions, VNInfo objects don't need to be dtor'd.
@@ -172,9 +186,35 @@ void LiveIntervals::dumpInstrs() const {
 LiveInterval* LiveIntervals::createInterval(unsigned reg) {
   float Weight = TargetRegisterInfo::isPhysicalRegister(reg) ?
                   llvm::huge_valf : 0.0F;
+  // @LOCALMOD-BEGIN
+  if (!FreeIntervals.empty()) {
+    LiveInterval *LI = FreeIntervals.pop_back_val();
+    LI->reg = reg;
+    LI->weight = Weight;
+    return LI;
+  }
+  // @LOCALMOD-END
   return new LiveInterval(reg, Weight);
 }
 
+// @LOCALMOD-BEGIN
+/// createRegUnitRange - Return an empty live range for a register unit,
+/// reusing one from a previous function if possible.
+LiveRange *LiveIntervals::createRegUnitRange() {
+  if (!FreeRegUnitRanges.empty())
+    return FreeRegUnitRanges.pop_back_val();
+  return new LiveRange();
+}
+
+/// recycleInterval - Clear LI and keep it around for createInterval.
+void LiveIntervals::recycleInterval(LiveInterval *LI) {
+  if (!LI)
+    return;
+  LI->clear();
+  FreeIntervals.push_back(LI);
+}
+// @LOCALMOD-END
+
 
 /// computeVirtRegInterval - Compute the live interval of a virtual register,
 /// based on defs and uses.
@@ -290,7 +330,7 @@ void LiveIntervals::computeLiveInRegUnits() {
         unsigned Unit = *Units;
         LiveRange *LR = RegUnitRanges[Unit];
         if (!LR) {
-          LR = RegUnitRanges[Unit] = new LiveRange();
+          LR = RegUnitRanges[Unit] = createRegUnitRange(); // @LOCALMOD
           NewRanges.push_back(Unit);
         }
         VNInfo *VNI = LR->createDeadDef(Begin, getVNInfoAllocator());
@@ -1102,6 +1102,9 @@ void MachineBlockPlacement::buildCFGChains(MachineFunction &F) {
 }
 
 bool MachineBlockPlacement::runOnMachineFunction(MachineFunction &F) {
+  if (skipOptnoneFunction(*F.getFunction())) // @LOCALMOD
+    return false;
+
   // Check for single-block functions and skip them.
   if (llvm::next(F.begin()) == F.end())
     return false;
@@ -320,6 +320,9 @@ bool MachineCopyPropagation::CopyPropagateBlock(MachineBasicBlock &MBB) {
 }
 
 bool MachineCopyPropagation::runOnMachineFunction(MachineFunction &MF) {
+  if (skipOptnoneFunction(*MF.getFunction())) // @LOCALMOD
+    return false;
+
   bool Changed = false;
 
   TRI = MF.getTarget().getRegisterInfo();
@@ -17,6 +17,7 @@
 #include "llvm/CodeGen/MachineScheduler.h"
 #include "llvm/ADT/OwningPtr.h"
 #include "llvm/ADT/PriorityQueue.h"
+#include "llvm/ADT/Statistic.h" // @LOCALMOD
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/CodeGen/LiveIntervalAnalysis.h"
 #include "llvm/CodeGen/MachineDominators.h"
@@ -66,6 +67,20 @@ static cl::opt<bool> EnableLoadCluster("misched-cluster", cl::Hidden,
 static cl::opt<bool> EnableMacroFusion("misched-fusion", cl::Hidden,
   cl::desc("Enable scheduling for macro fusion."), cl::init(true));
 
+// @LOCALMOD-BEGIN
+// Scheduling a region costs more than linear time in its size. Huge blocks
+// are cut into windows of this many instructions which are scheduled
+// independently; the instruction between two windows stays in place.
+// pnacl-llc sets the window; other tools schedule whole blocks unless asked.
+cl::opt<unsigned> llvm::MISchedWindow("misched-window", cl::Hidden,
+  cl::init(0),
+  cl::desc("Maximum number of instructions in a scheduling region "
+           "(0 = unlimited)"));
+
+STATISTIC(NumWindowedRegions,
+          "Number of scheduling regions cut short by -misched-window");
+// @LOCALMOD-END
+
 static cl::opt<bool> VerifyScheduling("verify-misched", cl::Hidden,
   cl::desc("Verify machine instrs before and after machine scheduling"));
 
@@ -242,6 +257,9 @@ ScheduleDAGInstrs *MachineScheduler::createMachineScheduler() {
 /// design would be to split blocks at scheduling boundaries, but LLVM has a
 /// general bias against block splitting purely for implementation simplicity.
 bool MachineScheduler::runOnMachineFunction(MachineFunction &mf) {
+  if (skipOptnoneFunction(*mf.getFunction())) // @LOCALMOD
+    return false;
+
   DEBUG(dbgs() << "Before MISsched:\n"; mf.print(dbgs()));
 
   // Initialize the context of the pass.
@@ -302,6 +320,12 @@ bool MachineScheduler::runOnMachineFunction(MachineFunction &mf) {
       for(;I != MBB->begin(); --I, --RemainingInstrs, ++NumRegionInstrs) {
         if (TII->isSchedulingBoundary(llvm::prior(I), MBB, *MF))
           break;
+        // @LOCALMOD-BEGIN
+        if (MISchedWindow && NumRegionInstrs == MISchedWindow) {
+          ++NumWindowedRegions;
+          break;
+        }
+        // @LOCALMOD-END
       }
       // Notify the scheduler of the region, even if we may skip scheduling
       // it. Perhaps it still needs to be bundled.
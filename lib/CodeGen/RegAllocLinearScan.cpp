@@ -0,0 +1,341 @@
+//===-- RegAllocLinearScan.cpp - Linear Scan Register Allocator -----------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the RALinearScan function pass, a register allocator tuned
+// for translation latency rather than code quality.
+//
+// Live virtual registers are visited in order of their start point, as in a
+// classic linear scan. Interference is checked with the same LiveRegMatrix
+// used by the basic and greedy allocators, so lifetime holes are honoured
+// without maintaining separate active and inactive lists. There is no region
+// splitting and no eviction cascade: when no register is free, the register
+// whose interfering live ranges are cheapest to spill is taken over, and the
+// evicted ranges are either moved to another free register straight away or
+// spilled. Otherwise the current range is spilled. Spilling goes through the
+// inline spiller, which splits the spilled range around its uses.
+//
+//===----------------------------------------------------------------------===//
+
+#define DEBUG_TYPE "regalloc"
+#include "llvm/CodeGen/Passes.h"
+#include "AllocationOrder.h"
+#include "LiveDebugVariables.h"
+#include "RegAllocBase.h"
+#include "Spiller.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/CodeGen/CalcSpillWeights.h"
+#include "llvm/CodeGen/LiveIntervalAnalysis.h"
+#include "llvm/CodeGen/LiveRangeEdit.h"
+#include "llvm/CodeGen/LiveRegMatrix.h"
+#include "llvm/CodeGen/LiveStackAnalysis.h"
+#include "llvm/CodeGen/MachineBlockFrequencyInfo.h"
+#include "llvm/CodeGen/MachineFunctionPass.h"
+#include "llvm/CodeGen/MachineLoopInfo.h"
+#include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/RegAllocRegistry.h"
+#include "llvm/CodeGen/VirtRegMap.h"
+#include "llvm/PassAnalysisSupport.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetRegisterInfo.h"
+#include <algorithm>
+#include <queue>
+
+using namespace llvm;
+
+STATISTIC(NumEvicted,    "Number of interfering live ranges evicted");
+STATISTIC(NumReassigned, "Number of evicted live ranges given a free register");
+
+static RegisterRegAlloc linearScanRegAlloc("linearscan",
+                                           "linear scan register allocator",
+                                           createLinearScanRegisterAllocator);
+
+namespace {
+  /// QueueEntry - A live range waiting for allocation, along with the number
+  /// of registers its register class can be allocated to.
+  struct QueueEntry {
+    LiveInterval *LI;
+    unsigned NumRegs;
+    QueueEntry(LiveInterval *LI, unsigned NumRegs) : LI(LI), NumRegs(NumRegs) {}
+  };
+
+  /// CompStart - Order live ranges by start point, earliest first. Ranges
+  /// starting at the same slot are ordered by how constrained their register
+  /// class is, then by decreasing spill weight.
+  struct CompStart {
+    bool operator()(const QueueEntry &QA, const QueueEntry &QB) const {
+      LiveInterval *A = QA.LI, *B = QB.LI;
+      // Empty ranges never interfere; get them out of the way first.
+      if (A->empty() || B->empty()) {
+        if (A->empty() != B->empty())
+          return B->empty();
+        return A->reg > B->reg;
+      }
+      // Unspillable ranges (inline asm operands, the spiller's reloads) can't
+      // give way to anything, so they get first pick of the registers.
+      if (A->isSpillable() != B->isSpillable())
+        return A->isSpillable();
+      if (A->beginIndex() != B->beginIndex())
+        return B->beginIndex() < A->beginIndex();
+      if (QA.NumRegs != QB.NumRegs)
+        return QA.NumRegs > QB.NumRegs;
+      if (A->weight != B->weight)
+        return A->weight < B->weight;
+      return A->reg > B->reg;
+    }
+  };
+}
+
+namespace {
+/// RALinearScan assigns live virtual registers in linear scan order, evicting
+/// or spilling by spill weight when it runs out of registers.
+class RALinearScan : public MachineFunctionPass, public RegAllocBase
+{
+  // context
+  MachineFunction *MF;
+
+  // state
+  OwningPtr<Spiller> SpillerInstance;
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, CompStart> Queue;
+
+public:
+  RALinearScan();
+
+  /// Return the pass name.
+  virtual const char* getPassName() const {
+    return "Linear Scan Register Allocator";
+  }
+
+  /// RALinearScan analysis usage.
+  virtual void getAnalysisUsage(AnalysisUsage &AU) const;
+
+  virtual void releaseMemory();
+
+  virtual Spiller &spiller() { return *SpillerInstance; }
+
+  virtual void enqueue(LiveInterval *LI) {
+    const TargetRegisterClass *RC = MRI->getRegClass(LI->reg);
+    Queue.push(QueueEntry(LI, RegClassInfo.getNumAllocatableRegs(RC)));
+  }
+
+  virtual LiveInterval *dequeue() {
+    if (Queue.empty())
+      return 0;
+    LiveInterval *LI = Queue.top().LI;
+    Queue.pop();
+    return LI;
+  }
+
+  virtual unsigned selectOrSplit(LiveInterval &VirtReg,
+                                 SmallVectorImpl<unsigned> &SplitVRegs);
+
+  /// Perform register allocation.
+  virtual bool runOnMachineFunction(MachineFunction &mf);
+
+  static char ID;
+
+private:
+  bool getEvictionWeight(LiveInterval &VirtReg, unsigned PhysReg,
+                         float &MaxWeight);
+  void evictInterferences(LiveInterval &VirtReg, unsigned PhysReg,
+                          SmallVectorImpl<unsigned> &SplitVRegs);
+  unsigned findFreeReg(LiveInterval &VirtReg, unsigned AvoidReg);
+};
+
+char RALinearScan::ID = 0;
+
+} // end anonymous namespace
+
+RALinearScan::RALinearScan(): MachineFunctionPass(ID) {
+  initializeLiveDebugVariablesPass(*PassRegistry::getPassRegistry());
+  initializeLiveIntervalsPass(*PassRegistry::getPassRegistry());
+  initializeSlotIndexesPass(*PassRegistry::getPassRegistry());
+  initializeRegisterCoalescerPass(*PassRegistry::getPassRegistry());
+  initializeMachineSchedulerPass(*PassRegistry::getPassRegistry());
+  initializeLiveStacksPass(*PassRegistry::getPassRegistry());
+  initializeMachineDominatorTreePass(*PassRegistry::getPassRegistry());
+  initializeMachineLoopInfoPass(*PassRegistry::getPassRegistry());
+  initializeVirtRegMapPass(*PassRegistry::getPassRegistry());
+  initializeLiveRegMatrixPass(*PassRegistry::getPassRegistry());
+}
+
+void RALinearScan::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.setPreservesCFG();
+  AU.addRequired<AliasAnalysis>();
+  AU.addPreserved<AliasAnalysis>();
+  AU.addRequired<LiveIntervals>();
+  AU.addPreserved<LiveIntervals>();
+  AU.addPreserved<SlotIndexes>();
+  AU.addRequired<LiveDebugVariables>();
+  AU.addPreserved<LiveDebugVariables>();
+  AU.addRequired<LiveStacks>();
+  AU.addPreserved<LiveStacks>();
+  AU.addRequired<MachineBlockFrequencyInfo>();
+  AU.addPreserved<MachineBlockFrequencyInfo>();
+  AU.addRequiredID(MachineDominatorsID);
+  AU.addPreservedID(MachineDominatorsID);
+  AU.addRequired<MachineLoopInfo>();
+  AU.addPreserved<MachineLoopInfo>();
+  AU.addRequired<VirtRegMap>();
+  AU.addPreserved<VirtRegMap>();
+  AU.addRequired<LiveRegMatrix>();
+  AU.addPreserved<LiveRegMatrix>();
+  MachineFunctionPass::getAnalysisUsage(AU);
+}
+
+void RALinearScan::releaseMemory() {
+  SpillerInstance.reset(0);
+}
+
+/// getEvictionWeight - Compute the largest spill weight among the live
+/// virtual registers assigned to PhysReg or an alias that interfere with
+/// VirtReg. Return false if any of them can't be evicted at all.
+bool RALinearScan::getEvictionWeight(LiveInterval &VirtReg, unsigned PhysReg,
+                                     float &MaxWeight) {
+  MaxWeight = 0;
+  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units) {
+    LiveIntervalUnion::Query &Q = Matrix->query(VirtReg, *Units);
+    Q.collectInterferingVRegs();
+    if (Q.seenUnspillableVReg())
+      return false;
+    for (unsigned i = Q.interferingVRegs().size(); i; --i) {
+      LiveInterval *Intf = Q.interferingVRegs()[i - 1];
+      if (!Intf->isSpillable())
+        return false;
+      MaxWeight = std::max(MaxWeight, Intf->weight);
+    }
+  }
+  return true;
+}
+
+/// findFreeReg - Return a register without any interference with VirtReg
+/// that doesn't overlap AvoidReg, or 0.
+unsigned RALinearScan::findFreeReg(LiveInterval &VirtReg, unsigned AvoidReg) {
+  AllocationOrder Order(VirtReg.reg, *VRM, RegClassInfo);
+  while (unsigned PhysReg = Order.next())
+    if (!TRI->regsOverlap(PhysReg, AvoidReg) &&
+        Matrix->checkInterference(VirtReg, PhysReg) == LiveRegMatrix::IK_Free)
+      return PhysReg;
+  return 0;
+}
+
+/// evictInterferences - Take PhysReg away from everything that interferes
+/// with VirtReg. Each evicted live range moves to another free register if
+/// one is available, and is spilled otherwise; the spiller's new live ranges
+/// are appended to SplitVRegs.
+void RALinearScan::evictInterferences(LiveInterval &VirtReg, unsigned PhysReg,
+                                      SmallVectorImpl<unsigned> &SplitVRegs) {
+  SmallVector<LiveInterval*, 8> Intfs;
+  for (MCRegUnitIterator Units(PhysReg, TRI); Units.isValid(); ++Units) {
+    LiveIntervalUnion::Query &Q = Matrix->query(VirtReg, *Units);
+    Q.collectInterferingVRegs();
+    for (unsigned i = Q.interferingVRegs().size(); i; --i) {
+      LiveInterval *Intf = Q.interferingVRegs()[i - 1];
+      // Skip duplicates.
+      if (!VRM->hasPhys(Intf->reg))
+        continue;
+      Matrix->unassign(*Intf);
+      Intfs.push_back(Intf);
+      ++NumEvicted;
+    }
+  }
+  assert(!Intfs.empty() && "expected interference");
+
+  for (unsigned i = 0, e = Intfs.size(); i != e; ++i) {
+    LiveInterval &Intf = *Intfs[i];
+    if (unsigned NewReg = findFreeReg(Intf, PhysReg)) {
+      DEBUG(dbgs() << "moving " << Intf << " to " << PrintReg(NewReg, TRI)
+                   << '\n');
+      Matrix->assign(Intf, NewReg);
+      ++NumReassigned;
+      continue;
+    }
+    DEBUG(dbgs() << "spilling evicted " << Intf << '\n');
+    LiveRangeEdit LRE(&Intf, SplitVRegs, *MF, *LIS, VRM);
+    spiller().spill(LRE);
+  }
+}
+
+// Pick the first free register in allocation order, which starts with the
+// register hints. If there is none, take over the register whose interfering
+// live ranges have the smallest maximum spill weight, provided that is lower
+// than VirtReg's own weight, and spill VirtReg otherwise.
+unsigned RALinearScan::selectOrSplit(LiveInterval &VirtReg,
+                                     SmallVectorImpl<unsigned> &SplitVRegs) {
+  unsigned BestPhysReg = 0;
+  float BestWeight = VirtReg.weight;
+
+  AllocationOrder Order(VirtReg.reg, *VRM, RegClassInfo);
+  while (unsigned PhysReg = Order.next()) {
+    switch (Matrix->checkInterference(VirtReg, PhysReg)) {
+    case LiveRegMatrix::IK_Free:
+      return PhysReg;
+
+    case LiveRegMatrix::IK_VirtReg: {
+      float Weight;
+      if (getEvictionWeight(VirtReg, PhysReg, Weight) && Weight < BestWeight) {
+        BestPhysReg = PhysReg;
+        BestWeight = Weight;
+      }
+      continue;
+    }
+
+    default:
+      // RegMask or RegUnit interference.
+      continue;
+    }
+  }
+
+  if (BestPhysReg) {
+    DEBUG(dbgs() << "evicting from " << PrintReg(BestPhysReg, TRI) << " for "
+                 << VirtReg << '\n');
+    evictInterferences(VirtReg, BestPhysReg, SplitVRegs);
+    assert(!Matrix->checkInterference(VirtReg, BestPhysReg) &&
+           "Interference after eviction.");
+    return BestPhysReg;
+  }
+
+  DEBUG(dbgs() << "spilling: " << VirtReg << '\n');
+  if (!VirtReg.isSpillable())
+    return ~0u;
+  LiveRangeEdit LRE(&VirtReg, SplitVRegs, *MF, *LIS, VRM);
+  spiller().spill(LRE);
+  return 0;
+}
+
+bool RALinearScan::runOnMachineFunction(MachineFunction &mf) {
+  DEBUG(dbgs() << "********** LINEAR SCAN REGISTER ALLOCATION **********\n"
+               << "********** Function: "
+               << mf.getName() << '\n');
+
+  MF = &mf;
+  RegAllocBase::init(getAnalysis<VirtRegMap>(),
+                     getAnalysis<LiveIntervals>(),
+                     getAnalysis<LiveRegMatrix>());
+
+  calculateSpillWeightsAndHints(*LIS, *MF,
+                                getAnalysis<MachineLoopInfo>(),
+                                getAnalysis<MachineBlockFrequencyInfo>());
+
+  SpillerInstance.reset(createInlineSpiller(*this, *MF, *VRM));
+
+  allocatePhysRegs();
+
+  // Diagnostic output before rewriting
+  DEBUG(dbgs() << "Post alloc VirtRegMap:\n" << *VRM << "\n");
+
+  releaseMemory();
+  return true;
+}
+
+FunctionPass* llvm::createLinearScanRegisterAllocator()
+{
+  return new RALinearScan();
+}
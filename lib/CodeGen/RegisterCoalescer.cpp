@@ -2190,6 +2190,9 @@ void RegisterCoalescer::releaseMemory() {
 }
 
 bool RegisterCoalescer::runOnMachineFunction(MachineFunction &fn) {
+  if (skipOptnoneFunction(*fn.getFunction())) // @LOCALMOD
+    return false;
+
   MF = &fn;
   MRI = &fn.getRegInfo();
   TM = &fn.getTarget();
@@ -14,6 +14,7 @@
 
 #define DEBUG_TYPE "misched"
 #include "llvm/CodeGen/ScheduleDAGInstrs.h"
+#include "llvm/ADT/Statistic.h" // @LOCALMOD
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallSet.h"
@@ -23,6 +24,7 @@
 #include "llvm/CodeGen/MachineFunctionPass.h"
 #include "llvm/CodeGen/MachineMemOperand.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/MachineScheduler.h" // @LOCALMOD
 #include "llvm/CodeGen/PseudoSourceValue.h"
 #include "llvm/CodeGen/RegisterPressure.h"
 #include "llvm/CodeGen/ScheduleDFS.h"
@@ -44,6 +46,21 @@ static cl::opt<bool> EnableAASchedMI("enable-aa-sched-mi", cl::Hidden,
     cl::ZeroOrMore, cl::init(false),
     cl::desc("Enable use of AA during MI GAD construction"));
 
+// @LOCALMOD-BEGIN
+// Every memory reference is checked against all the references tracked since
+// the last barrier, so huge blocks of loads and stores (common in pexes
+// produced by emscripten-style code generators) build quadratic chains.
+// After this many references, the next one is treated as a barrier, which
+// flushes the tracked lists. Off by default; pnacl-llc turns it on.
+cl::opt<unsigned> llvm::HugeMemRegion("sched-huge-mem-region", cl::Hidden,
+    cl::init(0),
+    cl::desc("Number of memory references after which the scheduler inserts "
+             "a chain barrier (0 = never)"));
+
+STATISTIC(NumHugeMemRegions,
+          "Number of scheduling regions with reduced memory dependencies");
+// @LOCALMOD-END
+
 ScheduleDAGInstrs::ScheduleDAGInstrs(MachineFunction &mf,
                                      const MachineLoopInfo &mli,
                                      const MachineDominatorTree &mdt,
@@ -716,6 +733,12 @@ void ScheduleDAGInstrs::buildSchedGraph(AliasAnalysis *AA,
   // Remember where a generic side-effecting instruction is as we procede.
   SUnit *BarrierChain = 0, *AliasChain = 0;
 
+  // @LOCALMOD-BEGIN
+  // Memory references seen since the last barrier, see HugeMemRegion.
+  unsigned NumMemRefs = 0;
+  bool ReducedMemDeps = false;
+  // @LOCALMOD-END
+
   // Memory references to specific known memory locations are tracked
   // so that they can be given more precise dependencies. We track
   // separately the known memory locations that may alias and those
@@ -812,7 +835,14 @@ void ScheduleDAGInstrs::buildSchedGraph(AliasAnalysis *AA,
     // TODO: Use an AliasAnalysis and do real alias-analysis queries, and
     // produce more precise dependence information.
     unsigned TrueMemOrderLatency = MI->mayStore() ? 1 : 0;
-    if (isGlobalMemoryObject(AA, MI)) {
+    // @LOCALMOD-BEGIN
+    bool ForceBarrier = false;
+    if (HugeMemRegion && (MI->mayLoad() || MI->mayStore()) &&
+        ++NumMemRefs > HugeMemRegion)
+      ForceBarrier = ReducedMemDeps = true;
+    // @LOCALMOD-END
+    if (ForceBarrier || isGlobalMemoryObject(AA, MI)) { // @LOCALMOD
+      NumMemRefs = 0; // @LOCALMOD
       // Be conservative with these and add dependencies on all memory
       // references, even those that are known to not alias.
       for (MapVector<const Value *, SUnit *>::iterator I =
@@ -993,6 +1023,9 @@ void ScheduleDAGInstrs::buildSchedGraph(AliasAnalysis *AA,
   if (DbgMI)
     FirstDbgValue = DbgMI;
 
+  if (ReducedMemDeps) // @LOCALMOD
+    ++NumHugeMemRegions;
+
   Defs.clear();
   Uses.clear();
   VRegDefs.clear();
@@ -18,8 +18,10 @@
 
 #define DEBUG_TYPE "dagcombine"
 #include "llvm/CodeGen/SelectionDAG.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/CodeGen/MachineFrameInfo.h"
 #include "llvm/CodeGen/MachineFunction.h"
@@ -30,7 +32,10 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/Mutex.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetLowering.h"
 #include "llvm/Target/TargetMachine.h"
@@ -46,6 +51,10 @@ STATISTIC(PostIndexedNodes, "Number of post-indexed nodes created");
 STATISTIC(OpsNarrowed     , "Number of load/op/store narrowed");
 STATISTIC(LdStFP2Int      , "Number of fp load/store pairs transformed to int");
 STATISTIC(SlicedLoads, "Number of load sliced");
+// @LOCALMOD-BEGIN
+STATISTIC(NodesVisited    , "Number of dag nodes visited by the combiner");
+STATISTIC(BudgetExhausted , "Number of combiner runs cut short by the budget");
+// @LOCALMOD-END
 
 namespace {
   static cl::opt<bool>
@@ -64,6 +73,18 @@ namespace {
                              "slicing"),
                     cl::init(false));
 
+  // @LOCALMOD-BEGIN
+  /// Cap on the number of nodes a single combiner run may fully combine, for
+  /// fast translation modes where pathological DAGs would otherwise be
+  /// re-combined over and over. Once exhausted, the remaining nodes only go
+  /// through the target's combines; the DAG is less optimized but valid.
+  static cl::opt<unsigned>
+  CombinerBudget("combiner-node-budget", cl::Hidden,
+                 cl::desc("Maximum number of nodes visited per DAG combiner "
+                          "run (0 = unlimited)"),
+                 cl::init(0));
+  // @LOCALMOD-END
+
 //------------------------------ DAGCombiner ---------------------------------//
 
   class DAGCombiner {
@@ -74,26 +95,35 @@ namespace {
     bool LegalOperations;
     bool LegalTypes;
     bool ForCodeSize;
+    // @LOCALMOD-BEGIN
+    /// TargetCombinesOnly - Set once the -combiner-node-budget is used up.
+    /// Target combines, and all combines of vector code, may be required for
+    /// correct lowering, so they keep running; only the generic folds of
+    /// scalar nodes are skipped.
+    bool TargetCombinesOnly;
+
+    /// OpcodeNames, OpcodeVisits, OpcodeCombines - The per-opcode counts of
+    /// this run, only kept when statistics are enabled.  They are added to
+    /// the totals printed under -stats when the run ends.
+    std::vector<std::string> OpcodeNames;
+    std::vector<unsigned> OpcodeVisits, OpcodeCombines;
+    // @LOCALMOD-END
 
     // Worklist of all of the nodes that need to be simplified.
     //
     // This has the semantics that when adding to the worklist,
     // the item added must be next to be processed. It should
-    // also only appear once. The naive approach to this takes
-    // linear time.
-    //
-    // To reduce the insert/remove time to logarithmic, we use
-    // a set and a vector to maintain our worklist.
-    //
-    // The set contains the items on the worklist, but does not
-    // maintain the order they should be visited.
+    // also only appear once.
     //
-    // The vector maintains the order nodes should be visited, but may
-    // contain duplicate or removed nodes. When choosing a node to
-    // visit, we pop off the order stack until we find an item that is
-    // also in the contents set. All operations are O(log N).
-    SmallPtrSet<SDNode*, 64> WorkListContents;
-    SmallVector<SDNode*, 64> WorkListOrder;
+    // @LOCALMOD-BEGIN
+    // WorkList holds the nodes in the order they should be visited. Entries
+    // that were removed, or superseded by adding the node again, are nulled
+    // out rather than erased. WorkListMap maps each node on the worklist to
+    // its slot in WorkList, so insertion, removal and membership tests are
+    // all O(1).
+    SmallVector<SDNode*, 64> WorkList;
+    DenseMap<SDNode*, unsigned> WorkListMap;
+    // @LOCALMOD-END
 
     // AA - Used for DAG load/store alias analysis.
     AliasAnalysis &AA;
@@ -116,16 +146,43 @@ namespace {
     /// AddToWorkList - Add to the work list making sure its instance is at the
     /// back (next to be processed.)
     void AddToWorkList(SDNode *N) {
-      WorkListContents.insert(N);
-      WorkListOrder.push_back(N);
+      // @LOCALMOD-BEGIN
+      std::pair<DenseMap<SDNode*, unsigned>::iterator, bool> IP =
+        WorkListMap.insert(std::make_pair(N, WorkList.size()));
+      if (!IP.second) {
+        if (IP.first->second == WorkList.size() - 1)
+          return; // Already next to be processed.
+        WorkList[IP.first->second] = 0;
+        IP.first->second = WorkList.size();
+      }
+      WorkList.push_back(N);
+      // @LOCALMOD-END
     }
 
     /// removeFromWorkList - remove all instances of N from the worklist.
     ///
     void removeFromWorkList(SDNode *N) {
-      WorkListContents.erase(N);
+      // @LOCALMOD-BEGIN
+      DenseMap<SDNode*, unsigned>::iterator I = WorkListMap.find(N);
+      if (I == WorkListMap.end())
+        return;
+      WorkList[I->second] = 0;
+      WorkListMap.erase(I);
+      // @LOCALMOD-END
     }
 
+    // @LOCALMOD-BEGIN
+    /// getNextWorkListEntry - Pop the next node to visit off the worklist.
+    ///
+    SDNode *getNextWorkListEntry() {
+      SDNode *N = 0;
+      while (!N)
+        N = WorkList.pop_back_val();
+      WorkListMap.erase(N);
+      return N;
+    }
+    // @LOCALMOD-END
+
     SDValue CombineTo(SDNode *N, const SDValue *To, unsigned NumTo,
                       bool AddTo = true);
 
@@ -329,7 +386,8 @@ namespace {
   public:
     DAGCombiner(SelectionDAG &D, AliasAnalysis &A, CodeGenOpt::Level OL)
         : DAG(D), TLI(D.getTargetLoweringInfo()), Level(BeforeLegalizeTypes),
-          OptLevel(OL), LegalOperations(false), LegalTypes(false), AA(A) {
+          OptLevel(OL), LegalOperations(false), LegalTypes(false),
+          TargetCombinesOnly(false), AA(A) { // @LOCALMOD
       AttributeSet FnAttrs =
           DAG.getMachineFunction().getFunction()->getAttributes();
       ForCodeSize =
@@ -1010,6 +1068,75 @@ bool DAGCombiner::PromoteLoad(SDValue Op) {
 //  Main DAG Combiner implementation
 //===----------------------------------------------------------------------===//
 
+// @LOCALMOD-BEGIN
+/// Per-opcode visit and combine counts, printed under -stats so that it's
+/// visible which combines the time goes into.  Like statistics, they are
+/// only counted in builds with assertions or LLVM_ENABLE_STATS, and they
+/// are left out of -stats-json.  All target-specific opcodes share the last
+/// slot.
+static const unsigned NumOpcodeCounts = ISD::BUILTIN_OP_END + 1;
+
+namespace {
+/// CombinerOpcodeCounts - The per-opcode counts of all combiner runs.  They
+/// are printed when the counts are destroyed by llvm_shutdown(), before the
+/// statistics, which were registered earlier.
+class CombinerOpcodeCounts {
+  sys::SmartMutex<true> Lock;
+  std::vector<std::string> Names;
+  std::vector<unsigned> Visits, Combines;
+
+public:
+  CombinerOpcodeCounts()
+    : Names(NumOpcodeCounts), Visits(NumOpcodeCounts),
+      Combines(NumOpcodeCounts) {}
+  ~CombinerOpcodeCounts();
+
+  void add(const std::vector<std::string> &RunNames,
+           const std::vector<unsigned> &RunVisits,
+           const std::vector<unsigned> &RunCombines) {
+    sys::SmartScopedLock<true> Guard(Lock);
+    for (unsigned i = 0; i != NumOpcodeCounts; ++i) {
+      if (!RunVisits[i])
+        continue;
+      if (Names[i].empty())
+        Names[i] = RunNames[i];
+      Visits[i] += RunVisits[i];
+      Combines[i] += RunCombines[i];
+    }
+  }
+};
+}
+
+static ManagedStatic<CombinerOpcodeCounts> OpcodeCounts;
+
+namespace llvm { extern raw_ostream *CreateInfoOutputFile(); }
+
+CombinerOpcodeCounts::~CombinerOpcodeCounts() {
+  unsigned MaxCount = 0;
+  for (unsigned i = 0; i != NumOpcodeCounts; ++i)
+    MaxCount = std::max(MaxCount, Visits[i]);
+  if (!MaxCount)
+    return;
+  unsigned CountLen = utostr(MaxCount).size();
+
+  raw_ostream &OS = *CreateInfoOutputFile();
+  OS << "===" << std::string(73, '-') << "===\n"
+     << "                 ... DAG Combiner Statistics Per Opcode ...\n"
+     << "===" << std::string(73, '-') << "===\n\n";
+  for (unsigned i = 0; i != NumOpcodeCounts; ++i) {
+    if (!Visits[i])
+      continue;
+    OS << format("%*u " DEBUG_TYPE " - Number of %s nodes visited\n", CountLen,
+                 Visits[i], Names[i].c_str());
+    OS << format("%*u " DEBUG_TYPE " - Number of %s nodes combined\n", CountLen,
+                 Combines[i], Names[i].c_str());
+  }
+  OS << '\n';
+  OS.flush();
+  delete &OS;
+}
+// @LOCALMOD-END
+
 void DAGCombiner::Run(CombineLevel AtLevel) {
   // set the instance variables, so that the various visit routines may use it.
   Level = AtLevel;
@@ -1030,18 +1157,25 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
   // done.  Set it to null to avoid confusion.
   DAG.setRoot(SDValue());
 
+  // @LOCALMOD-BEGIN
+  unsigned Budget = CombinerBudget;
+  TargetCombinesOnly = false;
+#if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
+  bool CountOpcodes = AreStatisticsEnabled() && !AreStatisticsPrintedAsJSON();
+#else
+  bool CountOpcodes = false;
+#endif
+  if (CountOpcodes) {
+    OpcodeNames.assign(NumOpcodeCounts, std::string());
+    OpcodeVisits.assign(NumOpcodeCounts, 0);
+    OpcodeCombines.assign(NumOpcodeCounts, 0);
+  }
+  // @LOCALMOD-END
+
   // while the worklist isn't empty, find a node and
   // try and combine it.
-  while (!WorkListContents.empty()) {
-    SDNode *N;
-    // The WorkListOrder holds the SDNodes in order, but it may contain
-    // duplicates.
-    // In order to avoid a linear scan, we use a set (O(log N)) to hold what the
-    // worklist *should* contain, and check the node we want to visit is should
-    // actually be visited.
-    do {
-      N = WorkListOrder.pop_back_val();
-    } while (!WorkListContents.erase(N));
+  while (!WorkListMap.empty()) {
+    SDNode *N = getNextWorkListEntry(); // @LOCALMOD
 
     // If N has no uses, it is dead.  Make sure to revisit all N's operands once
     // N is deleted from the DAG, since they too may now be dead or may have a
@@ -1054,12 +1188,28 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
       continue;
     }
 
+    // @LOCALMOD-BEGIN
+    if (CombinerBudget && !TargetCombinesOnly && Budget-- == 0) {
+      ++BudgetExhausted;
+      TargetCombinesOnly = true;
+    }
+
+    ++NodesVisited;
+    unsigned OpcodeIdx = std::min<unsigned>(N->getOpcode(),
+                                            ISD::BUILTIN_OP_END);
+    if (CountOpcodes && OpcodeVisits[OpcodeIdx]++ == 0)
+      OpcodeNames[OpcodeIdx] = OpcodeIdx == ISD::BUILTIN_OP_END
+                                   ? std::string("target-specific")
+                                   : N->getOperationName();
+    // @LOCALMOD-END
+
     SDValue RV = combine(N);
 
     if (RV.getNode() == 0)
       continue;
 
     ++NodesCombined;
+    if (CountOpcodes) ++OpcodeCombines[OpcodeIdx]; // @LOCALMOD
 
     // If we get back the same node we passed in, rather than a new node or
     // zero, we know that the node must have defined multiple values and
@@ -1113,6 +1263,11 @@ void DAGCombiner::Run(CombineLevel AtLevel) {
     }
   }
 
+  // @LOCALMOD-BEGIN
+  if (CountOpcodes)
+    OpcodeCounts->add(OpcodeNames, OpcodeVisits, OpcodeCombines);
+  // @LOCALMOD-END
+
   // If the root changed (e.g. it was a dead load, update the root).
   DAG.setRoot(Dummy.getValue());
   DAG.RemoveDeadNodes();
@@ -1197,8 +1352,29 @@ SDValue DAGCombiner::visit(SDNode *N) {
   return SDValue();
 }
 
+// @LOCALMOD-BEGIN
+/// involvesVectors - Return true if N produces or consumes a vector value.
+static bool involvesVectors(const SDNode *N) {
+  for (unsigned i = 0, e = N->getNumValues(); i != e; ++i)
+    if (N->getValueType(i).isVector())
+      return true;
+  for (unsigned i = 0, e = N->getNumOperands(); i != e; ++i)
+    if (N->getOperand(i).getValueType().isVector())
+      return true;
+  return false;
+}
+// @LOCALMOD-END
+
 SDValue DAGCombiner::combine(SDNode *N) {
-  SDValue RV = visit(N);
+  // @LOCALMOD-BEGIN
+  // Nodes touching vectors are always fully combined: some of the generic
+  // vector folds (VSELECT condition splitting, shuffle and extract_vector_elt
+  // simplification) are relied upon by the legalizer and the selectors.
+  bool Restricted = TargetCombinesOnly && !involvesVectors(N);
+  SDValue RV;
+  if (!Restricted)
+    RV = visit(N);
+  // @LOCALMOD-END
 
   // If nothing happened, try a target-specific DAG combine.
   if (RV.getNode() == 0) {
@@ -1217,7 +1393,7 @@ SDValue DAGCombiner::combine(SDNode *N) {
   }
 
   // If nothing happened still, try promoting the operation.
-  if (RV.getNode() == 0) {
+  if (RV.getNode() == 0 && !Restricted) { // @LOCALMOD
     switch (N->getOpcode()) {
     default: break;
     case ISD::ADD:
@@ -1247,7 +1423,7 @@ SDValue DAGCombiner::combine(SDNode *N) {
 
   // If N is a commutative binary node, try commuting it to enable more
   // sdisel CSE.
-  if (RV.getNode() == 0 &&
+  if (RV.getNode() == 0 && !Restricted && // @LOCALMOD
       SelectionDAG::isCommutativeBinOp(N->getOpcode()) &&
       N->getNumValues() == 1) {
     SDValue N0 = N->getOperand(0);
@@ -625,6 +625,20 @@ void SelectionDAG::DeleteNodeNotInCSEMaps(SDNode *N) {
   DeallocateNode(N);
 }
 
+// @LOCALMOD-BEGIN
+/// newSDNode - Create a generic node with an arbitrary number of operands.
+/// The operand list is allocated out of OperandAllocator, which is recycled
+/// wholesale when the DAG is cleared, instead of with new[] per node.
+SDNode *SelectionDAG::newSDNode(unsigned Opcode, SDLoc DL, SDVTList VTs,
+                                const SDValue *Ops, unsigned NumOps) {
+  SDNode *N = new (NodeAllocator) SDNode(Opcode, DL.getIROrder(),
+                                         DL.getDebugLoc(), VTs);
+  if (NumOps)
+    N->InitOperands(OperandAllocator.Allocate<SDUse>(NumOps), Ops, NumOps);
+  return N;
+}
+// @LOCALMOD-END
+
 void SelectionDAG::DeallocateNode(SDNode *N) {
   if (N->OperandsNeedDelete)
     delete[] N->OperandList;
@@ -680,6 +694,7 @@ bool SelectionDAG::RemoveNodeFromCSEMaps(SDNode *N) {
     assert(N->getOpcode() != ISD::DELETED_NODE && "DELETED_NODE in CSEMap!");
     assert(N->getOpcode() != ISD::EntryToken && "EntryToken in CSEMap!");
     Erased = CSEMap.RemoveNode(N);
+    N->CSEHash = 0; // @LOCALMOD
     break;
   }
 #ifndef NDEBUG
@@ -4829,12 +4844,10 @@ SDValue SelectionDAG::getNode(unsigned Opcode, SDLoc DL, EVT VT,
     if (SDNode *E = CSEMap.FindNodeOrInsertPos(ID, IP))
       return SDValue(E, 0);
 
-    N = new (NodeAllocator) SDNode(Opcode, DL.getIROrder(), DL.getDebugLoc(),
-                                   VTs, Ops, NumOps);
+    N = newSDNode(Opcode, DL, VTs, Ops, NumOps); // @LOCALMOD
     CSEMap.InsertNode(N, IP);
   } else {
-    N = new (NodeAllocator) SDNode(Opcode, DL.getIROrder(), DL.getDebugLoc(),
-                                   VTs, Ops, NumOps);
+    N = newSDNode(Opcode, DL, VTs, Ops, NumOps); // @LOCALMOD
   }
 
   AllNodes.push_back(N);
@@ -4908,8 +4921,7 @@ SDValue SelectionDAG::getNode(unsigned Opcode, SDLoc DL, SDVTList VTList,
                                             DL.getDebugLoc(), VTList, Ops[0],
                                             Ops[1], Ops[2]);
     } else {
-      N = new (NodeAllocator) SDNode(Opcode, DL.getIROrder(), DL.getDebugLoc(),
-                                     VTList, Ops, NumOps);
+      N = newSDNode(Opcode, DL, VTList, Ops, NumOps); // @LOCALMOD
     }
     CSEMap.InsertNode(N, IP);
   } else {
@@ -4925,8 +4937,7 @@ SDValue SelectionDAG::getNode(unsigned Opcode, SDLoc DL, SDVTList VTList,
                                             DL.getDebugLoc(), VTList, Ops[0],
                                             Ops[1], Ops[2]);
     } else {
-      N = new (NodeAllocator) SDNode(Opcode, DL.getIROrder(), DL.getDebugLoc(),
-                                     VTList, Ops, NumOps);
+      N = newSDNode(Opcode, DL, VTList, Ops, NumOps); // @LOCALMOD
     }
   }
   AllNodes.push_back(N);
@@ -5376,8 +5387,12 @@ SDNode *SelectionDAG::MorphNodeTo(SDNode *N, unsigned Opc,
     if (NumOps > N->NumOperands) {
       if (N->OperandsNeedDelete)
         delete[] N->OperandList;
-      N->InitOperands(new SDUse[NumOps], Ops, NumOps);
-      N->OperandsNeedDelete = true;
+      // @LOCALMOD-BEGIN
+      // Like the MachineSDNode case above, the operands can come straight out
+      // of the pool as they don't need to outlive the current DAG.
+      N->InitOperands(OperandAllocator.Allocate<SDUse>(NumOps), Ops, NumOps);
+      N->OperandsNeedDelete = false;
+      // @LOCALMOD-END
     } else
       N->InitOperands(N->OperandList, Ops, NumOps);
   }
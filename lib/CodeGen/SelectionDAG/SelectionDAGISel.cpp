@@ -67,6 +67,10 @@ STATISTIC(NumDAGIselRetries,"Number of times dag isel has to try another path");
 STATISTIC(NumEntryBlocks, "Number of entry blocks encountered");
 STATISTIC(NumFastIselFailLowerArguments,
           "Number of entry blocks where fast isel failed to lower arguments");
+// @LOCALMOD-BEGIN
+STATISTIC(NumTrivialFastIselBlocks,
+          "Number of trivial blocks selected by fast isel at -O1 and above");
+// @LOCALMOD-END
 
 #ifndef NDEBUG
 static cl::opt<bool>
@@ -156,6 +160,19 @@ EnableFastISelAbortArgs("fast-isel-abort-args", cl::Hidden,
           cl::desc("Enable abort calls when \"fast\" instruction selection "
                    "fails to lower a formal argument"));
 
+// @LOCALMOD-BEGIN
+// Blocks which contain nothing but PHI nodes and an unconditional branch
+// (frequent in PNaCl code after ExpandGetElementPtr, PromoteIntegers and
+// friends) gain nothing from DAG combining and legalization, yet pay their
+// full fixed cost. When enabled, such blocks are selected with FastISel even
+// when optimizing, falling back to SelectionDAG if FastISel can't handle them.
+static cl::opt<bool>
+FastISelTrivialBlocks("fast-isel-trivial-blocks", cl::Hidden,
+          cl::desc("Use \"fast\" instruction selection for blocks which only "
+                   "contain an unconditional branch"),
+          cl::init(false));
+// @LOCALMOD-END
+
 static cl::opt<bool>
 UseMBPI("use-mbpi",
         cl::desc("use Machine Branch Probability Info"),
@@ -346,7 +363,53 @@ static void SplitCriticalSideEffectEdges(Function &Fn, Pass *SDISel) {
   }
 }
 
+// @LOCALMOD-BEGIN
+namespace {
+/// OptLevelChanger - Select an optnone function as if at -O0, with FastISel,
+/// restoring the selector's optimization level and the target's FastISel
+/// setting afterwards. pnacl-llc marks functions which exceed its compile
+/// budget this way.
+class OptLevelChanger {
+  CodeGenOpt::Level &OptLevel;
+  TargetMachine &TM;
+  CodeGenOpt::Level SavedOptLevel;
+  bool SavedFastISel;
+public:
+  OptLevelChanger(CodeGenOpt::Level &OL, TargetMachine &TM,
+                  const Function &Fn)
+    : OptLevel(OL), TM(TM), SavedOptLevel(OL),
+      SavedFastISel(TM.Options.EnableFastISel) {
+    if (OptLevel == CodeGenOpt::None ||
+        !Fn.getAttributes().hasAttribute(AttributeSet::FunctionIndex,
+                                         Attribute::OptimizeNone))
+      return;
+    DEBUG(dbgs() << "Selecting optnone function " << Fn.getName()
+                 << " at -O0\n");
+    OptLevel = CodeGenOpt::None;
+    // The StackProtector pass has already chosen the SelectionDAG guard check
+    // for this function, which FastISel does not implement.
+    AttributeSet Attrs = Fn.getAttributes();
+    if (!Attrs.hasAttribute(AttributeSet::FunctionIndex,
+                            Attribute::StackProtect) &&
+        !Attrs.hasAttribute(AttributeSet::FunctionIndex,
+                            Attribute::StackProtectReq) &&
+        !Attrs.hasAttribute(AttributeSet::FunctionIndex,
+                            Attribute::StackProtectStrong))
+      TM.setFastISel(true);
+  }
+  ~OptLevelChanger() {
+    OptLevel = SavedOptLevel;
+    TM.setFastISel(SavedFastISel);
+  }
+};
+}
+// @LOCALMOD-END
+
 bool SelectionDAGISel::runOnMachineFunction(MachineFunction &mf) {
+  // @LOCALMOD-BEGIN
+  OptLevelChanger OLC(OptLevel, TM, *mf.getFunction());
+  // @LOCALMOD-END
+
   // Do some sanity-checking on the command-line options.
   assert((!EnableFastISelVerbose || TM.Options.EnableFastISel) &&
          "-fast-isel-verbose requires -fast-isel");
@@ -943,11 +1006,51 @@ static void collectFailStats(const Instruction *I) {
 }
 #endif
 
+// @LOCALMOD-BEGIN
+/// isTrivialBranchBlock - Return true if the first non-PHI instruction of a
+/// block is an unconditional branch, i.e. the block only exists to feed PHI
+/// nodes of its successor or to join control flow.
+static bool isTrivialBranchBlock(BasicBlock::const_iterator FirstNonPHI) {
+  const BranchInst *Br = dyn_cast<BranchInst>(FirstNonPHI);
+  return Br && Br->isUnconditional();
+}
+
+/// SelectTrivialBlock - Select a block consisting of PHI nodes and an
+/// unconditional branch with FastISel. On failure, anything FastISel emitted
+/// is removed so that the block can be handed to SelectionDAG unchanged.
+bool SelectionDAGISel::SelectTrivialBlock(FastISel *FastIS,
+                                          const Instruction *Term) {
+  assert(FuncInfo->MBB->getFirstNonPHI() == FuncInfo->MBB->end() &&
+         "Trivial block already has code!");
+  FastIS->startNewBlock();
+  FastIS->recomputeInsertPt();
+  if (FastIS->SelectInstruction(Term)) {
+    FastIS->recomputeInsertPt();
+    return true;
+  }
+  // Throw away any local values which were materialized before the failure;
+  // startNewBlock forgets about them again. The machine PHIs created by
+  // FunctionLoweringInfo stay.
+  while (!FuncInfo->MBB->empty() && !FuncInfo->MBB->back().isPHI())
+    FuncInfo->MBB->back().eraseFromParent();
+  FastIS->startNewBlock();
+  FuncInfo->InsertPt = FuncInfo->MBB->getFirstNonPHI();
+  return false;
+}
+// @LOCALMOD-END
+
 void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
   // Initialize the Fast-ISel state, if needed.
   FastISel *FastIS = 0;
   if (TM.Options.EnableFastISel)
     FastIS = getTargetLowering()->createFastISel(*FuncInfo, LibInfo);
+  // @LOCALMOD-BEGIN
+  // A separate FastISel instance which is only used for trivial blocks when
+  // the rest of the function goes through SelectionDAG.
+  FastISel *TrivialFastIS = 0;
+  if (!FastIS && FastISelTrivialBlocks && OptLevel != CodeGenOpt::None)
+    TrivialFastIS = getTargetLowering()->createFastISel(*FuncInfo, LibInfo);
+  // @LOCALMOD-END
 
   // Iterate over all basic blocks in the function.
   ReversePostOrderTraversal<const Function*> RPOT(&Fn);
@@ -1128,6 +1231,15 @@ void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
       if (LLVMBB == &Fn.getEntryBlock()) {
         ++NumEntryBlocks;
         LowerArguments(Fn);
+      // @LOCALMOD-BEGIN
+      } else if (TrivialFastIS &&
+                 FuncInfo->MBB->getFirstNonPHI() == FuncInfo->MBB->end() &&
+                 !FuncInfo->MBB->isLandingPad() &&
+                 isTrivialBranchBlock(Begin) &&
+                 SelectTrivialBlock(TrivialFastIS, Begin)) {
+        BI = Begin;
+        ++NumTrivialFastIselBlocks;
+      // @LOCALMOD-END
       }
     }
 
@@ -1149,6 +1261,7 @@ void SelectionDAGISel::SelectAllBasicBlocks(const Function &Fn) {
   }
 
   delete FastIS;
+  delete TrivialFastIS; // @LOCALMOD
   SDB->clearDanglingDebugInfo();
   SDB->SPDescriptor.resetPerFunctionState();
 }
@@ -34,8 +34,11 @@ void SlotIndexes::releaseMemory() {
   mi2iMap.clear();
   MBBRanges.clear();
   idx2MBBMap.clear();
-  indexList.clear();
-  ileAllocator.Reset();
+  // @LOCALMOD-BEGIN
+  // Keep the entries for the next function rather than resetting
+  // ileAllocator, which would return all but one slab to the heap.
+  freeEntries.splice(freeEntries.end(), indexList);
+  // @LOCALMOD-END
 }
 
 bool SlotIndexes::runOnMachineFunction(MachineFunction &fn) {
@@ -37,6 +37,7 @@ Attribute Attribute::get(LLVMContext &Context, Attribute::AttrKind Kind,
   ID.AddInteger(Kind);
   if (Val) ID.AddInteger(Val);
 
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   void *InsertPoint;
   AttributeImpl *PA = pImpl->AttrsSet.FindNodeOrInsertPos(ID, InsertPoint);
 
@@ -60,6 +61,7 @@ Attribute Attribute::get(LLVMContext &Context, StringRef Kind, StringRef Val) {
   ID.AddString(Kind);
   if (!Val.empty()) ID.AddString(Val);
 
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   void *InsertPoint;
   AttributeImpl *PA = pImpl->AttrsSet.FindNodeOrInsertPos(ID, InsertPoint);
 
@@ -412,6 +414,7 @@ AttributeSetNode *AttributeSetNode::get(LLVMContext &C,
          E = SortedAttrs.end(); I != E; ++I)
     I->Profile(ID);
 
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   void *InsertPoint;
   AttributeSetNode *PA =
     pImpl->AttrsSetNodes.FindNodeOrInsertPos(ID, InsertPoint);
@@ -530,6 +533,7 @@ AttributeSet::getImpl(LLVMContext &C,
   FoldingSetNodeID ID;
   AttributeSetImpl::Profile(ID, Attrs);
 
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   void *InsertPoint;
   AttributeSetImpl *PA = pImpl->AttrsLists.FindNodeOrInsertPos(ID, InsertPoint);
 
@@ -484,6 +484,7 @@ ConstantInt *ConstantInt::get(LLVMContext &Context, const APInt &V) {
   IntegerType *ITy = IntegerType::get(Context, V.getBitWidth());
   // get an existing value or the insertion position
   LLVMContextImpl *pImpl = Context.pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   ConstantInt *&Slot = pImpl->IntConstants[DenseMapAPIntKeyInfo::KeyTy(V, ITy)];
   if (!Slot) Slot = new ConstantInt(ITy, V);
   return Slot;
@@ -609,6 +610,7 @@ Constant *ConstantFP::getZeroValueForNegation(Type *Ty) {
 // ConstantFP accessors.
 ConstantFP* ConstantFP::get(LLVMContext &Context, const APFloat& V) {
   LLVMContextImpl* pImpl = Context.pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
 
   ConstantFP *&Slot = pImpl->FPConstants[DenseMapAPFloatKeyInfo::KeyTy(V)];
 
@@ -833,6 +835,7 @@ Constant *ConstantArray::get(ArrayType *Ty, ArrayRef<Constant*> V) {
   }
 
   // Otherwise, we really do want to create a ConstantArray.
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ArrayConstants.getOrCreate(Ty, V);
 }
 
@@ -896,6 +899,7 @@ Constant *ConstantStruct::get(StructType *ST, ArrayRef<Constant*> V) {
   if (isUndef)
     return UndefValue::get(ST);
 
+  UniquingGuard Guard(ST->getContext().pImpl->ConstantsLock); // @LOCALMOD
   return ST->getContext().pImpl->StructConstants.getOrCreate(ST, V);
 }
 
@@ -1015,6 +1019,7 @@ Constant *ConstantVector::get(ArrayRef<Constant*> V) {
 
   // Otherwise, the element type isn't compatible with ConstantDataVector, or
   // the operand list constants a ConstantExpr or something else strange.
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->VectorConstants.getOrCreate(T, V);
 }
 
@@ -1232,6 +1237,7 @@ ConstantAggregateZero *ConstantAggregateZero::get(Type *Ty) {
   assert((Ty->isStructTy() || Ty->isArrayTy() || Ty->isVectorTy()) &&
          "Cannot create an aggregate zero of non-aggregate type!");
   
+  UniquingGuard Guard(Ty->getContext().pImpl->ConstantsLock); // @LOCALMOD
   ConstantAggregateZero *&Entry = Ty->getContext().pImpl->CAZConstants[Ty];
   if (Entry == 0)
     Entry = new ConstantAggregateZero(Ty);
@@ -1242,6 +1248,7 @@ ConstantAggregateZero *ConstantAggregateZero::get(Type *Ty) {
 /// destroyConstant - Remove the constant from the constant table.
 ///
 void ConstantAggregateZero::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getContext().pImpl->CAZConstants.erase(getType());
   destroyConstantImpl();
 }
@@ -1249,6 +1256,7 @@ void ConstantAggregateZero::destroyConstant() {
 /// destroyConstant - Remove the constant from the constant table...
 ///
 void ConstantArray::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getType()->getContext().pImpl->ArrayConstants.remove(this);
   destroyConstantImpl();
 }
@@ -1260,6 +1268,7 @@ void ConstantArray::destroyConstant() {
 // destroyConstant - Remove the constant from the constant table...
 //
 void ConstantStruct::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getType()->getContext().pImpl->StructConstants.remove(this);
   destroyConstantImpl();
 }
@@ -1267,6 +1276,7 @@ void ConstantStruct::destroyConstant() {
 // destroyConstant - Remove the constant from the constant table...
 //
 void ConstantVector::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getType()->getContext().pImpl->VectorConstants.remove(this);
   destroyConstantImpl();
 }
@@ -1312,6 +1322,7 @@ const APInt &Constant::getUniqueInteger() const {
 //
 
 ConstantPointerNull *ConstantPointerNull::get(PointerType *Ty) {
+  UniquingGuard Guard(Ty->getContext().pImpl->ConstantsLock); // @LOCALMOD
   ConstantPointerNull *&Entry = Ty->getContext().pImpl->CPNConstants[Ty];
   if (Entry == 0)
     Entry = new ConstantPointerNull(Ty);
@@ -1322,6 +1333,7 @@ ConstantPointerNull *ConstantPointerNull::get(PointerType *Ty) {
 // destroyConstant - Remove the constant from the constant table...
 //
 void ConstantPointerNull::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getContext().pImpl->CPNConstants.erase(getType());
   // Free the constant and any dangling references to it.
   destroyConstantImpl();
@@ -1332,6 +1344,7 @@ void ConstantPointerNull::destroyConstant() {
 //
 
 UndefValue *UndefValue::get(Type *Ty) {
+  UniquingGuard Guard(Ty->getContext().pImpl->ConstantsLock); // @LOCALMOD
   UndefValue *&Entry = Ty->getContext().pImpl->UVConstants[Ty];
   if (Entry == 0)
     Entry = new UndefValue(Ty);
@@ -1342,6 +1355,7 @@ UndefValue *UndefValue::get(Type *Ty) {
 // destroyConstant - Remove the constant from the constant table.
 //
 void UndefValue::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   // Free the constant and any dangling references to it.
   getContext().pImpl->UVConstants.erase(getType());
   destroyConstantImpl();
@@ -1356,6 +1370,7 @@ BlockAddress *BlockAddress::get(BasicBlock *BB) {
 }
 
 BlockAddress *BlockAddress::get(Function *F, BasicBlock *BB) {
+  UniquingGuard Guard(F->getContext().pImpl->ConstantsLock); // @LOCALMOD
   BlockAddress *&BA =
     F->getContext().pImpl->BlockAddresses[std::make_pair(F, BB)];
   if (BA == 0)
@@ -1377,6 +1392,7 @@ BlockAddress::BlockAddress(Function *F, BasicBlock *BB)
 // destroyConstant - Remove the constant from the constant table.
 //
 void BlockAddress::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getFunction()->getType()->getContext().pImpl
     ->BlockAddresses.erase(std::make_pair(getFunction(), getBasicBlock()));
   getBasicBlock()->AdjustBlockAddressRefCount(-1);
@@ -1384,6 +1400,7 @@ void BlockAddress::destroyConstant() {
 }
 
 void BlockAddress::replaceUsesOfWithOnConstant(Value *From, Value *To, Use *U) {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   // This could be replacing either the Basic Block or the Function.  In either
   // case, we have to remove the map entry.
   Function *NewF = getFunction();
@@ -1438,6 +1455,7 @@ static inline Constant *getFoldedCast(
   // Look up the constant in the table first to ensure uniqueness.
   ExprMapKeyType Key(opc, C);
 
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(Ty, Key);
 }
 
@@ -1750,6 +1768,7 @@ Constant *ConstantExpr::get(unsigned Opcode, Constant *C1, Constant *C2,
   ExprMapKeyType Key(Opcode, ArgVec, 0, Flags);
 
   LLVMContextImpl *pImpl = C1->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(C1->getType(), Key);
 }
 
@@ -1827,6 +1846,7 @@ Constant *ConstantExpr::getSelect(Constant *C, Constant *V1, Constant *V2) {
   ExprMapKeyType Key(Instruction::Select, ArgVec);
 
   LLVMContextImpl *pImpl = C->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(V1->getType(), Key);
 }
 
@@ -1863,6 +1883,7 @@ Constant *ConstantExpr::getGetElementPtr(Constant *C, ArrayRef<Value *> Idxs,
                            InBounds ? GEPOperator::IsInBounds : 0);
 
   LLVMContextImpl *pImpl = C->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(ReqTy, Key);
 }
 
@@ -1885,6 +1906,7 @@ ConstantExpr::getICmp(unsigned short pred, Constant *LHS, Constant *RHS) {
     ResultTy = VectorType::get(ResultTy, VT->getNumElements());
 
   LLVMContextImpl *pImpl = LHS->getType()->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(ResultTy, Key);
 }
 
@@ -1906,6 +1928,7 @@ ConstantExpr::getFCmp(unsigned short pred, Constant *LHS, Constant *RHS) {
     ResultTy = VectorType::get(ResultTy, VT->getNumElements());
 
   LLVMContextImpl *pImpl = LHS->getType()->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(ResultTy, Key);
 }
 
@@ -1924,6 +1947,7 @@ Constant *ConstantExpr::getExtractElement(Constant *Val, Constant *Idx) {
 
   LLVMContextImpl *pImpl = Val->getContext().pImpl;
   Type *ReqTy = Val->getType()->getVectorElementType();
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(ReqTy, Key);
 }
 
@@ -1943,6 +1967,7 @@ Constant *ConstantExpr::getInsertElement(Constant *Val, Constant *Elt,
   const ExprMapKeyType Key(Instruction::InsertElement, ArgVec);
 
   LLVMContextImpl *pImpl = Val->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(Val->getType(), Key);
 }
 
@@ -1963,6 +1988,7 @@ Constant *ConstantExpr::getShuffleVector(Constant *V1, Constant *V2,
   const ExprMapKeyType Key(Instruction::ShuffleVector, ArgVec);
 
   LLVMContextImpl *pImpl = ShufTy->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(ShufTy, Key);
 }
 
@@ -1983,6 +2009,7 @@ Constant *ConstantExpr::getInsertValue(Constant *Agg, Constant *Val,
   const ExprMapKeyType Key(Instruction::InsertValue, ArgVec, 0, 0, Idxs);
 
   LLVMContextImpl *pImpl = Agg->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(ReqTy, Key);
 }
 
@@ -2004,6 +2031,7 @@ Constant *ConstantExpr::getExtractValue(Constant *Agg,
   const ExprMapKeyType Key(Instruction::ExtractValue, ArgVec, 0, 0, Idxs);
 
   LLVMContextImpl *pImpl = Agg->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->ExprConstants.getOrCreate(ReqTy, Key);
 }
 
@@ -2158,6 +2186,7 @@ Constant *ConstantExpr::getBinOpAbsorber(unsigned Opcode, Type *Ty) {
 // destroyConstant - Remove the constant from the constant table...
 //
 void ConstantExpr::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getType()->getContext().pImpl->ExprConstants.remove(this);
   destroyConstantImpl();
 }
@@ -2253,6 +2282,7 @@ Constant *ConstantDataSequential::getImpl(StringRef Elements, Type *Ty) {
     return ConstantAggregateZero::get(Ty);
 
   // Do a lookup to see if we have already formed one of these.
+  UniquingGuard Guard(Ty->getContext().pImpl->ConstantsLock); // @LOCALMOD
   StringMap<ConstantDataSequential*>::MapEntryTy &Slot =
     Ty->getContext().pImpl->CDSConstants.GetOrCreateValue(Elements);
 
@@ -2276,6 +2306,7 @@ Constant *ConstantDataSequential::getImpl(StringRef Elements, Type *Ty) {
 }
 
 void ConstantDataSequential::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   // Remove the constant from the StringMap.
   StringMap<ConstantDataSequential*> &CDSConstants = 
     getType()->getContext().pImpl->CDSConstants;
@@ -2563,6 +2594,7 @@ void ConstantArray::replaceUsesOfWithOnConstant(Value *From, Value *To,
   Constant *ToC = cast<Constant>(To);
 
   LLVMContextImpl *pImpl = getType()->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
 
   SmallVector<Constant*, 8> Values;
   LLVMContextImpl::ArrayConstantsTy::LookupKey Lookup;
@@ -2639,6 +2671,7 @@ void ConstantStruct::replaceUsesOfWithOnConstant(Value *From, Value *To,
 
   unsigned OperandToUpdate = U-OperandList;
   assert(getOperand(OperandToUpdate) == From && "ReplaceAllUsesWith broken!");
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
 
   SmallVector<Constant*, 8> Values;
   LLVMContextImpl::StructConstantsTy::LookupKey Lookup;
@@ -19,6 +19,7 @@ using namespace llvm;
 
 MDNode *DebugLoc::getScope(const LLVMContext &Ctx) const {
   if (ScopeIdx == 0) return 0;
+  UniquingGuard Guard(Ctx.pImpl->ConstantsLock); // @LOCALMOD
   
   if (ScopeIdx > 0) {
     // Positive ScopeIdx is an index into ScopeRecords, which has no inlined-at
@@ -38,6 +39,7 @@ MDNode *DebugLoc::getInlinedAt(const LLVMContext &Ctx) const {
   // Positive ScopeIdx is an index into ScopeRecords, which has no inlined-at
   // position specified.  Zero is invalid.
   if (ScopeIdx >= 0) return 0;
+  UniquingGuard Guard(Ctx.pImpl->ConstantsLock); // @LOCALMOD
   
   // Otherwise, the index is in the ScopeInlinedAtRecords array.
   assert(unsigned(-ScopeIdx) <= Ctx.pImpl->ScopeInlinedAtRecords.size() &&
@@ -52,6 +54,7 @@ void DebugLoc::getScopeAndInlinedAt(MDNode *&Scope, MDNode *&IA,
     Scope = IA = 0;
     return;
   }
+  UniquingGuard Guard(Ctx.pImpl->ConstantsLock); // @LOCALMOD
   
   if (ScopeIdx > 0) {
     // Positive ScopeIdx is an index into ScopeRecords, which has no inlined-at
@@ -160,6 +163,7 @@ unsigned DenseMapInfo<DebugLoc>::getHashValue(const DebugLoc &Key) {
 
 int LLVMContextImpl::getOrAddScopeRecordIdxEntry(MDNode *Scope,
                                                  int ExistingIdx) {
+  UniquingGuard Guard(this->ConstantsLock); // @LOCALMOD
   // If we already have an entry for this scope, return it.
   int &Idx = ScopeRecordIdx[Scope];
   if (Idx) return Idx;
@@ -183,6 +187,7 @@ int LLVMContextImpl::getOrAddScopeRecordIdxEntry(MDNode *Scope,
 
 int LLVMContextImpl::getOrAddScopeInlinedAtIdxEntry(MDNode *Scope, MDNode *IA,
                                                     int ExistingIdx) {
+  UniquingGuard Guard(this->ConstantsLock); // @LOCALMOD
   // If we already have an entry, return it.
   int &Idx = ScopeInlinedAtIdx[std::make_pair(Scope, IA)];
   if (Idx) return Idx;
@@ -31,6 +31,7 @@ InlineAsm *InlineAsm::get(FunctionType *Ty, StringRef AsmString,
   InlineAsmKeyType Key(AsmString, Constraints, hasSideEffects, isAlignStack,
                        asmDialect);
   LLVMContextImpl *pImpl = Ty->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   return pImpl->InlineAsms.getOrCreate(PointerType::getUnqual(Ty), Key);
 }
 
@@ -48,6 +49,7 @@ InlineAsm::InlineAsm(PointerType *Ty, const std::string &asmString,
 }
 
 void InlineAsm::destroyConstant() {
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getType()->getContext().pImpl->InlineAsms.remove(this);
   delete this;
 }
@@ -67,13 +67,28 @@ LLVMContext::LLVMContext() : pImpl(new LLVMContextImpl(*this)) {
 LLVMContext::~LLVMContext() { delete pImpl; }
 
 void LLVMContext::addModule(Module *M) {
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   pImpl->OwnedModules.insert(M);
 }
 
 void LLVMContext::removeModule(Module *M) {
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   pImpl->OwnedModules.erase(M);
 }
 
+// @LOCALMOD-BEGIN
+void LLVMContext::enableThreadSafeUniquing() {
+  if (isThreadSafeUniquing())
+    return;
+  pImpl->ConstantsLock = new sys::Mutex(/*recursive=*/true);
+  pImpl->TypesLock = new sys::Mutex(/*recursive=*/true);
+}
+
+bool LLVMContext::isThreadSafeUniquing() const {
+  return pImpl->ConstantsLock != 0;
+}
+// @LOCALMOD-END
+
 //===----------------------------------------------------------------------===//
 // Recoverable Backend Errors
 //===----------------------------------------------------------------------===//
@@ -151,6 +166,7 @@ static bool isValidName(StringRef MDName) {
 /// getMDKindID - Return a unique non-zero ID for the specified metadata kind.
 unsigned LLVMContext::getMDKindID(StringRef Name) const {
   assert(isValidName(Name) && "Invalid MDNode name");
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
 
   // If this is new, assign it its ID.
   return
@@ -161,6 +177,7 @@ unsigned LLVMContext::getMDKindID(StringRef Name) const {
 /// getHandlerNames - Populate client supplied smallvector using custome
 /// metadata name and ID.
 void LLVMContext::getMDKindNames(SmallVectorImpl<StringRef> &Names) const {
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   Names.resize(pImpl->CustomMDKindNames.size());
   for (StringMap<unsigned>::const_iterator I = pImpl->CustomMDKindNames.begin(),
        E = pImpl->CustomMDKindNames.end(); I != E; ++I)
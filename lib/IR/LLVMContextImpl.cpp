@@ -38,6 +38,8 @@ LLVMContextImpl::LLVMContextImpl(LLVMContext &C)
   InlineAsmDiagHandler = 0;
   InlineAsmDiagContext = 0;
   NamedStructTypesUniqueID = 0;
+  ConstantsLock = 0; // @LOCALMOD
+  TypesLock = 0; // @LOCALMOD
 }
 
 namespace {
@@ -132,6 +134,11 @@ LLVMContextImpl::~LLVMContextImpl() {
 
   // Destroy MDStrings.
   DeleteContainerSeconds(MDStringCache);
+
+  // @LOCALMOD-BEGIN
+  delete ConstantsLock;
+  delete TypesLock;
+  // @LOCALMOD-END
 }
 
 // ConstantsContext anchors
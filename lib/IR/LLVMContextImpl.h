@@ -30,6 +30,7 @@
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Metadata.h"
+#include "llvm/Support/Mutex.h" // @LOCALMOD
 #include "llvm/Support/ValueHandle.h"
 #include <vector>
 
@@ -230,6 +231,24 @@ public:
   virtual void allUsesReplacedWith(Value *VNew);
 };
   
+// @LOCALMOD-BEGIN
+/// UniquingGuard - Holds a uniquing lock of a context for its lifetime, if the
+/// context has one (see LLVMContext::enableThreadSafeUniquing). The locks are
+/// recursive, since creating a constant may create other constants.
+class UniquingGuard {
+  sys::Mutex *Lock;
+public:
+  explicit UniquingGuard(sys::Mutex *Lock) : Lock(Lock) {
+    if (Lock)
+      Lock->acquire();
+  }
+  ~UniquingGuard() {
+    if (Lock)
+      Lock->release();
+  }
+};
+// @LOCALMOD-END
+
 class LLVMContextImpl {
 public:
   /// OwnedModules - The set of modules instantiated in this context, and which
@@ -360,6 +379,16 @@ public:
   typedef DenseMap<const Function *, ReturnInst *> PrefixDataMapTy;
   PrefixDataMapTy PrefixDataMap;
 
+  // @LOCALMOD-BEGIN
+  /// ConstantsLock - Guards the constant, inline asm, metadata and attribute
+  /// uniquing tables when the context is shared between threads.
+  /// TypesLock - Guards the type tables and TypeAllocator. It may be taken
+  /// while holding ConstantsLock, but not the other way around. Both are
+  /// null for contexts used by a single thread.
+  sys::Mutex *ConstantsLock;
+  sys::Mutex *TypesLock;
+  // @LOCALMOD-END
+
   int getOrAddScopeRecordIdxEntry(MDNode *N, int ExistingIdx);
   int getOrAddScopeInlinedAtIdxEntry(MDNode *Scope, MDNode *IA,int ExistingIdx);
   
@@ -24,6 +24,7 @@
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/PassNameParser.h"
 #include "llvm/Support/Timer.h"
+#include "llvm/Support/Trace.h" // @LOCALMOD
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <map>
@@ -1307,6 +1308,7 @@ bool BBPassManager::runOnFunction(Function &F) {
         // If the pass crashes, remember this.
         PassManagerPrettyStackEntry X(BP, *I);
         TimeRegion PassTimer(getPassTimer(BP));
+        TraceScope PassTrace("pass", BP->getPassName()); // @LOCALMOD
 
         LocalChanged |= BP->runOnBasicBlock(*I);
       }
@@ -1518,6 +1520,7 @@ bool FPPassManager::runOnFunction(Function &F) {
     return false;
 
   bool Changed = false;
+  TraceScope FunctionTrace("function", F.getName()); // @LOCALMOD
 
   // Collect inherited analysis from Module level pass manager.
   populateInheritedAnalysis(TPM->activeStack);
@@ -1534,6 +1537,7 @@ bool FPPassManager::runOnFunction(Function &F) {
     {
       PassManagerPrettyStackEntry X(FP, F);
       TimeRegion PassTimer(getPassTimer(FP));
+      TraceScope PassTrace("pass", FP->getPassName()); // @LOCALMOD
 
       LocalChanged |= FP->runOnFunction(F);
     }
@@ -1612,6 +1616,7 @@ MPPassManager::runOnModule(Module &M) {
     {
       PassManagerPrettyStackEntry X(MP, M);
       TimeRegion PassTimer(getPassTimer(MP));
+      TraceScope PassTrace("pass", MP->getPassName()); // @LOCALMOD
 
       LocalChanged |= MP->runOnModule(M);
     }
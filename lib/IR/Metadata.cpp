@@ -37,6 +37,7 @@ MDString::MDString(LLVMContext &C)
 
 MDString *MDString::get(LLVMContext &Context, StringRef Str) {
   LLVMContextImpl *pImpl = Context.pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   StringMapEntry<Value*> &Entry =
     pImpl->MDStringCache.GetOrCreateValue(Str);
   Value *&S = Entry.getValue();
@@ -134,6 +135,7 @@ MDNode::~MDNode() {
   assert((getSubclassDataFromValue() & DestroyFlag) != 0 &&
          "Not being destroyed through destroy()?");
   LLVMContextImpl *pImpl = getType()->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   if (isNotUniqued()) {
     pImpl->NonUniquedMDNodes.erase(this);
   } else {
@@ -217,6 +219,7 @@ static bool isFunctionLocalValue(Value *V) {
 MDNode *MDNode::getMDNode(LLVMContext &Context, ArrayRef<Value*> Vals,
                           FunctionLocalness FL, bool Insert) {
   LLVMContextImpl *pImpl = Context.pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
 
   // Add all the operand pointers. Note that we don't have to add the
   // isFunctionLocal bit because that's implied by the operands.
@@ -321,6 +324,7 @@ void MDNode::Profile(FoldingSetNodeID &ID) const {
 void MDNode::setIsNotUniqued() {
   setValueSubclassData(getSubclassDataFromValue() | NotUniquedBit);
   LLVMContextImpl *pImpl = getType()->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
   pImpl->NonUniquedMDNodes.insert(this);
 }
 
@@ -357,6 +361,7 @@ void MDNode::replaceOperand(MDNodeOperand *Op, Value *To) {
   if (isNotUniqued()) return;
 
   LLVMContextImpl *pImpl = getType()->getContext().pImpl;
+  UniquingGuard Guard(pImpl->ConstantsLock); // @LOCALMOD
 
   // Remove "this" from the context map.  FoldingSet doesn't have to reprofile
   // this node to remove it, so we don't care what state the operands are in.
@@ -594,7 +599,8 @@ void Instruction::setMetadata(unsigned KindID, MDNode *Node) {
     DbgLoc = DebugLoc::getFromDILocation(Node);
     return;
   }
-  
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
+
   // Handle the case when we're adding/updating metadata on an instruction.
   if (Node) {
     LLVMContextImpl::MDMapTy &Info = getContext().pImpl->MetadataStore[this];
@@ -648,7 +654,8 @@ MDNode *Instruction::getMetadataImpl(unsigned KindID) const {
     return DbgLoc.getAsMDNode(getContext());
   
   if (!hasMetadataHashEntry()) return 0;
-  
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
+
   LLVMContextImpl::MDMapTy &Info = getContext().pImpl->MetadataStore[this];
   assert(!Info.empty() && "bit out of sync with hash table");
 
@@ -669,7 +676,8 @@ void Instruction::getAllMetadataImpl(SmallVectorImpl<std::pair<unsigned,
                                     DbgLoc.getAsMDNode(getContext())));
     if (!hasMetadataHashEntry()) return;
   }
-  
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
+
   assert(hasMetadataHashEntry() &&
          getContext().pImpl->MetadataStore.count(this) &&
          "Shouldn't have called this");
@@ -688,6 +696,7 @@ void Instruction::
 getAllMetadataOtherThanDebugLocImpl(SmallVectorImpl<std::pair<unsigned,
                                     MDNode*> > &Result) const {
   Result.clear();
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   assert(hasMetadataHashEntry() &&
          getContext().pImpl->MetadataStore.count(this) &&
          "Shouldn't have called this");
@@ -705,6 +714,7 @@ getAllMetadataOtherThanDebugLocImpl(SmallVectorImpl<std::pair<unsigned,
 /// this instruction.
 void Instruction::clearMetadataHashEntries() {
   assert(hasMetadataHashEntry() && "Caller should check");
+  UniquingGuard Guard(getContext().pImpl->ConstantsLock); // @LOCALMOD
   getContext().pImpl->MetadataStore.erase(this);
   setHasMetadataHashEntry(false);
 }
@@ -15,6 +15,7 @@
 
 #include "llvm/Pass.h"
 #include "llvm/Assembly/PrintModulePass.h"
+#include "llvm/IR/Function.h" // @LOCALMOD
 #include "llvm/PassRegistry.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/PassNameParser.h"
@@ -137,6 +138,18 @@ PassManagerType FunctionPass::getPotentialPassManagerType() const {
   return PMT_FunctionPassManager;
 }
 
+// @LOCALMOD-BEGIN
+bool FunctionPass::skipOptnoneFunction(const Function &F) const {
+  if (F.getAttributes().hasAttribute(AttributeSet::FunctionIndex,
+                                     Attribute::OptimizeNone)) {
+    DEBUG(dbgs() << "Skipping pass '" << getPassName()
+          << "' on function " << F.getName() << "\n");
+    return true;
+  }
+  return false;
+}
+// @LOCALMOD-END
+
 //===----------------------------------------------------------------------===//
 // BasicBlockPass Implementation
 //
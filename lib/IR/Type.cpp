@@ -317,6 +317,7 @@ IntegerType *IntegerType::get(LLVMContext &C, unsigned NumBits) {
     break;
   }
   
+  UniquingGuard Guard(C.pImpl->TypesLock); // @LOCALMOD
   IntegerType *&Entry = C.pImpl->IntegerTypes[NumBits];
   
   if (Entry == 0)
@@ -361,6 +362,7 @@ FunctionType::FunctionType(Type *Result, ArrayRef<Type*> Params,
 FunctionType *FunctionType::get(Type *ReturnType,
                                 ArrayRef<Type*> Params, bool isVarArg) {
   LLVMContextImpl *pImpl = ReturnType->getContext().pImpl;
+  UniquingGuard Guard(pImpl->TypesLock); // @LOCALMOD
   FunctionTypeKeyInfo::KeyTy Key(ReturnType, Params, isVarArg);
   LLVMContextImpl::FunctionTypeMap::iterator I =
     pImpl->FunctionTypes.find_as(Key);
@@ -405,6 +407,7 @@ bool FunctionType::isValidArgumentType(Type *ArgTy) {
 StructType *StructType::get(LLVMContext &Context, ArrayRef<Type*> ETypes, 
                             bool isPacked) {
   LLVMContextImpl *pImpl = Context.pImpl;
+  UniquingGuard Guard(pImpl->TypesLock); // @LOCALMOD
   AnonStructTypeKeyInfo::KeyTy Key(ETypes, isPacked);
   LLVMContextImpl::StructTypeMap::iterator I =
     pImpl->AnonStructTypes.find_as(Key);
@@ -431,6 +434,7 @@ void StructType::setBody(ArrayRef<Type*> Elements, bool isPacked) {
     setSubclassData(getSubclassData() | SCDB_Packed);
 
   unsigned NumElements = Elements.size();
+  UniquingGuard Guard(getContext().pImpl->TypesLock); // @LOCALMOD
   Type **Elts = getContext().pImpl->TypeAllocator.Allocate<Type*>(NumElements);
   memcpy(Elts, Elements.data(), sizeof(Elements[0]) * NumElements);
   
@@ -440,6 +444,7 @@ void StructType::setBody(ArrayRef<Type*> Elements, bool isPacked) {
 
 void StructType::setName(StringRef Name) {
   if (Name == getName()) return;
+  UniquingGuard Guard(getContext().pImpl->TypesLock); // @LOCALMOD
 
   StringMap<StructType *> &SymbolTable = getContext().pImpl->NamedStructTypes;
   typedef StringMap<StructType *>::MapEntryTy EntryTy;
@@ -492,6 +497,7 @@ void StructType::setName(StringRef Name) {
 // StructType Helper functions.
 
 StructType *StructType::create(LLVMContext &Context, StringRef Name) {
+  UniquingGuard Guard(Context.pImpl->TypesLock); // @LOCALMOD
   StructType *ST = new (Context.pImpl->TypeAllocator) StructType(Context);
   if (!Name.empty())
     ST->setName(Name);
@@ -616,6 +622,7 @@ bool StructType::isLayoutIdentical(StructType *Other) const {
 /// getTypeByName - Return the type with the specified name, or null if there
 /// is none by that name.
 StructType *Module::getTypeByName(StringRef Name) const {
+  UniquingGuard Guard(getContext().pImpl->TypesLock); // @LOCALMOD
   return getContext().pImpl->NamedStructTypes.lookup(Name);
 }
 
@@ -681,6 +688,7 @@ ArrayType *ArrayType::get(Type *elementType, uint64_t NumElements) {
   assert(isValidElementType(ElementType) && "Invalid type for array element!");
     
   LLVMContextImpl *pImpl = ElementType->getContext().pImpl;
+  UniquingGuard Guard(pImpl->TypesLock); // @LOCALMOD
   ArrayType *&Entry = 
     pImpl->ArrayTypes[std::make_pair(ElementType, NumElements)];
   
@@ -710,6 +718,7 @@ VectorType *VectorType::get(Type *elementType, unsigned NumElements) {
          "Elements of a VectorType must be a primitive type");
   
   LLVMContextImpl *pImpl = ElementType->getContext().pImpl;
+  UniquingGuard Guard(pImpl->TypesLock); // @LOCALMOD
   VectorType *&Entry = ElementType->getContext().pImpl
     ->VectorTypes[std::make_pair(ElementType, NumElements)];
   
@@ -732,6 +741,7 @@ PointerType *PointerType::get(Type *EltTy, unsigned AddressSpace) {
   assert(isValidElementType(EltTy) && "Invalid type for pointer element!");
   
   LLVMContextImpl *CImpl = EltTy->getContext().pImpl;
+  UniquingGuard Guard(CImpl->TypesLock); // @LOCALMOD
   
   // Since AddressSpace #0 is the common case, we special case it.
   PointerType *&Entry = AddressSpace == 0 ? CImpl->PointerTypes[EltTy]
@@ -310,6 +310,24 @@ void Value::replaceAllUsesWith(Value *New) {
   if (HasValueHandle)
     ValueHandleBase::ValueIsRAUWd(this, New);
 
+  // @LOCALMOD-BEGIN
+  // Only constants and basic blocks (through blockaddress) can be used by
+  // non-global constants.  Any other value can hand its uses over directly,
+  // without finding each use's user or unlinking the uses one at a time.
+  // The uses end up on New's list in the same order as with Use::set().
+  if (!isa<Constant>(this) && !isa<BasicBlock>(this)) {
+    Use *U = UseList;
+    UseList = 0;
+    while (U) {
+      Use *Next = U->Next;
+      U->Val = New;
+      U->addToList(&New->UseList);
+      U = Next;
+    }
+    return;
+  }
+  // @LOCALMOD-END
+
   while (!use_empty()) {
     Use &U = *UseList;
     // Must handle Constants specially, we cannot call replaceUsesOfWith on a
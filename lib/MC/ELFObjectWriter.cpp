@@ -49,11 +49,15 @@ class ELFObjectWriter : public MCObjectWriter {
     static bool isLocal(const MCSymbolData &Data, bool isSignature,
                         bool isUsedInReloc);
     static bool IsELFMetaDataSection(const MCSectionData &SD);
-    static uint64_t DataSectionSize(const MCSectionData &SD);
-    static uint64_t GetSectionFileSize(const MCAsmLayout &Layout,
-                                       const MCSectionData &SD);
-    static uint64_t GetSectionAddressSize(const MCAsmLayout &Layout,
-                                          const MCSectionData &SD);
+    // @LOCALMOD-BEGIN
+    // Not static: relocation and string table sections are sized from the
+    // writer's own tables rather than from fragments.
+    uint64_t DataSectionSize(const MCSectionData &SD) const;
+    uint64_t GetSectionFileSize(const MCAsmLayout &Layout,
+                                const MCSectionData &SD) const;
+    uint64_t GetSectionAddressSize(const MCAsmLayout &Layout,
+                                   const MCSectionData &SD) const;
+    // @LOCALMOD-END
 
     void WriteDataSectionData(MCAssembler &Asm,
                               const MCAsmLayout &Layout,
@@ -87,6 +91,15 @@ class ELFObjectWriter : public MCObjectWriter {
 
     llvm::DenseMap<const MCSectionData*,
                    std::vector<ELFRelocationEntry> > Relocations;
+    // @LOCALMOD-BEGIN
+    // Map from a relocation section to the section whose relocations it
+    // holds. Relocation entries are encoded straight to the output stream
+    // when the relocation section is written, instead of being copied into
+    // an MCDataFragment first.
+    DenseMap<const MCSectionData*, const MCSectionData*> RelocationSource;
+    // The .strtab section, written straight from StringTable.
+    const MCSectionData *StrtabSD;
+    // @LOCALMOD-END
     DenseMap<const MCSection*, uint64_t> SectionStringTableIndex;
 
     /// @}
@@ -152,7 +165,7 @@ class ELFObjectWriter : public MCObjectWriter {
                     raw_ostream &_OS, bool IsLittleEndian)
       : MCObjectWriter(_OS, IsLittleEndian),
         TargetObjectWriter(MOTW),
-        NeedsGOT(false), NeedsSymtabShndx(false) {
+        NeedsGOT(false), NeedsSymtabShndx(false), StrtabSD(0) { // @LOCALMOD
     }
 
     virtual ~ELFObjectWriter();
@@ -316,9 +329,10 @@ class ELFObjectWriter : public MCObjectWriter {
                           uint64_t Size, uint32_t Link, uint32_t Info,
                           uint64_t Alignment, uint64_t EntrySize);
 
-    void WriteRelocationsFragment(const MCAssembler &Asm,
-                                  MCDataFragment *F,
-                                  const MCSectionData *SD);
+    // @LOCALMOD-BEGIN
+    void WriteRelocationEntries(const MCAssembler &Asm,
+                                const MCSectionData *SD);
+    // @LOCALMOD-END
 
     virtual bool
     IsSymbolRefDifferenceFullyResolvedImpl(const MCAssembler &Asm,
@@ -1051,8 +1065,14 @@ void ELFObjectWriter::WriteRelocations(MCAssembler &Asm, MCAsmLayout &Layout,
     MCSectionData &RelaSD = Asm.getOrCreateSectionData(*RelaSection);
     RelaSD.setAlignment(is64Bit() ? 8 : 4);
 
-    MCDataFragment *F = new MCDataFragment(&RelaSD);
-    WriteRelocationsFragment(Asm, F, &*it);
+    // @LOCALMOD-BEGIN
+    // Sort the relocation entries now so that the section size is known, but
+    // defer encoding them until the section is written.
+    // Most targets just sort by r_offset, but some (e.g., MIPS) have
+    // additional constraints.
+    TargetObjectWriter->sortRelocs(Asm, Relocations[&SD]);
+    RelocationSource[&RelaSD] = &SD;
+    // @LOCALMOD-END
   }
 }
 
@@ -1074,15 +1094,11 @@ void ELFObjectWriter::WriteSecHdrEntry(uint32_t Name, uint32_t Type,
   WriteWord(EntrySize); // sh_entsize
 }
 
-void ELFObjectWriter::WriteRelocationsFragment(const MCAssembler &Asm,
-                                               MCDataFragment *F,
-                                               const MCSectionData *SD) {
+// @LOCALMOD-BEGIN
+void ELFObjectWriter::WriteRelocationEntries(const MCAssembler &Asm,
+                                             const MCSectionData *SD) {
   std::vector<ELFRelocationEntry> &Relocs = Relocations[SD];
 
-  // Sort the relocation entries. Most targets just sort by r_offset, but some
-  // (e.g., MIPS) have additional constraints.
-  TargetObjectWriter->sortRelocs(Asm, Relocs);
-
   for (unsigned i = 0, e = Relocs.size(); i != e; ++i) {
     ELFRelocationEntry entry = Relocs[e - i - 1];
 
@@ -1093,34 +1109,39 @@ void ELFObjectWriter::WriteRelocationsFragment(const MCAssembler &Asm,
     else
       entry.Index += FileSymbolData.size() + LocalSymbolData.size();
     if (is64Bit()) {
-      String64(*F, entry.r_offset);
+      Write64(entry.r_offset);
       if (TargetObjectWriter->isN64()) {
-        String32(*F, entry.Index);
+        Write32(entry.Index);
 
-        String8(*F, TargetObjectWriter->getRSsym(entry.Type));
-        String8(*F, TargetObjectWriter->getRType3(entry.Type));
-        String8(*F, TargetObjectWriter->getRType2(entry.Type));
-        String8(*F, TargetObjectWriter->getRType(entry.Type));
+        Write8(TargetObjectWriter->getRSsym(entry.Type));
+        Write8(TargetObjectWriter->getRType3(entry.Type));
+        Write8(TargetObjectWriter->getRType2(entry.Type));
+        Write8(TargetObjectWriter->getRType(entry.Type));
       }
       else {
         struct ELF::Elf64_Rela ERE64;
         ERE64.setSymbolAndType(entry.Index, entry.Type);
-        String64(*F, ERE64.r_info);
+        Write64(ERE64.r_info);
       }
       if (hasRelocationAddend())
-        String64(*F, entry.r_addend);
+        Write64(entry.r_addend);
     } else {
-      String32(*F, entry.r_offset);
+      Write32(entry.r_offset);
 
       struct ELF::Elf32_Rela ERE32;
       ERE32.setSymbolAndType(entry.Index, entry.Type);
-      String32(*F, ERE32.r_info);
+      Write32(ERE32.r_info);
 
       if (hasRelocationAddend())
-        String32(*F, entry.r_addend);
+        Write32(entry.r_addend);
     }
   }
+
+  // The entries are not needed once they are in the output; release them so
+  // that only one section's relocations are live at a time.
+  std::vector<ELFRelocationEntry>().swap(Relocs);
 }
+// @LOCALMOD-END
 
 static int compareBySuffix(const MCSectionELF *const *a,
                            const MCSectionELF *const *b) {
@@ -1192,8 +1213,10 @@ void ELFObjectWriter::CreateMetadataSections(MCAssembler &Asm,
   }
   WriteSymbolTable(F, ShndxF, Asm, Layout, SectionIndexMap);
 
-  F = new MCDataFragment(&StrtabSD);
-  F->getContents().append(StringTable.begin(), StringTable.end());
+  // @LOCALMOD-BEGIN
+  // .strtab is written directly from StringTable; no fragment copy.
+  this->StrtabSD = &StrtabSD;
+  // @LOCALMOD-END
 
   F = new MCDataFragment(&ShstrtabSD);
 
@@ -1390,7 +1413,22 @@ bool ELFObjectWriter::IsELFMetaDataSection(const MCSectionData &SD) {
     !SD.getSection().isVirtualSection();
 }
 
-uint64_t ELFObjectWriter::DataSectionSize(const MCSectionData &SD) {
+uint64_t ELFObjectWriter::DataSectionSize(const MCSectionData &SD) const {
+  // @LOCALMOD-BEGIN
+  if (&SD == StrtabSD)
+    return StringTable.size();
+  DenseMap<const MCSectionData*, const MCSectionData*>::const_iterator RI =
+    RelocationSource.find(&SD);
+  if (RI != RelocationSource.end()) {
+    const MCSectionELF &Section =
+      static_cast<const MCSectionELF&>(SD.getSection());
+    DenseMap<const MCSectionData*,
+             std::vector<ELFRelocationEntry> >::const_iterator I =
+      Relocations.find(RI->second);
+    assert(I != Relocations.end() && "Relocation section without entries");
+    return I->second.size() * Section.getEntrySize();
+  }
+  // @LOCALMOD-END
   uint64_t Ret = 0;
   for (MCSectionData::const_iterator i = SD.begin(), e = SD.end(); i != e;
        ++i) {
@@ -1402,14 +1440,14 @@ uint64_t ELFObjectWriter::DataSectionSize(const MCSectionData &SD) {
 }
 
 uint64_t ELFObjectWriter::GetSectionFileSize(const MCAsmLayout &Layout,
-                                             const MCSectionData &SD) {
+                                             const MCSectionData &SD) const {
   if (IsELFMetaDataSection(SD))
     return DataSectionSize(SD);
   return Layout.getSectionFileSize(&SD);
 }
 
 uint64_t ELFObjectWriter::GetSectionAddressSize(const MCAsmLayout &Layout,
-                                                const MCSectionData &SD) {
+                                               const MCSectionData &SD) const {
   if (IsELFMetaDataSection(SD))
     return DataSectionSize(SD);
   return Layout.getSectionAddressSize(&SD);
@@ -1423,6 +1461,19 @@ void ELFObjectWriter::WriteDataSectionData(MCAssembler &Asm,
   uint64_t Padding = OffsetToAlignment(OS.tell(), SD.getAlignment());
   WriteZeros(Padding);
 
+  // @LOCALMOD-BEGIN
+  if (&SD == StrtabSD) {
+    WriteBytes(StringTable.str());
+    return;
+  }
+  DenseMap<const MCSectionData*, const MCSectionData*>::const_iterator RI =
+    RelocationSource.find(&SD);
+  if (RI != RelocationSource.end()) {
+    WriteRelocationEntries(Asm, RI->second);
+    return;
+  }
+  // @LOCALMOD-END
+
   if (IsELFMetaDataSection(SD)) {
     for (MCSectionData::const_iterator i = SD.begin(), e = SD.end(); i != e;
          ++i) {
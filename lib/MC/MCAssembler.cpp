@@ -28,6 +28,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/TargetRegistry.h"
+#include "llvm/Support/Trace.h" // @LOCALMOD
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
@@ -52,6 +53,8 @@ STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(RelaxCandidates,
+          "Number of fragments considered for relaxation"); // @LOCALMOD
 }
 }
 
@@ -760,6 +763,7 @@ uint64_t MCAssembler::handleFixup(const MCAsmLayout &Layout,
  }
 
 void MCAssembler::Finish() {
+  TraceScope FinishTrace("mc", "MCAssembler::Finish"); // @LOCALMOD
   DEBUG_WITH_TYPE("mc-dump", {
       llvm::errs() << "assembler backend - pre-layout\n--\n";
       dump(); });
@@ -789,9 +793,18 @@ void MCAssembler::Finish() {
       iFrag->setLayoutOrder(FragmentIndex++);
   }
 
-  // Layout until everything fits.
-  while (layoutOnce(Layout))
-    continue;
+  // @LOCALMOD-BEGIN
+  // Layout until everything fits. Only fragments which can change size are
+  // revisited on each pass; plain data, alignment and fill fragments are laid
+  // out on demand when a fixup is evaluated.
+  {
+    TraceScope LayoutTrace("mc", "layout");
+    std::vector<RelaxCandidateList> Candidates;
+    collectRelaxCandidates(Layout, Candidates);
+    while (layoutOnce(Layout, Candidates))
+      continue;
+  }
+  // @LOCALMOD-END
 
   DEBUG_WITH_TYPE("mc-dump", {
       llvm::errs() << "assembler backend - post-relaxation\n--\n";
@@ -829,7 +842,12 @@ void MCAssembler::Finish() {
   }
 
   // Write the object file.
-  getWriter().WriteObject(*this, Layout);
+  // @LOCALMOD-BEGIN
+  {
+    TraceScope WriteTrace("mc", "WriteObject");
+    getWriter().WriteObject(*this, Layout);
+  }
+  // @LOCALMOD-END
 
   stats::ObjectBytes += OS.tell() - StartOffset;
 }
@@ -946,41 +964,83 @@ bool MCAssembler::relaxDwarfCallFrameFragment(MCAsmLayout &Layout,
   return OldSize != Data.size();
 }
 
-bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSectionData &SD) {
+// @LOCALMOD-BEGIN
+void MCAssembler::collectRelaxCandidates(
+    const MCAsmLayout &Layout, std::vector<RelaxCandidateList> &Candidates) {
+  unsigned NumSections = Layout.getSectionOrder().size();
+  Candidates.clear();
+  Candidates.resize(NumSections);
+  for (unsigned i = 0; i != NumSections; ++i) {
+    MCSectionData *SD = Layout.getSectionOrder()[i];
+    RelaxCandidateList &List = Candidates[i];
+    for (MCSectionData::iterator I = SD->begin(), IE = SD->end(); I != IE;
+         ++I) {
+      switch (I->getKind()) {
+      default:
+        break;
+      case MCFragment::FT_Relaxable:
+        assert(!getRelaxAll() &&
+               "Did not expect a MCRelaxableFragment in RelaxAll mode");
+        // Instructions which are already in their largest form never change
+        // size; leave them to the final fixup pass.
+        if (getBackend().mayNeedRelaxation(
+                cast<MCRelaxableFragment>(I)->getInst()))
+          List.push_back(I);
+        break;
+      case MCFragment::FT_Dwarf:
+      case MCFragment::FT_DwarfFrame:
+      case MCFragment::FT_LEB:
+        List.push_back(I);
+        break;
+      }
+    }
+    stats::RelaxCandidates += List.size();
+  }
+}
+
+bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout,
+                                    RelaxCandidateList &Candidates) {
   // Holds the first fragment which needed relaxing during this layout. It will
   // remain NULL if none were relaxed.
   // When a fragment is relaxed, all the fragments following it should get
   // invalidated because their offset is going to change.
   MCFragment *FirstRelaxedFragment = NULL;
 
-  // Attempt to relax all the fragments in the section.
-  for (MCSectionData::iterator I = SD.begin(), IE = SD.end(); I != IE; ++I) {
-    // Check if this is a fragment that needs relaxation.
+  // Attempt to relax all the candidate fragments in the section, compacting
+  // away relaxable instructions which have reached their final form.
+  unsigned Kept = 0;
+  for (unsigned i = 0, e = Candidates.size(); i != e; ++i) {
+    MCFragment *F = Candidates[i];
     bool RelaxedFrag = false;
-    switch(I->getKind()) {
+    bool Keep = true;
+    switch(F->getKind()) {
     default:
+      llvm_unreachable("Unexpected relaxation candidate");
+    case MCFragment::FT_Relaxable: {
+      MCRelaxableFragment &RF = *cast<MCRelaxableFragment>(F);
+      RelaxedFrag = relaxInstruction(Layout, RF);
+      Keep = !RelaxedFrag || getBackend().mayNeedRelaxation(RF.getInst());
       break;
-    case MCFragment::FT_Relaxable:
-      assert(!getRelaxAll() &&
-             "Did not expect a MCRelaxableFragment in RelaxAll mode");
-      RelaxedFrag = relaxInstruction(Layout, *cast<MCRelaxableFragment>(I));
-      break;
+    }
     case MCFragment::FT_Dwarf:
       RelaxedFrag = relaxDwarfLineAddr(Layout,
-                                       *cast<MCDwarfLineAddrFragment>(I));
+                                       *cast<MCDwarfLineAddrFragment>(F));
       break;
     case MCFragment::FT_DwarfFrame:
       RelaxedFrag =
         relaxDwarfCallFrameFragment(Layout,
-                                    *cast<MCDwarfCallFrameFragment>(I));
+                                    *cast<MCDwarfCallFrameFragment>(F));
       break;
     case MCFragment::FT_LEB:
-      RelaxedFrag = relaxLEB(Layout, *cast<MCLEBFragment>(I));
+      RelaxedFrag = relaxLEB(Layout, *cast<MCLEBFragment>(F));
       break;
     }
     if (RelaxedFrag && !FirstRelaxedFragment)
-      FirstRelaxedFragment = I;
+      FirstRelaxedFragment = F;
+    if (Keep)
+      Candidates[Kept++] = F;
   }
+  Candidates.resize(Kept);
   if (FirstRelaxedFragment) {
     Layout.invalidateFragmentsFrom(FirstRelaxedFragment);
     return true;
@@ -988,18 +1048,20 @@ bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSectionData &SD) {
   return false;
 }
 
-bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
+bool MCAssembler::layoutOnce(MCAsmLayout &Layout,
+                             std::vector<RelaxCandidateList> &Candidates) {
   ++stats::RelaxationSteps;
 
   bool WasRelaxed = false;
-  for (iterator it = begin(), ie = end(); it != ie; ++it) {
-    MCSectionData &SD = *it;
-    while (layoutSectionOnce(Layout, SD))
+  for (unsigned i = 0, e = Candidates.size(); i != e; ++i) {
+    RelaxCandidateList &List = Candidates[i];
+    while (!List.empty() && layoutSectionOnce(Layout, List))
       WasRelaxed = true;
   }
 
   return WasRelaxed;
 }
+// @LOCALMOD-END
 
 void MCAssembler::finishLayout(MCAsmLayout &Layout) {
   // The layout is done. Mark every fragment as valid.
@@ -11,13 +11,32 @@
 //
 //===----------------------------------------------------------------------===//
 
+// @LOCALMOD-BEGIN
+#define DEBUG_TYPE "allocator"
+// @LOCALMOD-END
 #include "llvm/Support/Allocator.h"
+// @LOCALMOD-BEGIN
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Config/config.h"
+// @LOCALMOD-END
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/DataTypes.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Mutex.h" // @LOCALMOD
 #include "llvm/Support/Recycler.h"
 #include "llvm/Support/raw_ostream.h"
 #include <cstring>
+// @LOCALMOD-BEGIN
+#if defined(LLVM_ENABLE_THREADS) && LLVM_ENABLE_THREADS != 0 && \
+    defined(HAVE_PTHREAD_H) && defined(HAVE_PTHREAD_GETSPECIFIC)
+#define LLVM_SLAB_CACHE_PTHREAD 1
+#include <pthread.h>
+#endif
+#ifdef LLVM_ON_UNIX
+#include <sys/mman.h>
+#endif
+// @LOCALMOD-END
 
 namespace llvm {
 
@@ -173,18 +192,291 @@ void BumpPtrAllocator::PrintStats() const {
 
 SlabAllocator::~SlabAllocator() { }
 
+// @LOCALMOD-BEGIN
+STATISTIC(NumSlabsMalloced, "Number of slabs allocated with malloc");
+STATISTIC(NumSlabsRecycled, "Number of slabs reused from a thread's cache");
+STATISTIC(NumSlabsCached, "Number of freed slabs kept in a thread's cache");
+STATISTIC(NumHugePageRegions, "Number of 2MB regions mapped for slabs");
+STATISTIC(NumHugePageSlabs, "Number of slabs carved from 2MB regions");
+
+/// The slab allocator installed with setGlobalSlabAllocator(), if any.
+static SlabAllocator *GlobalSlabAllocator = 0;
+
+static MemSlab *mallocSlab(size_t Size) {
+  ++NumSlabsMalloced;
+  MemSlab *Slab = (MemSlab*)malloc(Size);
+  Slab->Size = Size;
+  Slab->NextPtr = 0;
+  return Slab;
+}
+
+// Slabs are cached by power-of-two size class, from 4KB to 2MB.
+static const unsigned MinSlabSizeLog2 = 12;
+static const unsigned MaxSlabSizeLog2 = 21;
+static const unsigned NumSlabSizeClasses =
+    MaxSlabSizeLog2 - MinSlabSizeLog2 + 1;
+static const size_t HugePageRegionSize = size_t(1) << MaxSlabSizeLog2;
+
+/// getSlabSizeClass - Return the size class of a slab of Size bytes, or -1
+/// if slabs of that size are not cached.
+static int getSlabSizeClass(size_t Size) {
+  if (!isPowerOf2_64(Size))
+    return -1;
+  unsigned Log2 = Log2_64(Size);
+  if (Log2 < MinSlabSizeLog2 || Log2 > MaxSlabSizeLog2)
+    return -1;
+  return Log2 - MinSlabSizeLog2;
+}
+
 MallocSlabAllocator::~MallocSlabAllocator() { }
 
 MemSlab *MallocSlabAllocator::Allocate(size_t Size) {
-  MemSlab *Slab = (MemSlab*)Allocator.Allocate(Size, 0);
+  if (GlobalSlabAllocator)
+    return GlobalSlabAllocator->Allocate(Size);
+  return mallocSlab(Size);
+}
+
+void MallocSlabAllocator::Deallocate(MemSlab *Slab) {
+  if (GlobalSlabAllocator)
+    GlobalSlabAllocator->Deallocate(Slab);
+  else
+    Allocator.Deallocate(Slab);
+}
+
+namespace {
+/// RawMallocSlabAllocator - Like MallocSlabAllocator, but never forwards to
+/// the global slab allocator, so that it can sit underneath it.
+class RawMallocSlabAllocator : public SlabAllocator {
+public:
+  virtual MemSlab *Allocate(size_t Size) LLVM_OVERRIDE {
+    return mallocSlab(Size);
+  }
+  virtual void Deallocate(MemSlab *Slab) LLVM_OVERRIDE { free(Slab); }
+};
+
+/// HugePageState - The regions and free lists of a HugePageSlabAllocator.
+struct HugePageState {
+  sys::Mutex Lock;
+  SmallPtrSet<void *, 16> Regions;
+  char *Cur;
+  char *End;
+  MemSlab *FreeLists[NumSlabSizeClasses];
+
+  HugePageState() : Cur(0), End(0) {
+    memset(FreeLists, 0, sizeof(FreeLists));
+  }
+
+  void pushFree(char *Ptr, size_t Size) {
+    MemSlab *Slab = (MemSlab*)Ptr;
+    Slab->Size = Size;
+    Slab->NextPtr = FreeLists[getSlabSizeClass(Size)];
+    FreeLists[getSlabSizeClass(Size)] = Slab;
+  }
+
+  /// newRegion - Map a new 2MB region, after putting what is left of the
+  /// current one on the free lists.  Return false if no memory is available.
+  bool newRegion() {
+    while (size_t(End - Cur) >= (size_t(1) << MinSlabSizeLog2)) {
+      size_t Size = size_t(1) << Log2_64(End - Cur);
+      pushFree(Cur, Size);
+      Cur += Size;
+    }
+    void *Region = 0;
+#ifdef LLVM_ON_UNIX
+    if (posix_memalign(&Region, HugePageRegionSize, HugePageRegionSize) != 0)
+      return false;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    madvise(Region, HugePageRegionSize, MADV_HUGEPAGE);
+#endif
+#else
+    return false;
+#endif
+    ++NumHugePageRegions;
+    Regions.insert(Region);
+    Cur = (char*)Region;
+    End = Cur + HugePageRegionSize;
+    return true;
+  }
+};
+}
+
+HugePageSlabAllocator::HugePageSlabAllocator() : Impl(new HugePageState()) {}
+
+HugePageSlabAllocator::~HugePageSlabAllocator() {
+  HugePageState *State = static_cast<HugePageState*>(Impl);
+  for (SmallPtrSet<void *, 16>::iterator I = State->Regions.begin(),
+                                         E = State->Regions.end();
+       I != E; ++I)
+    free(*I);
+  delete State;
+}
+
+MemSlab *HugePageSlabAllocator::Allocate(size_t Size) {
+  int SizeClass = getSlabSizeClass(Size);
+  if (SizeClass < 0)
+    return mallocSlab(Size);
+
+  HugePageState *State = static_cast<HugePageState*>(Impl);
+  MemSlab *Slab;
+  {
+    sys::ScopedLock L(State->Lock);
+    if ((Slab = State->FreeLists[SizeClass])) {
+      State->FreeLists[SizeClass] = Slab->NextPtr;
+    } else {
+      if (size_t(State->End - State->Cur) < Size && !State->newRegion())
+        return mallocSlab(Size);
+      Slab = (MemSlab*)State->Cur;
+      State->Cur += Size;
+      ++NumHugePageSlabs;
+    }
+  }
   Slab->Size = Size;
   Slab->NextPtr = 0;
   return Slab;
 }
 
-void MallocSlabAllocator::Deallocate(MemSlab *Slab) {
-  Allocator.Deallocate(Slab);
+void HugePageSlabAllocator::Deallocate(MemSlab *Slab) {
+  HugePageState *State = static_cast<HugePageState*>(Impl);
+  void *Region =
+      (void*)((uintptr_t)Slab & ~(uintptr_t)(HugePageRegionSize - 1));
+  {
+    sys::ScopedLock L(State->Lock);
+    if (State->Regions.count(Region)) {
+      State->pushFree((char*)Slab, Slab->Size);
+      return;
+    }
+  }
+  free(Slab);
+}
+
+namespace {
+/// SlabCache - One thread's cached slabs for a RecyclingSlabAllocator.
+struct SlabCache {
+  RecyclingSlabAllocator *Owner;
+  size_t CachedBytes;
+  MemSlab *FreeLists[NumSlabSizeClasses];
+
+  explicit SlabCache(RecyclingSlabAllocator *Owner)
+      : Owner(Owner), CachedBytes(0) {
+    memset(FreeLists, 0, sizeof(FreeLists));
+  }
+
+  ~SlabCache() {
+    for (unsigned I = 0; I != NumSlabSizeClasses; ++I) {
+      while (MemSlab *Slab = FreeLists[I]) {
+        FreeLists[I] = Slab->NextPtr;
+        Owner->getUnderlying().Deallocate(Slab);
+      }
+    }
+  }
+};
+}
+
+#ifdef LLVM_SLAB_CACHE_PTHREAD
+extern "C" {
+static void destroySlabCache(void *Cache) {
+  delete static_cast<SlabCache*>(Cache);
+}
+}
+
+static SlabCache *getSlabCache(void *Key) {
+  return static_cast<SlabCache*>(
+      pthread_getspecific(*static_cast<pthread_key_t*>(Key)));
+}
+
+static void setSlabCache(void *Key, SlabCache *Cache) {
+  pthread_setspecific(*static_cast<pthread_key_t*>(Key), Cache);
+}
+#else
+static SlabCache *getSlabCache(void *Key) {
+  return *static_cast<SlabCache**>(Key);
+}
+
+static void setSlabCache(void *Key, SlabCache *Cache) {
+  *static_cast<SlabCache**>(Key) = Cache;
+}
+#endif
+
+RecyclingSlabAllocator::RecyclingSlabAllocator(SlabAllocator &Underlying,
+                                               size_t MaxCachedBytes)
+    : Underlying(Underlying), MaxCachedBytes(MaxCachedBytes) {
+#ifdef LLVM_SLAB_CACHE_PTHREAD
+  pthread_key_t *K = new pthread_key_t;
+  int ErrorCode = pthread_key_create(K, destroySlabCache);
+  assert(ErrorCode == 0);
+  (void)ErrorCode;
+  Key = K;
+#else
+  Key = new SlabCache*(0);
+#endif
+}
+
+RecyclingSlabAllocator::~RecyclingSlabAllocator() {
+  // Caches of other threads still alive are leaked; the allocator is meant
+  // to outlive them.
+  delete getSlabCache(Key);
+  setSlabCache(Key, 0);
+#ifdef LLVM_SLAB_CACHE_PTHREAD
+  pthread_key_delete(*static_cast<pthread_key_t*>(Key));
+  delete static_cast<pthread_key_t*>(Key);
+#else
+  delete static_cast<SlabCache**>(Key);
+#endif
+}
+
+MemSlab *RecyclingSlabAllocator::Allocate(size_t Size) {
+  int SizeClass = getSlabSizeClass(Size);
+  if (SizeClass >= 0) {
+    SlabCache *Cache = getSlabCache(Key);
+    if (Cache && Cache->FreeLists[SizeClass]) {
+      MemSlab *Slab = Cache->FreeLists[SizeClass];
+      Cache->FreeLists[SizeClass] = Slab->NextPtr;
+      Cache->CachedBytes -= Size;
+      Slab->NextPtr = 0;
+      ++NumSlabsRecycled;
+      return Slab;
+    }
+  }
+  return Underlying.Allocate(Size);
+}
+
+void RecyclingSlabAllocator::Deallocate(MemSlab *Slab) {
+  int SizeClass = getSlabSizeClass(Slab->Size);
+  if (SizeClass >= 0) {
+    SlabCache *Cache = getSlabCache(Key);
+    if (!Cache) {
+      Cache = new SlabCache(this);
+      setSlabCache(Key, Cache);
+    }
+    if (Cache->CachedBytes + Slab->Size <= MaxCachedBytes) {
+      Slab->NextPtr = Cache->FreeLists[SizeClass];
+      Cache->FreeLists[SizeClass] = Slab;
+      Cache->CachedBytes += Slab->Size;
+      ++NumSlabsCached;
+      return;
+    }
+  }
+  Underlying.Deallocate(Slab);
+}
+
+void setGlobalSlabAllocator(SlabAllocator *A) {
+  assert(!GlobalSlabAllocator && "Global slab allocator already installed");
+  GlobalSlabAllocator = A;
+}
+
+void enableSlabRecycling(bool UseHugePages) {
+  if (GlobalSlabAllocator)
+    return;
+  // These live until the end of the process: bump allocators destroyed
+  // during static destruction may still return slabs to them.
+  SlabAllocator *Underlying;
+  if (UseHugePages)
+    Underlying = new HugePageSlabAllocator();
+  else
+    Underlying = new RawMallocSlabAllocator();
+  setGlobalSlabAllocator(new RecyclingSlabAllocator(*Underlying));
 }
+// @LOCALMOD-END
 
 void PrintRecyclerStats(size_t Size,
                         size_t Align,
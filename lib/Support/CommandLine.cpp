@@ -18,6 +18,7 @@
 
 #include "llvm/Support/CommandLine.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/FlatStringMap.h" // @LOCALMOD
 #include "llvm/ADT/OwningPtr.h"
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallString.h"
@@ -127,11 +128,20 @@ void OptionCategory::registerCategory()
 // Basic, shared command line option processing machinery.
 //
 
+// @LOCALMOD-BEGIN
+/// OptionMapTy - The map from option names to options used while parsing.
+/// It is built from the hundreds of registered options on every call to
+/// ParseCommandLineOptions, so it allocates its entries from one slab
+/// instead of one malloc per name.
+typedef FlatStringMap<Option*> OptionMapTy;
+// @LOCALMOD-END
+
 /// GetOptionInfo - Scan the list of registered options, turning them into data
 /// structures that are easier to handle.
+template <class MapTy> // @LOCALMOD
 static void GetOptionInfo(SmallVectorImpl<Option*> &PositionalOpts,
                           SmallVectorImpl<Option*> &SinkOpts,
-                          StringMap<Option*> &OptionsMap) {
+                          MapTy &OptionsMap) { // @LOCALMOD
   SmallVector<const char*, 16> OptionNames;
   Option *CAOpt = 0;  // The ConsumeAfter option if it exists.
   for (Option *O = RegisteredOptionList; O; O = O->getNextRegisteredOption()) {
@@ -169,6 +179,12 @@ static void GetOptionInfo(SmallVectorImpl<Option*> &PositionalOpts,
 
   // Make sure that they are in order of registration not backwards.
   std::reverse(PositionalOpts.begin(), PositionalOpts.end());
+
+  // @LOCALMOD-BEGIN
+  // The options are up to date now; do not scan them again when parsing the
+  // first argument.
+  OptionListChanged = false;
+  // @LOCALMOD-END
 }
 
 
@@ -176,7 +192,7 @@ static void GetOptionInfo(SmallVectorImpl<Option*> &PositionalOpts,
 /// command line.  If there is a value specified (after an equal sign) return
 /// that as well.  This assumes that leading dashes have already been stripped.
 static Option *LookupOption(StringRef &Arg, StringRef &Value,
-                            const StringMap<Option*> &OptionsMap) {
+                            const OptionMapTy &OptionsMap) { // @LOCALMOD
   // Reject all dashes.
   if (Arg.empty()) return 0;
 
@@ -185,13 +201,13 @@ static Option *LookupOption(StringRef &Arg, StringRef &Value,
   // If we have an equals sign, remember the value.
   if (EqualPos == StringRef::npos) {
     // Look up the option.
-    StringMap<Option*>::const_iterator I = OptionsMap.find(Arg);
+    OptionMapTy::const_iterator I = OptionsMap.find(Arg); // @LOCALMOD
     return I != OptionsMap.end() ? I->second : 0;
   }
 
   // If the argument before the = is a valid option name, we match.  If not,
   // return Arg unmolested.
-  StringMap<Option*>::const_iterator I =
+  OptionMapTy::const_iterator I = // @LOCALMOD
     OptionsMap.find(Arg.substr(0, EqualPos));
   if (I == OptionsMap.end()) return 0;
 
@@ -205,7 +221,7 @@ static Option *LookupOption(StringRef &Arg, StringRef &Value,
 /// (after an equal sign) return that as well.  This assumes that leading dashes
 /// have already been stripped.
 static Option *LookupNearestOption(StringRef Arg,
-                                   const StringMap<Option*> &OptionsMap,
+                                   const OptionMapTy &OptionsMap, // @LOCALMOD
                                    std::string &NearestString) {
   // Reject all dashes.
   if (Arg.empty()) return 0;
@@ -218,7 +234,7 @@ static Option *LookupNearestOption(StringRef Arg,
   // Find the closest match.
   Option *Best = 0;
   unsigned BestDistance = 0;
-  for (StringMap<Option*>::const_iterator it = OptionsMap.begin(),
+  for (OptionMapTy::const_iterator it = OptionsMap.begin(), // @LOCALMOD
          ie = OptionsMap.end(); it != ie; ++it) {
     Option *O = it->second;
     SmallVector<const char*, 16> OptionNames;
@@ -359,9 +375,9 @@ static inline bool isPrefixedOrGrouping(const Option *O) {
 //
 static Option *getOptionPred(StringRef Name, size_t &Length,
                              bool (*Pred)(const Option*),
-                             const StringMap<Option*> &OptionsMap) {
+                             const OptionMapTy &OptionsMap) { // @LOCALMOD
 
-  StringMap<Option*>::const_iterator OMI = OptionsMap.find(Name);
+  OptionMapTy::const_iterator OMI = OptionsMap.find(Name); // @LOCALMOD
 
   // Loop while we haven't found an option and Name still has at least two
   // characters in it (so that the next iteration will not be the empty
@@ -382,9 +398,11 @@ static Option *getOptionPred(StringRef Name, size_t &Length,
 /// with at least one '-') does not fully match an available option.  Check to
 /// see if this is a prefix or grouped option.  If so, split arg into output an
 /// Arg/Value pair and return the Option to parse it with.
+// @LOCALMOD-BEGIN
 static Option *HandlePrefixedOrGroupedOption(StringRef &Arg, StringRef &Value,
                                              bool &ErrorParsing,
-                                         const StringMap<Option*> &OptionsMap) {
+                                             const OptionMapTy &OptionsMap) {
+// @LOCALMOD-END
   if (Arg.size() == 1) return 0;
 
   // Do the lookup!
@@ -717,7 +735,7 @@ void cl::ParseCommandLineOptions(int argc, const char * const *argv,
   // Process all registered options.
   SmallVector<Option*, 4> PositionalOpts;
   SmallVector<Option*, 4> SinkOpts;
-  StringMap<Option*> Opts;
+  OptionMapTy Opts; // @LOCALMOD
   GetOptionInfo(PositionalOpts, SinkOpts, Opts);
 
   assert((!Opts.empty() || !PositionalOpts.empty()) &&
@@ -992,7 +1010,7 @@ void cl::ParseCommandLineOptions(int argc, const char * const *argv,
   }
 
   // Loop over args and make sure all required args are specified!
-  for (StringMap<Option*>::iterator I = Opts.begin(),
+  for (OptionMapTy::iterator I = Opts.begin(), // @LOCALMOD
          E = Opts.end(); I != E; ++I) {
     switch (I->second->getNumOccurrencesFlag()) {
     case Required:
@@ -0,0 +1,298 @@
+//===--- FlatStringMap.cpp - Open-addressing string map implementation ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the FlatStringMap class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/FlatStringMap.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/MathExtras.h"
+#include <cassert>
+#include <cstring>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+using namespace llvm;
+
+/// getFullHash - Hash Key.  HashString is cheap but leaves the high bits of
+/// short keys poorly mixed, and both ends of the hash are used here, so run
+/// it through a finalizer.
+static inline uint32_t getFullHash(StringRef Key) {
+  uint32_t H = HashString(Key);
+  H ^= H >> 16;
+  H *= 0x85ebca6b;
+  H ^= H >> 13;
+  H *= 0xc2b2ae35;
+  H ^= H >> 16;
+  return H;
+}
+
+/// getH2 - The seven hash bits stored in the control byte of a bucket.
+static inline int8_t getH2(uint32_t FullHash) {
+  return static_cast<int8_t>(FullHash >> 25);
+}
+
+namespace {
+/// CtrlGroup - The control bytes of one group of buckets.  The match
+/// functions return a mask with bit I set if byte I matches.
+class CtrlGroup {
+#if defined(__SSE2__)
+  __m128i Ctrl;
+
+public:
+  explicit CtrlGroup(const int8_t *P)
+    : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(P))) {}
+
+  unsigned match(int8_t H2) const {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl));
+  }
+
+  /// matchEmptyOrDeleted - Both special control bytes have the sign bit set.
+  unsigned matchEmptyOrDeleted() const {
+    return _mm_movemask_epi8(Ctrl);
+  }
+#else
+  const int8_t *Ctrl;
+
+public:
+  explicit CtrlGroup(const int8_t *P) : Ctrl(P) {}
+
+  unsigned match(int8_t H2) const {
+    unsigned Mask = 0;
+    for (unsigned I = 0; I != 16; ++I)
+      if (Ctrl[I] == H2)
+        Mask |= 1U << I;
+    return Mask;
+  }
+
+  unsigned matchEmptyOrDeleted() const {
+    unsigned Mask = 0;
+    for (unsigned I = 0; I != 16; ++I)
+      if (Ctrl[I] < 0)
+        Mask |= 1U << I;
+    return Mask;
+  }
+#endif
+
+  unsigned matchEmpty() const {
+    return match(-128);
+  }
+};
+}
+
+FlatStringMapImpl::FlatStringMapImpl(unsigned InitSize, unsigned itemSize) {
+  ItemSize = itemSize;
+
+  // If a size is specified, initialize the table with that many buckets.
+  if (InitSize) {
+    init(InitSize);
+    return;
+  }
+
+  // Otherwise, initialize it with zero buckets to avoid the allocation.
+  TheTable = 0;
+  NumBuckets = 0;
+  NumItems = 0;
+  NumTombstones = 0;
+}
+
+/// allocateTable - Allocate the bucket array and the control bytes for
+/// NumBuckets buckets, all empty.
+static StringMapEntryBase **allocateTable(unsigned NumBuckets) {
+  // Allocate one extra bucket, set it to look filled so the iterators stop at
+  // end.
+  StringMapEntryBase **Table =
+    (StringMapEntryBase **)calloc(1, (NumBuckets+1) *
+                                     sizeof(StringMapEntryBase *) +
+                                     NumBuckets);
+  Table[NumBuckets] = (StringMapEntryBase*)2;
+  memset(Table + NumBuckets + 1, 0x80, NumBuckets);
+  return Table;
+}
+
+void FlatStringMapImpl::init(unsigned InitSize) {
+  assert((InitSize & (InitSize-1)) == 0 &&
+         "Init Size must be a power of 2 or zero!");
+  NumBuckets = InitSize > GroupSize ? InitSize : GroupSize;
+  NumItems = 0;
+  NumTombstones = 0;
+  TheTable = allocateTable(NumBuckets);
+}
+
+void FlatStringMapImpl::clearTable() {
+  memset(TheTable, 0, NumBuckets * sizeof(StringMapEntryBase *));
+  memset(getCtrl(), 0x80, NumBuckets);
+  NumItems = 0;
+  NumTombstones = 0;
+}
+
+/// LookupBucketFor - Look up the bucket that the specified string should end
+/// up in.  If it already exists as a key in the map, the Item pointer for the
+/// specified bucket will be non-null and not a tombstone.  Otherwise, the
+/// caller must fill in the returned bucket, whose control byte has already
+/// been set.
+unsigned FlatStringMapImpl::LookupBucketFor(StringRef Name) {
+  if (NumBuckets == 0)  // Hash table unallocated so far?
+    init(GroupSize);
+  uint32_t FullHash = getFullHash(Name);
+  int8_t H2 = getH2(FullHash);
+  int8_t *Ctrl = getCtrl();
+  unsigned GroupMask = NumBuckets / GroupSize - 1;
+  unsigned Group = FullHash & GroupMask;
+
+  unsigned ProbeAmt = 1;
+  int FirstFree = -1;
+  while (1) {
+    unsigned Base = Group * GroupSize;
+    CtrlGroup G(Ctrl + Base);
+    for (unsigned Mask = G.match(H2); Mask; Mask &= Mask - 1) {
+      unsigned BucketNo = Base + countTrailingZeros(Mask, ZB_Undefined);
+      // Do the comparison like this because Name isn't necessarily
+      // null-terminated!
+      StringMapEntryBase *BucketItem = TheTable[BucketNo];
+      char *ItemStr = (char*)BucketItem+ItemSize;
+      if (Name == StringRef(ItemStr, BucketItem->getKeyLength()))
+        return BucketNo;
+    }
+
+    // Remember the first free bucket.  If it is a tombstone, reusing it keeps
+    // probe sequences short.
+    unsigned Free = G.matchEmptyOrDeleted();
+    if (FirstFree == -1 && Free)
+      FirstFree = Base + countTrailingZeros(Free, ZB_Undefined);
+
+    // A group with an empty bucket ends the probe sequence: the key would
+    // have been put there.
+    if (LLVM_LIKELY(G.matchEmpty())) {
+      Ctrl[FirstFree] = H2;
+      return FirstFree;
+    }
+
+    // Use quadratic probing over groups; with a power of two number of
+    // groups this visits every group.
+    Group = (Group + ProbeAmt++) & GroupMask;
+  }
+}
+
+/// FindKey - Look up the bucket that contains the specified key. If it exists
+/// in the map, return the bucket number of the key.  Otherwise return -1.
+/// This does not modify the map.
+int FlatStringMapImpl::FindKey(StringRef Key) const {
+  if (NumBuckets == 0) return -1;  // Really empty table?
+  uint32_t FullHash = getFullHash(Key);
+  int8_t H2 = getH2(FullHash);
+  const int8_t *Ctrl = getCtrl();
+  unsigned GroupMask = NumBuckets / GroupSize - 1;
+  unsigned Group = FullHash & GroupMask;
+
+  unsigned ProbeAmt = 1;
+  while (1) {
+    unsigned Base = Group * GroupSize;
+    CtrlGroup G(Ctrl + Base);
+    for (unsigned Mask = G.match(H2); Mask; Mask &= Mask - 1) {
+      unsigned BucketNo = Base + countTrailingZeros(Mask, ZB_Undefined);
+      StringMapEntryBase *BucketItem = TheTable[BucketNo];
+      char *ItemStr = (char*)BucketItem+ItemSize;
+      if (Key == StringRef(ItemStr, BucketItem->getKeyLength()))
+        return BucketNo;
+    }
+    if (LLVM_LIKELY(G.matchEmpty()))
+      return -1;
+    Group = (Group + ProbeAmt++) & GroupMask;
+  }
+}
+
+/// RemoveBucket - Empty the given full bucket.
+void FlatStringMapImpl::RemoveBucket(unsigned BucketNo) {
+  int8_t *Ctrl = getCtrl();
+  --NumItems;
+  // If the group still has an empty bucket, no probe sequence ever went past
+  // it, so the bucket can be made empty rather than a tombstone.
+  if (CtrlGroup(Ctrl + BucketNo / GroupSize * GroupSize).matchEmpty()) {
+    TheTable[BucketNo] = 0;
+    Ctrl[BucketNo] = EmptyCtrl;
+    return;
+  }
+  TheTable[BucketNo] = StringMapImpl::getTombstoneVal();
+  Ctrl[BucketNo] = DeletedCtrl;
+  ++NumTombstones;
+  assert(NumItems + NumTombstones <= NumBuckets);
+}
+
+/// RemoveKey - Remove the specified StringMapEntry from the table, but do not
+/// delete it.  This aborts if the value isn't in the table.
+void FlatStringMapImpl::RemoveKey(StringMapEntryBase *V) {
+  const char *VStr = (char*)V + ItemSize;
+  StringMapEntryBase *V2 = RemoveKey(StringRef(VStr, V->getKeyLength()));
+  (void)V2;
+  assert(V == V2 && "Didn't find key?");
+}
+
+/// RemoveKey - Remove the StringMapEntry for the specified key from the
+/// table, returning it.  If the key is not in the table, this returns null.
+StringMapEntryBase *FlatStringMapImpl::RemoveKey(StringRef Key) {
+  int Bucket = FindKey(Key);
+  if (Bucket == -1) return 0;
+
+  StringMapEntryBase *Result = TheTable[Bucket];
+  RemoveBucket(Bucket);
+  return Result;
+}
+
+/// RehashTable - Grow the table, redistributing values into the buckets with
+/// the appropriate mod-of-hashtable-size.
+void FlatStringMapImpl::RehashTable() {
+  unsigned NewSize;
+
+  // Keep at least 1/8 of the buckets empty so that every probe sequence ends.
+  // If the table is too full, grow it if more than 7/16 of the buckets hold
+  // items, otherwise just drop the tombstones.
+  if ((NumItems + NumTombstones) * 8 < NumBuckets * 7)
+    return;
+  if (NumItems * 16 > NumBuckets * 7)
+    NewSize = NumBuckets * 2;
+  else
+    NewSize = NumBuckets;
+
+  StringMapEntryBase **NewTableArray = allocateTable(NewSize);
+  int8_t *NewCtrl = reinterpret_cast<int8_t*>(NewTableArray + NewSize + 1);
+  unsigned GroupMask = NewSize / GroupSize - 1;
+
+  // Rehash all the items into their new buckets.  Hash values are not
+  // stored, so the keys are hashed again.  The new table has no tombstones
+  // and no duplicate keys, so each item goes into the first free bucket of
+  // its probe sequence.
+  for (unsigned I = 0, E = NumBuckets; I != E; ++I) {
+    StringMapEntryBase *Bucket = TheTable[I];
+    if (!Bucket || Bucket == StringMapImpl::getTombstoneVal())
+      continue;
+    char *ItemStr = (char*)Bucket+ItemSize;
+    uint32_t FullHash = getFullHash(StringRef(ItemStr, Bucket->getKeyLength()));
+    unsigned Group = FullHash & GroupMask;
+    unsigned ProbeAmt = 1;
+    while (1) {
+      unsigned Base = Group * GroupSize;
+      if (unsigned Free = CtrlGroup(NewCtrl + Base).matchEmpty()) {
+        unsigned NewBucket = Base + countTrailingZeros(Free, ZB_Undefined);
+        NewTableArray[NewBucket] = Bucket;
+        NewCtrl[NewBucket] = getH2(FullHash);
+        break;
+      }
+      Group = (Group + ProbeAmt++) & GroupMask;
+    }
+  }
+
+  free(TheTable);
+
+  TheTable = NewTableArray;
+  NumBuckets = NewSize;
+  NumTombstones = 0;
+}
@@ -23,6 +23,10 @@
 
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringExtras.h"
+// @LOCALMOD-BEGIN
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Config/config.h"
+// @LOCALMOD-END
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Format.h"
@@ -31,6 +35,14 @@
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cstring>
+// @LOCALMOD-BEGIN
+#include <map>
+#if defined(LLVM_ENABLE_THREADS) && LLVM_ENABLE_THREADS != 0 && \
+    defined(HAVE_PTHREAD_H) && defined(HAVE_PTHREAD_GETSPECIFIC)
+#define LLVM_STATISTIC_SHARD_PTHREAD 1
+#include <pthread.h>
+#endif
+// @LOCALMOD-END
 using namespace llvm;
 
 // CreateInfoOutputFile - Return a file stream to print our output on.
@@ -44,8 +56,75 @@ Enabled(
     "stats",
     cl::desc("Enable statistics output from program (available with Asserts)"));
 
+// @LOCALMOD-BEGIN
+static cl::opt<bool>
+EnabledJSON(
+    "stats-json",
+    cl::desc("Print the statistics of -stats as JSON"));
+
+static cl::opt<bool>
+EnabledPerFunction(
+    "stats-per-function",
+    cl::desc("With -stats, also print the statistics of each function "
+             "compiled by tools that support it"));
+// @LOCALMOD-END
 
 namespace {
+// @LOCALMOD-BEGIN
+/// StatisticShard - The counters of one thread, indexed by Statistic::Index.
+/// Counters live in chunks that are never moved, so that another thread can
+/// read them while this one keeps counting.  A shard is not freed when its
+/// thread exits; it keeps its counts and is handed to the next new thread.
+class StatisticShard {
+  static const unsigned ChunkSize = 1024;
+  static const unsigned MaxChunks = 64;
+  unsigned *volatile Chunks[MaxChunks];
+
+public:
+  /// Next - The shard published before this one.  It does not change once
+  /// this shard is published.
+  StatisticShard *Next;
+  /// InUse - Whether a live thread counts in this shard.
+  bool InUse;
+  /// Snapshot - The counters when beginFunctionStatistics() was called.
+  std::vector<unsigned> Snapshot;
+
+  StatisticShard() : Next(0), InUse(true) {
+    memset((void*)Chunks, 0, sizeof(Chunks));
+  }
+  ~StatisticShard() {
+    for (unsigned I = 0; I != MaxChunks; ++I)
+      delete[] Chunks[I];
+  }
+
+  unsigned &get(unsigned Index) {
+    assert(Index < ChunkSize * MaxChunks && "Too many statistics");
+    unsigned *&Chunk = const_cast<unsigned*&>(Chunks[Index / ChunkSize]);
+    if (!Chunk) {
+      unsigned *NewChunk = new unsigned[ChunkSize]();
+      sys::MemoryFence();
+      Chunk = NewChunk;
+    }
+    return Chunk[Index % ChunkSize];
+  }
+
+  /// read - Read a counter that another thread may be updating.  The load
+  /// is a single volatile access, so it sees either the old or the new count.
+  unsigned read(unsigned Index) const {
+    const volatile unsigned *Chunk = Chunks[Index / ChunkSize];
+    return Chunk ? Chunk[Index % ChunkSize] : 0;
+  }
+
+  void reset(unsigned Index) {
+    if (unsigned *Chunk = Chunks[Index / ChunkSize])
+      Chunk[Index % ChunkSize] = 0;
+  }
+};
+
+/// FunctionStatistics - The statistics counted while compiling one function.
+typedef std::vector<std::pair<const Statistic*, unsigned> > FunctionStatistics;
+// @LOCALMOD-END
+
 /// StatisticInfo - This class is used in a ManagedStatic so that it is created
 /// on demand (when the first statistic is bumped) and destroyed only when
 /// llvm_shutdown is called.  We print statistics from the destructor.
@@ -53,7 +132,21 @@ class StatisticInfo {
   std::vector<const Statistic*> Stats;
   friend void llvm::PrintStatistics();
   friend void llvm::PrintStatistics(raw_ostream &OS);
+  // @LOCALMOD-BEGIN
+  friend void llvm::PrintStatisticsJSON(raw_ostream &OS);
+
+public:
+  /// AllStats - Every registered statistic, by index, printed or not.
+  std::vector<Statistic*> AllStats;
+  /// Shards - Every counter shard, newest first.  Shards are only added at
+  /// the front and are never freed, so the list can be walked without the
+  /// statistics lock.
+  StatisticShard *volatile Shards;
+  /// PerFunction - Non-zero counts by function name, for -stats-per-function.
+  std::map<std::string, FunctionStatistics> PerFunction;
+  // @LOCALMOD-END
 public:
+  StatisticInfo() : Shards(0) {}
   ~StatisticInfo();
 
   void addStatistic(const Statistic *S) {
@@ -65,6 +158,70 @@ public:
 static ManagedStatic<StatisticInfo> StatInfo;
 static ManagedStatic<sys::SmartMutex<true> > StatLock;
 
+// @LOCALMOD-BEGIN
+/// addShard - Return a shard for a new thread, reusing one whose thread has
+/// exited, or publishing a new one to readers of the statistics.
+static StatisticShard *addShard() {
+  sys::SmartScopedLock<true> Writer(*StatLock);
+  StatisticInfo &Info = *StatInfo;
+  for (StatisticShard *Shard = Info.Shards; Shard; Shard = Shard->Next) {
+    if (!Shard->InUse) {
+      Shard->InUse = true;
+      return Shard;
+    }
+  }
+  StatisticShard *Shard = new StatisticShard();
+  Shard->Next = Info.Shards;
+  sys::MemoryFence();
+  Info.Shards = Shard;
+  return Shard;
+}
+
+#ifdef LLVM_STATISTIC_SHARD_PTHREAD
+/// destroyShard - When a thread exits, let a later thread reuse its shard.
+/// The counts stay in the shard, where readers still find them.
+extern "C" {
+static void destroyShard(void *P) {
+  sys::SmartScopedLock<true> Writer(*StatLock);
+  // The shard is gone if llvm_shutdown ran before this thread exited.
+  for (StatisticShard *Shard = StatInfo->Shards; Shard; Shard = Shard->Next) {
+    if (Shard == P) {
+      Shard->InUse = false;
+      break;
+    }
+  }
+}
+}
+
+namespace {
+struct ShardKey {
+  pthread_key_t Key;
+  ShardKey() {
+    int ErrorCode = pthread_key_create(&Key, destroyShard);
+    assert(ErrorCode == 0);
+    (void)ErrorCode;
+  }
+};
+}
+
+static StatisticShard &getThreadShard() {
+  static ShardKey K;
+  StatisticShard *Shard =
+      static_cast<StatisticShard*>(pthread_getspecific(K.Key));
+  if (!Shard) {
+    Shard = addShard();
+    pthread_setspecific(K.Key, Shard);
+  }
+  return *Shard;
+}
+#else
+static StatisticShard &getThreadShard() {
+  static StatisticShard *Shard = addShard();
+  return *Shard;
+}
+#endif
+// @LOCALMOD-END
+
 /// RegisterStatistic - The first time a statistic is bumped, this method is
 /// called.
 void Statistic::RegisterStatistic() {
@@ -74,6 +231,10 @@ void Statistic::RegisterStatistic() {
   if (!Initialized) {
     if (Enabled)
       StatInfo->addStatistic(this);
+    // @LOCALMOD-BEGIN
+    Index = StatInfo->AllStats.size();
+    StatInfo->AllStats.push_back(this);
+    // @LOCALMOD-END
 
     TsanHappensBefore(this);
     sys::MemoryFence();
@@ -84,6 +245,64 @@ void Statistic::RegisterStatistic() {
   }
 }
 
+// @LOCALMOD-BEGIN
+unsigned &Statistic::getCounter() {
+  init();
+  return getThreadShard().get(Index);
+}
+
+sys::cas_flag Statistic::getValue() const {
+  if (!Initialized)
+    return Value;
+  unsigned Sum = Value;
+  for (StatisticShard *Shard = StatInfo->Shards; Shard; Shard = Shard->Next)
+    Sum += Shard->read(Index);
+  return Sum;
+}
+
+void Statistic::setValue(unsigned Val) {
+  init();
+  StatisticShard *Own = &getThreadShard();
+  sys::SmartScopedLock<true> Writer(*StatLock);
+  for (StatisticShard *Shard = StatInfo->Shards; Shard; Shard = Shard->Next) {
+    assert((Shard == Own || !Shard->InUse) &&
+           "Statistic set while other threads may be counting");
+    Shard->reset(Index);
+  }
+  (void)Own;
+  Value = Val;
+}
+
+void llvm::beginFunctionStatistics() {
+  if (!Enabled || !EnabledPerFunction)
+    return;
+  StatisticShard &Shard = getThreadShard();
+  unsigned NumStats;
+  {
+    sys::SmartScopedLock<true> Reader(*StatLock);
+    NumStats = StatInfo->AllStats.size();
+  }
+  Shard.Snapshot.resize(NumStats);
+  for (unsigned I = 0; I != NumStats; ++I)
+    Shard.Snapshot[I] = Shard.read(I);
+}
+
+void llvm::endFunctionStatistics(StringRef Fn) {
+  if (!Enabled || !EnabledPerFunction)
+    return;
+  StatisticShard &Shard = getThreadShard();
+  sys::SmartScopedLock<true> Writer(*StatLock);
+  StatisticInfo &Info = *StatInfo;
+  FunctionStatistics &FnStats = Info.PerFunction[Fn];
+  FnStats.clear();
+  for (unsigned I = 0, E = Info.AllStats.size(); I != E; ++I) {
+    unsigned Before = I < Shard.Snapshot.size() ? Shard.Snapshot[I] : 0;
+    if (unsigned Delta = Shard.read(I) - Before)
+      FnStats.push_back(std::make_pair(Info.AllStats[I], Delta));
+  }
+}
+// @LOCALMOD-END
+
 namespace {
 
 struct NameCompare {
@@ -96,6 +315,15 @@ struct NameCompare {
   }
 };
 
+// @LOCALMOD-BEGIN
+struct PairNameCompare {
+  bool operator()(const std::pair<const Statistic*, unsigned> &LHS,
+                  const std::pair<const Statistic*, unsigned> &RHS) const {
+    return NameCompare()(LHS.first, RHS.first);
+  }
+};
+// @LOCALMOD-END
+
 }
 
 // Print information when destroyed, iff command line option is specified.
@@ -111,6 +339,12 @@ bool llvm::AreStatisticsEnabled() {
   return Enabled;
 }
 
+// @LOCALMOD-BEGIN
+bool llvm::AreStatisticsPrintedAsJSON() {
+  return EnabledJSON;
+}
+// @LOCALMOD-END
+
 void llvm::PrintStatistics(raw_ostream &OS) {
   StatisticInfo &Stats = *StatInfo;
 
@@ -139,10 +373,86 @@ void llvm::PrintStatistics(raw_ostream &OS) {
                  Stats.Stats[i]->getDesc());
 
   OS << '\n';  // Flush the output stream.
+
+  // @LOCALMOD-BEGIN
+  // Print the statistics of each function, if -stats-per-function was given.
+  if (!Stats.PerFunction.empty()) {
+    OS << "===" << std::string(73, '-') << "===\n"
+       << "                  ... Statistics Collected Per Function ...\n"
+       << "===" << std::string(73, '-') << "===\n\n";
+    for (std::map<std::string, FunctionStatistics>::iterator
+             I = Stats.PerFunction.begin(), E = Stats.PerFunction.end();
+         I != E; ++I) {
+      FunctionStatistics &FnStats = I->second;
+      std::stable_sort(FnStats.begin(), FnStats.end(), PairNameCompare());
+      OS << "Function '" << I->first << "':\n";
+      for (size_t i = 0, e = FnStats.size(); i != e; ++i)
+        OS << format("%*u %-*s - %s\n",
+                     MaxValLen, FnStats[i].second,
+                     MaxNameLen, FnStats[i].first->getName(),
+                     FnStats[i].first->getDesc());
+      OS << '\n';
+    }
+  }
+  // @LOCALMOD-END
   OS.flush();
 
 }
 
+// @LOCALMOD-BEGIN
+static void printJSONString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (size_t i = 0, e = Str.size(); i != e; ++i) {
+    unsigned char C = Str[i];
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if (C < 0x20)
+      OS << format("\\u%04x", C);
+    else
+      OS << C;
+  }
+  OS << '"';
+}
+
+static void printJSONStatistic(raw_ostream &OS, const Statistic *S,
+                               unsigned Value) {
+  OS << "{\"name\": ";
+  printJSONString(OS, S->getName());
+  OS << ", \"desc\": ";
+  printJSONString(OS, S->getDesc());
+  OS << ", \"value\": " << Value << "}";
+}
+
+void llvm::PrintStatisticsJSON(raw_ostream &OS) {
+  StatisticInfo &Stats = *StatInfo;
+
+  std::stable_sort(Stats.Stats.begin(), Stats.Stats.end(), NameCompare());
+
+  OS << "{\n  \"statistics\": [";
+  for (size_t i = 0, e = Stats.Stats.size(); i != e; ++i) {
+    OS << (i ? ",\n    " : "\n    ");
+    printJSONStatistic(OS, Stats.Stats[i], Stats.Stats[i]->getValue());
+  }
+  OS << "\n  ],\n  \"functions\": {";
+  for (std::map<std::string, FunctionStatistics>::iterator
+           I = Stats.PerFunction.begin(), E = Stats.PerFunction.end();
+       I != E; ++I) {
+    FunctionStatistics &FnStats = I->second;
+    std::stable_sort(FnStats.begin(), FnStats.end(), PairNameCompare());
+    OS << (I == Stats.PerFunction.begin() ? "\n    " : ",\n    ");
+    printJSONString(OS, I->first);
+    OS << ": [";
+    for (size_t i = 0, e = FnStats.size(); i != e; ++i) {
+      OS << (i ? ",\n      " : "\n      ");
+      printJSONStatistic(OS, FnStats[i].first, FnStats[i].second);
+    }
+    OS << "\n    ]";
+  }
+  OS << "\n  }\n}\n";
+  OS.flush();
+}
+// @LOCALMOD-END
+
 void llvm::PrintStatistics() {
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_STATS)
   StatisticInfo &Stats = *StatInfo;
@@ -152,7 +462,12 @@ void llvm::PrintStatistics() {
 
   // Get the stream to write to.
   raw_ostream &OutStream = *CreateInfoOutputFile();
-  PrintStatistics(OutStream);
+  // @LOCALMOD-BEGIN
+  if (EnabledJSON)
+    PrintStatisticsJSON(OutStream);
+  else
+    PrintStatistics(OutStream);
+  // @LOCALMOD-END
   delete &OutStream;   // Close the file.
 #else
   // Check if the -stats option is set instead of checking
@@ -0,0 +1,341 @@
+//===-- Trace.cpp - Low-overhead trace scopes -----------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Each thread that enters a trace scope gets a TraceBuffer, a ring of the
+// most recent events it recorded.  Recording an event only touches the
+// thread's own buffer, so threads never contend.  The buffers are owned by
+// the TraceRegistry and outlive their threads, so that a trace can be written
+// after the compile threads have been joined.  Where threads can be told
+// apart by pthread keys, the buffer of an exited thread is handed to the next
+// new thread, so a server that spawns threads for every request keeps a
+// bounded number of buffers.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Trace.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+#include <string>
+#include <vector>
+#if defined(LLVM_ON_UNIX) && defined(HAVE_UNISTD_H)
+#include <time.h>
+#include <unistd.h>
+#endif
+#if defined(LLVM_ENABLE_THREADS) && LLVM_ENABLE_THREADS != 0 && \
+    defined(HAVE_PTHREAD_H) && defined(HAVE_PTHREAD_GETSPECIFIC)
+#define LLVM_TRACE_BUFFER_PTHREAD 1
+#include <pthread.h>
+#else
+#include "llvm/Support/ThreadLocal.h"
+#endif
+using namespace llvm;
+
+volatile sys::cas_flag llvm::TraceEnabled = 0;
+
+namespace {
+/// TraceFileParser - Starts tracing as soon as -trace-file is seen, so that
+/// the scopes entered before main() looks at its options are recorded too.
+struct TraceFileParser : public cl::parser<std::string> {
+  bool parse(cl::Option &O, StringRef ArgName, StringRef Arg,
+             std::string &Value) {
+    if (cl::parser<std::string>::parse(O, ArgName, Arg, Value))
+      return true;
+    if (!Value.empty())
+      startTracing(Value);
+    return false;
+  }
+};
+}
+
+static cl::opt<std::string, false, TraceFileParser>
+TraceFile("trace-file", cl::value_desc("filename"),
+          cl::desc("Write a Chrome trace-event file of the passes, functions "
+                   "and phases run, viewable with chrome://tracing"));
+
+static cl::opt<unsigned>
+TraceBufferEvents("trace-buffer-events", cl::init(1 << 16), cl::Hidden,
+                  cl::desc("Number of trace events each thread keeps; older "
+                           "events are dropped"));
+
+/// getTraceTime - Nanoseconds on a monotonic clock.  The clock is only read
+/// when tracing is enabled.
+static uint64_t getTraceTime() {
+#if defined(LLVM_ON_UNIX) && defined(_POSIX_MONOTONIC_CLOCK) && \
+    _POSIX_MONOTONIC_CLOCK >= 0
+  struct timespec TS;
+  if (::clock_gettime(CLOCK_MONOTONIC, &TS) == 0)
+    return uint64_t(TS.tv_sec) * 1000000000 + TS.tv_nsec;
+#endif
+  sys::TimeValue Now = sys::TimeValue::now();
+  return uint64_t(Now.seconds()) * 1000000000 + Now.nanoseconds();
+}
+
+namespace {
+struct TraceEvent {
+  const char *Category;
+  const char *Name;
+  uint64_t Start;
+  uint64_t Duration;
+};
+
+/// TraceBuffer - The events recorded by one thread.  Only that thread
+/// changes the buffer while tracing is enabled.
+struct TraceBuffer {
+  unsigned ThreadID;
+  std::string ThreadName;
+  /// Events - The ring, allocated when the first event is recorded.
+  std::vector<TraceEvent> Events;
+  /// Generation - The tracing session the events belong to.
+  sys::cas_flag Generation;
+  /// NumRecorded - The number of events recorded in this session.
+  /// The newest event is at index (NumRecorded - 1) % Events.size().
+  uint64_t NumRecorded;
+  /// Names - Copies of the names given as StringRefs.
+  StringSet<> Names;
+  /// InUse - Whether a live thread owns the buffer.
+  bool InUse;
+
+  TraceBuffer(unsigned ID, sys::cas_flag Gen)
+    : ThreadID(ID), Generation(Gen), NumRecorded(0), InUse(true) {}
+
+  /// record - Add an event to the session Gen.  The events of an earlier
+  /// session are dropped here, by the owning thread, rather than by
+  /// startTracing.
+  void record(sys::cas_flag Gen, const char *Category, const char *Name,
+              uint64_t Start, uint64_t End) {
+    if (Generation != Gen) {
+      Generation = Gen;
+      NumRecorded = 0;
+    }
+    if (Events.empty())
+      Events.resize(TraceBufferEvents ? TraceBufferEvents : 1);
+    TraceEvent &E = Events[NumRecorded++ % Events.size()];
+    E.Category = Category;
+    E.Name = Name;
+    E.Start = Start;
+    E.Duration = End - Start;
+  }
+
+  const char *intern(StringRef Name) {
+    return Names.GetOrCreateValue(Name).getKeyData();
+  }
+};
+
+class TraceRegistry {
+  sys::SmartMutex<false> Lock;
+  std::vector<TraceBuffer*> Buffers;
+#ifdef LLVM_TRACE_BUFFER_PTHREAD
+  pthread_key_t Current;
+#else
+  sys::ThreadLocal<const TraceBuffer> Current;
+#endif
+  std::string Path;
+  uint64_t Origin;
+
+  void write(raw_ostream &OS);
+
+public:
+  /// Generation - The current tracing session, counted by start().
+  volatile sys::cas_flag Generation;
+
+  TraceRegistry();
+  ~TraceRegistry() {
+    if (TraceEnabled)
+      stop();
+#ifdef LLVM_TRACE_BUFFER_PTHREAD
+    pthread_key_delete(Current);
+#endif
+    DeleteContainerPointers(Buffers);
+  }
+
+  TraceBuffer &getBuffer() {
+#ifdef LLVM_TRACE_BUFFER_PTHREAD
+    if (void *B = pthread_getspecific(Current))
+      return *static_cast<TraceBuffer*>(B);
+#else
+    if (const TraceBuffer *B = Current.get())
+      return *const_cast<TraceBuffer*>(B);
+#endif
+    TraceBuffer *B = takeBuffer();
+#ifdef LLVM_TRACE_BUFFER_PTHREAD
+    pthread_setspecific(Current, B);
+#else
+    Current.set(B);
+#endif
+    return *B;
+  }
+
+  /// takeBuffer - Return a buffer for a new thread, reusing one whose thread
+  /// has exited.
+  TraceBuffer *takeBuffer() {
+    sys::SmartScopedLock<false> Guard(Lock);
+    for (unsigned I = 0, E = Buffers.size(); I != E; ++I) {
+      if (!Buffers[I]->InUse) {
+        Buffers[I]->InUse = true;
+        Buffers[I]->ThreadName.clear();
+        return Buffers[I];
+      }
+    }
+    TraceBuffer *B = new TraceBuffer(Buffers.size(), Generation);
+    Buffers.push_back(B);
+    return B;
+  }
+
+  /// releaseBuffer - Let a later thread reuse P; its events are kept.
+  void releaseBuffer(void *P) {
+    sys::SmartScopedLock<false> Guard(Lock);
+    for (unsigned I = 0, E = Buffers.size(); I != E; ++I) {
+      if (Buffers[I] == P) {
+        Buffers[I]->InUse = false;
+        break;
+      }
+    }
+  }
+
+  void start(StringRef P) {
+    sys::SmartScopedLock<false> Guard(Lock);
+    Path = P;
+    Origin = getTraceTime();
+    sys::AtomicIncrement(&Generation);
+    TraceEnabled = 1;
+  }
+
+  bool stop();
+};
+}
+
+static ManagedStatic<TraceRegistry> Registry;
+
+#ifdef LLVM_TRACE_BUFFER_PTHREAD
+extern "C" {
+static void releaseTraceBuffer(void *P) {
+  Registry->releaseBuffer(P);
+}
+}
+#endif
+
+TraceRegistry::TraceRegistry() : Origin(0), Generation(0) {
+#ifdef LLVM_TRACE_BUFFER_PTHREAD
+  int ErrorCode = pthread_key_create(&Current, releaseTraceBuffer);
+  assert(ErrorCode == 0);
+  (void)ErrorCode;
+#endif
+}
+
+void TraceScope::begin(const char *Cat, const char *N) {
+  Category = Cat;
+  Name = N;
+  Start = getTraceTime();
+}
+
+void TraceScope::begin(const char *Cat, StringRef N) {
+  begin(Cat, Registry->getBuffer().intern(N));
+}
+
+void TraceScope::end() {
+  // Tracing may have been stopped while the scope was open; the event is
+  // then dropped.
+  if (TraceEnabled)
+    Registry->getBuffer().record(Registry->Generation, Category, Name, Start,
+                                 getTraceTime());
+}
+
+void llvm::setTraceThreadName(StringRef Name) {
+  Registry->getBuffer().ThreadName = Name;
+}
+
+void llvm::startTracing(StringRef Path) {
+  Registry->start(Path);
+}
+
+bool llvm::stopTracing() {
+  return TraceEnabled ? Registry->stop() : true;
+}
+
+bool TraceRegistry::stop() {
+  sys::SmartScopedLock<false> Guard(Lock);
+  TraceEnabled = 0;
+
+  std::string Error;
+  raw_fd_ostream OS(Path.c_str(), Error);
+  if (!Error.empty()) {
+    errs() << "error opening trace file '" << Path << "': " << Error << '\n';
+    return false;
+  }
+  write(OS);
+  return true;
+}
+
+static void printJSONString(raw_ostream &OS, StringRef Str) {
+  OS << '"';
+  for (size_t i = 0, e = Str.size(); i != e; ++i) {
+    unsigned char C = Str[i];
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if (C < 0x20)
+      OS << format("\\u%04x", C);
+    else
+      OS << C;
+  }
+  OS << '"';
+}
+
+/// write - Print the buffers in the Chrome trace-event format, with times
+/// in microseconds since tracing was started.
+void TraceRegistry::write(raw_ostream &OS) {
+  uint64_t Dropped = 0;
+  bool First = true;
+  OS << "{\"traceEvents\": [";
+  for (unsigned I = 0, E = Buffers.size(); I != E; ++I) {
+    TraceBuffer &B = *Buffers[I];
+    if (!B.ThreadName.empty()) {
+      OS << (First ? "\n" : ",\n")
+         << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, "
+         << "\"tid\": " << B.ThreadID << ", \"args\": {\"name\": ";
+      printJSONString(OS, B.ThreadName);
+      OS << "}}";
+      First = false;
+    }
+
+    // The thread has not recorded anything since tracing was started.
+    if (B.Generation != Generation)
+      continue;
+    uint64_t Size = B.Events.size();
+    uint64_t Begin = B.NumRecorded > Size ? B.NumRecorded - Size : 0;
+    Dropped += Begin;
+    for (uint64_t N = Begin; N != B.NumRecorded; ++N) {
+      const TraceEvent &Ev = B.Events[N % Size];
+      // Events recorded before the last startTracing are not interesting.
+      if (Ev.Start < Origin)
+        continue;
+      OS << (First ? "\n" : ",\n") << "{\"name\": ";
+      printJSONString(OS, Ev.Name);
+      OS << ", \"cat\": ";
+      printJSONString(OS, Ev.Category);
+      OS << ", \"ph\": \"X\", \"ts\": "
+         << format("%.3f", (Ev.Start - Origin) / 1000.0)
+         << ", \"dur\": " << format("%.3f", Ev.Duration / 1000.0)
+         << ", \"pid\": 0, \"tid\": " << B.ThreadID << "}";
+      First = false;
+    }
+    B.NumRecorded = 0;
+  }
+  OS << "\n], \"displayTimeUnit\": \"ms\"}\n";
+
+  if (Dropped)
+    errs() << "warning: " << Dropped << " trace events were dropped; "
+           << "increase -trace-buffer-events\n";
+}
@@ -518,7 +518,7 @@ DecodeStatus ARMDisassembler::getInstruction(MCInst &MI, uint64_t &Size,
 }
 
 namespace llvm {
-extern const MCInstrDesc ARMInsts[];
+extern const MCInstrDesc *const ARMInsts; // @LOCALMOD
 }
 
 /// tryAddingSymbolicOperand - trys to add a symbolic operand in place of the
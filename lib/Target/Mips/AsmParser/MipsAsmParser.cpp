@@ -551,7 +551,7 @@ public:
 } // namespace
 
 namespace llvm {
-extern const MCInstrDesc MipsInsts[];
+extern const MCInstrDesc *const MipsInsts; // @LOCALMOD
 }
 static const MCInstrDesc &getInstDesc(unsigned Opcode) {
   return MipsInsts[Opcode];
@@ -14,13 +14,29 @@
 //
 // It currently:
 // - Re-generates shufflevector (not part of the PNaCl ABI) from
-//   insertelement / extractelement combinations. This is done by
-//   duplicating some of instcombine's implementation, and ignoring
-//   optimizations that should already have taken place.
-// - TODO(jfb) Re-combine load/store for vectors, which are transformed
-//             into load/store of the underlying elements.
-// - TODO(jfb) Re-materialize constant arguments, which are currently
-//             loads from global constant vectors.
+//   insertelement / extractelement combinations. The lanes of a vector
+//   built by an insertelement chain are traced back through
+//   insertelement, extractelement and shufflevector to the vectors and
+//   scalars they come from, which handles permutations, blends of any
+//   number of vectors, splats and interleaves. The vector is rebuilt as a
+//   tree of two-input shufflevectors when the target's costs say that is
+//   cheaper. Chains which aren't rebuilt that way go through a copy of
+//   instcombine's implementation, ignoring optimizations that should
+//   already have taken place.
+// - Re-combines load/store for vectors, which FixVectorLoadStoreAlignment
+//   transforms into load/store of the underlying elements when they aren't
+//   element-aligned.
+// - Re-materializes constant arguments, which GlobalizeConstantVectors
+//   turns into loads from global constant vectors.
+//
+// Re-combining element accesses is safe because the vector access touches
+// exactly the bytes that the element accesses touched, and no other memory
+// access is allowed between the element accesses that are combined. The
+// vector access gets the alignment of the access to element 0, which is the
+// alignment the vector was known to have before it was split: a vector
+// access with less than element alignment is valid IR and the backend
+// lowers it to an unaligned access. This pass runs after the PNaCl ABI
+// verifier, so the accesses it creates don't need to be ABI-conformant.
 //
 // The pass also performs limited DCE on instructions it knows to be
 // dead, instead of performing a full global DCE. Note that it can also
@@ -30,7 +46,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Analysis/ConstantFolding.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/DataLayout.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
@@ -200,12 +222,109 @@ Value *CollectShuffleElements(Value *V, SmallVectorImpl<Constant*> &Mask,
   return V;
 }
 
+/// getBaseAndOffset - Split the address Ptr into a base and a constant byte
+/// offset from it, looking through the pointer casts, constant additions
+/// and constant GEPs that FixVectorLoadStoreAlignment and the PNaCl bitcode
+/// reader generate for the addresses of vector elements.
+Value *getBaseAndOffset(Value *Ptr, const DataLayout &DL, int64_t &Offset) {
+  unsigned PtrBits = DL.getPointerSizeInBits();
+  Offset = 0;
+  for (;;) {
+    switch (Operator::getOpcode(Ptr)) {
+    case Instruction::BitCast:
+      Ptr = cast<Operator>(Ptr)->getOperand(0);
+      continue;
+    case Instruction::IntToPtr:
+    case Instruction::PtrToInt: {
+      Value *Op = cast<Operator>(Ptr)->getOperand(0);
+      if (DL.getTypeSizeInBits(Op->getType()) != PtrBits ||
+          DL.getTypeSizeInBits(Ptr->getType()) != PtrBits)
+        return Ptr;
+      Ptr = Op;
+      continue;
+    }
+    case Instruction::Add:
+      if (ConstantInt *C =
+              dyn_cast<ConstantInt>(cast<Operator>(Ptr)->getOperand(1))) {
+        Offset += C->getSExtValue();
+        Ptr = cast<Operator>(Ptr)->getOperand(0);
+        continue;
+      }
+      return Ptr;
+    case Instruction::GetElementPtr: {
+      GEPOperator *GEP = cast<GEPOperator>(Ptr);
+      APInt GEPOffset(PtrBits, 0);
+      if (!GEP->accumulateConstantOffset(DL, GEPOffset))
+        return Ptr;
+      Offset += GEPOffset.getSExtValue();
+      Ptr = GEP->getPointerOperand();
+      continue;
+    }
+    default:
+      return Ptr;
+    }
+  }
+}
+
+/// LaneSource - Where a lane of a vector comes from: a lane of another
+/// vector, a scalar, or nowhere if the lane is undef.
+struct LaneSource {
+  Value *V;  // Null if the lane is undef.
+  int Lane;  // The lane of vector V, or -1 if V is a scalar.
+  explicit LaneSource(Value *V = 0, int Lane = -1) : V(V), Lane(Lane) {}
+};
+
+// Bounds the search through long chains of vector instructions.
+const unsigned MaxLaneSearchDepth = 64;
+
+LaneSource findLaneSource(Value *V, unsigned Lane, unsigned Depth);
+
+/// findScalarSource - Find where the scalar S comes from, looking through
+/// extractelement.
+LaneSource findScalarSource(Value *S, unsigned Depth) {
+  if (isa<UndefValue>(S))
+    return LaneSource();
+  if (ExtractElementInst *EI = dyn_cast<ExtractElementInst>(S))
+    if (ConstantInt *Idx = dyn_cast<ConstantInt>(EI->getIndexOperand()))
+      if (Idx->getZExtValue() < EI->getVectorOperandType()->getNumElements())
+        return findLaneSource(EI->getVectorOperand(), Idx->getZExtValue(),
+                              Depth + 1);
+  return LaneSource(S);
+}
+
+/// findLaneSource - Find where lane Lane of the vector V comes from,
+/// looking through insertelement, shufflevector and constant vectors.
+LaneSource findLaneSource(Value *V, unsigned Lane, unsigned Depth) {
+  if (Depth > MaxLaneSearchDepth)
+    return LaneSource(V, Lane);
+  if (isa<UndefValue>(V))
+    return LaneSource();
+  if (Constant *C = dyn_cast<Constant>(V))
+    if (Constant *Elt = C->getAggregateElement(Lane))
+      return findScalarSource(Elt, Depth + 1);
+  if (InsertElementInst *IE = dyn_cast<InsertElementInst>(V))
+    if (ConstantInt *Idx = dyn_cast<ConstantInt>(IE->getOperand(2)))
+      return Idx->getZExtValue() == Lane
+                 ? findScalarSource(IE->getOperand(1), Depth + 1)
+                 : findLaneSource(IE->getOperand(0), Lane, Depth + 1);
+  if (ShuffleVectorInst *SV = dyn_cast<ShuffleVectorInst>(V)) {
+    int M = SV->getMaskValue(Lane);
+    unsigned NumOpElts = SV->getOperand(0)->getType()->getVectorNumElements();
+    if (M < 0)
+      return LaneSource();
+    if (unsigned(M) < NumOpElts)
+      return findLaneSource(SV->getOperand(0), M, Depth + 1);
+    return findLaneSource(SV->getOperand(1), M - NumOpElts, Depth + 1);
+  }
+  return LaneSource(V, Lane);
+}
+
 class CombineVectorInstructions
     : public BasicBlockPass,
       public InstVisitor<CombineVectorInstructions, bool> {
 public:
   static char ID; // Pass identification, replacement for typeid
-  CombineVectorInstructions() : BasicBlockPass(ID) {
+  CombineVectorInstructions() : BasicBlockPass(ID), DL(0), TTI(0) {
     initializeCombineVectorInstructionsPass(*PassRegistry::getPassRegistry());
   }
   virtual void getAnalysisUsage(AnalysisUsage &AU) const {
@@ -218,12 +337,42 @@ public:
   // InstVisitor implementation. Unhandled instructions stay as-is.
   bool visitInstruction(Instruction &I) { return false; }
   bool visitInsertElementInst(InsertElementInst &IE);
+  bool visitLoadInst(LoadInst &LI);
+  bool visitStoreInst(StoreInst &SI);
 
  private:
   // List of instructions that are now obsolete, and should be DCE'd.
   typedef SmallVector<Instruction *, 16> KillListT;
   KillListT KillList;
 
+  // Load/store re-combination needs to know the element sizes, it is
+  // skipped when there is no DataLayout.
+  const DataLayout *DL;
+
+  // Costs of vector instructions on the target, unit costs if there is no
+  // TargetTransformInfo.
+  const TargetTransformInfo *TTI;
+  unsigned getVectorInstrCost(unsigned Opcode, Type *Ty, unsigned Idx) const;
+  unsigned getShuffleCost(bool Broadcast, Type *Ty) const;
+
+  /// Rebuild the vector computed by the insertelement chain ending with IE
+  /// from the vectors and scalars that its lanes come from, if that is
+  /// cheaper than the chain.
+  bool reconstructShuffle(InsertElementInst &IE);
+
+  /// Returns the size of the elements of VecTy in bytes, or zero if they
+  /// aren't a whole number of bytes which are laid out contiguously.
+  uint64_t getElementSize(VectorType *VecTy) const;
+
+  /// Returns the value that the load L reads from a constant global, or
+  /// null if it can't be determined.
+  Constant *foldConstantLoad(LoadInst *L) const;
+
+  /// Re-combine an insertelement chain which fills a vector with loads of
+  /// consecutive elements into a single vector load, or into a constant
+  /// vector if the elements are loaded from a constant global.
+  bool combineLoads(InsertElementInst &IE);
+
   /// Empty the kill list, making sure that all other dead instructions
   /// up the chain (but in the current basic block) also get killed.
   void emptyKillList(BasicBlock &B);
@@ -237,6 +386,8 @@ INITIALIZE_PASS(CombineVectorInstructions, "combine-vector-instructions",
 
 bool CombineVectorInstructions::runOnBasicBlock(BasicBlock &B) {
   bool Modified = false;
+  DL = getAnalysisIfAvailable<DataLayout>();
+  TTI = getAnalysisIfAvailable<TargetTransformInfo>();
   for (BasicBlock::iterator BI = B.begin(), BE = B.end(); BI != BE; ++BI)
     Modified |= visit(&*BI);
   emptyKillList(B);
@@ -249,6 +400,9 @@ bool CombineVectorInstructions::visitInsertElementInst(InsertElementInst &IE) {
   Value *ScalarOp = IE.getOperand(1);
   Value *IdxOp = IE.getOperand(2);
 
+  if (combineLoads(IE) || reconstructShuffle(IE))
+    return true;
+
   // If the inserted element was extracted from some other vector, and if the
   // indexes are constant, try to turn this into a shufflevector operation.
   if (ExtractElementInst *EI = dyn_cast<ExtractElementInst>(ScalarOp)) {
@@ -303,19 +457,386 @@ bool CombineVectorInstructions::visitInsertElementInst(InsertElementInst &IE) {
   return false;
 }
 
+unsigned CombineVectorInstructions::getVectorInstrCost(unsigned Opcode,
+                                                       Type *Ty,
+                                                       unsigned Idx) const {
+  return TTI ? TTI->getVectorInstrCost(Opcode, Ty, Idx) : 1;
+}
+
+unsigned CombineVectorInstructions::getShuffleCost(bool Broadcast,
+                                                   Type *Ty) const {
+  // TargetTransformInfo doesn't model arbitrary shuffles, a reverse is the
+  // closest kind it knows of.
+  if (!TTI)
+    return 1;
+  return TTI->getShuffleCost(Broadcast ? TargetTransformInfo::SK_Broadcast
+                                       : TargetTransformInfo::SK_Reverse,
+                             Ty);
+}
+
+bool CombineVectorInstructions::reconstructShuffle(InsertElementInst &IE) {
+  // Only look at the last insertelement of a chain.
+  if (IE.hasOneUse() && isa<InsertElementInst>(IE.use_back()))
+    return false;
+  VectorType *VecTy = IE.getType();
+  unsigned NumElts = VecTy->getNumElements();
+  Type *Int32Ty = Type::getInt32Ty(IE.getContext());
+
+  // The insertelement chain, and the extractelements which only feed it,
+  // die when the vector is rebuilt.
+  unsigned OldCost = 0;
+  for (InsertElementInst *I = &IE; I;) {
+    ConstantInt *Idx = dyn_cast<ConstantInt>(I->getOperand(2));
+    if (!Idx)
+      break;
+    OldCost += getVectorInstrCost(Instruction::InsertElement, VecTy,
+                                  Idx->getZExtValue());
+    if (ExtractElementInst *EI =
+            dyn_cast<ExtractElementInst>(I->getOperand(1)))
+      if (ConstantInt *EIdx = dyn_cast<ConstantInt>(EI->getIndexOperand()))
+        if (EI->hasOneUse())
+          OldCost += getVectorInstrCost(Instruction::ExtractElement,
+                                        EI->getVectorOperandType(),
+                                        EIdx->getZExtValue());
+    I = dyn_cast<InsertElementInst>(I->getOperand(0));
+    if (I && !I->hasOneUse())
+      break;
+  }
+  if (OldCost == 0)
+    return false;
+
+  // Find where each lane comes from. The vectors that lanes come from are
+  // the leaves of a tree of shuffles. Constant lanes come from a constant
+  // vector, and scalars used in several lanes are splatted. Other scalars
+  // are inserted in the result.
+  SmallVector<LaneSource, 16> Lanes;
+  SmallVector<Constant *, 16> ConstElts(
+      NumElts, UndefValue::get(VecTy->getElementType()));
+  bool HasConstLanes = false;
+  DenseMap<Value *, unsigned> ScalarLanes;
+  for (unsigned i = 0; i != NumElts; ++i) {
+    LaneSource Src = findLaneSource(&IE, i, 0);
+    if (Src.V && Src.Lane < 0) {
+      if (Constant *C = dyn_cast<Constant>(Src.V)) {
+        ConstElts[i] = C;
+        HasConstLanes = true;
+      } else
+        ++ScalarLanes[Src.V];
+    } else if (Src.V && Src.V->getType() != VecTy)
+      return false;
+    Lanes.push_back(Src);
+  }
+  Constant *ConstVec = HasConstLanes ? ConstantVector::get(ConstElts) : 0;
+
+  // A splatted scalar is its own leaf, it is inserted in lane 0 of a
+  // vector before being shuffled.
+  SmallVector<Value *, 4> Leaves;
+  SmallVector<int, 16> LaneLeaf(NumElts, -1);
+  SmallVector<unsigned, 4> ScalarInserts;
+  unsigned NewCost = 0;
+  for (unsigned i = 0; i != NumElts; ++i) {
+    LaneSource &Src = Lanes[i];
+    if (!Src.V)
+      continue;
+    if (Src.Lane < 0) {
+      if (isa<Constant>(Src.V)) {
+        Src = LaneSource(ConstVec, i);
+      } else if (ScalarLanes[Src.V] == 1) {
+        ScalarInserts.push_back(i);
+        NewCost +=
+            getVectorInstrCost(Instruction::InsertElement, VecTy, i);
+        continue;
+      } else
+        Src.Lane = 0;
+    }
+    Value **Leaf = std::find(Leaves.begin(), Leaves.end(), Src.V);
+    LaneLeaf[i] = Leaf - Leaves.begin();
+    if (Leaf == Leaves.end()) {
+      Leaves.push_back(Src.V);
+      if (Src.V->getType() != VecTy)
+        NewCost += getVectorInstrCost(Instruction::InsertElement, VecTy, 0);
+    }
+  }
+
+  bool Identity = true, Broadcast = true;
+  for (unsigned i = 0; i != NumElts; ++i)
+    if (LaneLeaf[i] >= 0) {
+      Identity &= Lanes[i].Lane == int(i);
+      Broadcast &= Lanes[i].Lane == 0;
+    }
+  if (Leaves.size() > 1)
+    NewCost += (Leaves.size() - 1) * getShuffleCost(false, VecTy);
+  else if (Leaves.size() == 1 && !Identity)
+    NewCost += getShuffleCost(Broadcast, VecTy);
+  if (NewCost >= OldCost)
+    return false;
+
+  // Blend the leaves together, one at a time. ResultLane tracks which lane
+  // of the partial result each lane of the vector is in.
+  IRBuilder<> IRB(&IE);
+  Value *Result = 0;
+  SmallVector<int, 16> ResultLane(NumElts, -1);
+  for (unsigned L = 0, E = Leaves.size(); L != E; ++L) {
+    Value *Leaf = Leaves[L];
+    if (Leaf->getType() != VecTy)
+      Leaf = IRB.CreateInsertElement(UndefValue::get(VecTy), Leaf,
+                                     ConstantInt::get(Int32Ty, 0));
+    if (!Result) {
+      Result = Leaf;
+      for (unsigned i = 0; i != NumElts; ++i)
+        if (LaneLeaf[i] == int(L))
+          ResultLane[i] = Lanes[i].Lane;
+      continue;
+    }
+    SmallVector<Constant *, 16> Mask;
+    for (unsigned i = 0; i != NumElts; ++i) {
+      int M = LaneLeaf[i] == int(L) ? NumElts + Lanes[i].Lane : ResultLane[i];
+      Mask.push_back(M < 0 ? UndefValue::get(Int32Ty)
+                           : ConstantInt::get(Int32Ty, M));
+      if (M >= 0)
+        ResultLane[i] = i;
+    }
+    Result = IRB.CreateShuffleVector(Result, Leaf, ConstantVector::get(Mask));
+  }
+  if (!Result)
+    Result = UndefValue::get(VecTy);
+  else if (Leaves.size() == 1 && !Identity) {
+    SmallVector<Constant *, 16> Mask;
+    for (unsigned i = 0; i != NumElts; ++i)
+      Mask.push_back(ResultLane[i] < 0
+                         ? UndefValue::get(Int32Ty)
+                         : ConstantInt::get(Int32Ty, ResultLane[i]));
+    Result = IRB.CreateShuffleVector(Result, UndefValue::get(VecTy),
+                                     ConstantVector::get(Mask));
+  }
+  for (unsigned I = 0, E = ScalarInserts.size(); I != E; ++I) {
+    unsigned i = ScalarInserts[I];
+    Result = IRB.CreateInsertElement(Result, Lanes[i].V,
+                                     ConstantInt::get(Int32Ty, i));
+  }
+
+  IE.replaceAllUsesWith(Result);
+  // The chain of now-dead insertelement / extractelement / shufflevector
+  // instructions can be deleted.
+  KillList.push_back(&IE);
+  return true;
+}
+
+uint64_t CombineVectorInstructions::getElementSize(VectorType *VecTy) const {
+  Type *ElemTy = VecTy->getElementType();
+  uint64_t ElemBitSize = DL->getTypeSizeInBits(ElemTy);
+  uint64_t ElemByteSize = DL->getTypeAllocSize(ElemTy);
+  if (ElemBitSize != CHAR_BIT * ElemByteSize)
+    return 0;
+  return ElemByteSize;
+}
+
+Constant *CombineVectorInstructions::foldConstantLoad(LoadInst *L) const {
+  if (!L->isSimple())
+    return 0;
+  int64_t Offset;
+  GlobalVariable *GV = dyn_cast<GlobalVariable>(
+      getBaseAndOffset(L->getPointerOperand(), *DL, Offset));
+  if (!GV || !GV->isConstant() || !GV->hasDefinitiveInitializer() ||
+      Offset < 0)
+    return 0;
+  LLVMContext &C = L->getContext();
+  Constant *Ptr = ConstantExpr::getBitCast(GV, Type::getInt8PtrTy(C));
+  if (Offset)
+    Ptr = ConstantExpr::getInBoundsGetElementPtr(
+        Ptr, ConstantInt::get(Type::getInt32Ty(C), Offset));
+  Ptr = ConstantExpr::getBitCast(Ptr, L->getPointerOperand()->getType());
+  Constant *Folded = ConstantFoldLoadFromConstPtr(Ptr, DL);
+  if (!Folded || isa<ConstantExpr>(Folded))
+    return 0;
+  return Folded;
+}
+
+bool CombineVectorInstructions::combineLoads(InsertElementInst &IE) {
+  // Only look at the last insertelement of a chain.
+  if (!DL || (IE.hasOneUse() && isa<InsertElementInst>(IE.use_back())))
+    return false;
+  VectorType *VecTy = IE.getType();
+  unsigned NumElts = VecTy->getNumElements();
+
+  // Find the load of each element, the chain must start from undef and set
+  // each element exactly once.
+  SmallVector<LoadInst *, 16> Loads(NumElts, 0);
+  Value *V = &IE;
+  while (InsertElementInst *I = dyn_cast<InsertElementInst>(V)) {
+    ConstantInt *Idx = dyn_cast<ConstantInt>(I->getOperand(2));
+    LoadInst *L = dyn_cast<LoadInst>(I->getOperand(1));
+    if (!Idx || Idx->getZExtValue() >= NumElts || !L || !L->isSimple() ||
+        L->getParent() != IE.getParent() || Loads[Idx->getZExtValue()])
+      return false;
+    Loads[Idx->getZExtValue()] = L;
+    V = I->getOperand(0);
+  }
+  if (!isa<UndefValue>(V))
+    return false;
+
+  // Re-materialize constant vectors whose elements were loaded one by one,
+  // such as vectors of i1.
+  SmallVector<Constant *, 16> Elts;
+  for (unsigned i = 0; i != NumElts; ++i) {
+    Constant *Elt = Loads[i] ? foldConstantLoad(Loads[i]) : 0;
+    if (!Elt)
+      break;
+    Elts.push_back(Elt);
+  }
+  if (Elts.size() == NumElts) {
+    IE.replaceAllUsesWith(ConstantVector::get(Elts));
+    KillList.push_back(&IE);
+    return true;
+  }
+
+  uint64_t ElemSize = getElementSize(VecTy);
+  if (!ElemSize)
+    return false;
+
+  // The elements must be loaded from consecutive addresses.
+  int64_t BaseOffset = 0;
+  Value *Base = 0;
+  for (unsigned i = 0; i != NumElts; ++i) {
+    if (!Loads[i])
+      return false;
+    int64_t Offset;
+    Value *B = getBaseAndOffset(Loads[i]->getPointerOperand(), *DL, Offset);
+    if (i == 0) {
+      Base = B;
+      BaseOffset = Offset;
+    } else if (B != Base || Offset != BaseOffset + int64_t(i * ElemSize))
+      return false;
+  }
+
+  // The vector load replaces the last of the element loads, nothing may
+  // write to memory between the first and the last element load.
+  SmallPtrSet<LoadInst *, 16> Pending(Loads.begin(), Loads.end());
+  if (Pending.size() != NumElts)
+    return false;
+  LoadInst *Last = 0;
+  for (BasicBlock::iterator I = &IE; !Pending.empty();) {
+    --I;
+    if (LoadInst *L = dyn_cast<LoadInst>(I))
+      if (Pending.erase(L)) {
+        if (!Last)
+          Last = L;
+        continue;
+      }
+    if (Last && I->mayWriteToMemory())
+      return false;
+  }
+
+  LoadInst *First = Loads[0];
+  unsigned Align = First->getAlignment()
+                       ? First->getAlignment()
+                       : DL->getABITypeAlignment(VecTy->getElementType());
+  unsigned AS = First->getPointerAddressSpace();
+  IRBuilder<> IRB(Last->getParent(), llvm::next(BasicBlock::iterator(Last)));
+  Value *Ptr = IRB.CreateBitCast(First->getPointerOperand(),
+                                 VecTy->getPointerTo(AS));
+  LoadInst *VecLoad = IRB.CreateAlignedLoad(Ptr, Align);
+  VecLoad->setSynchScope(First->getSynchScope());
+  IE.replaceAllUsesWith(VecLoad);
+  // The element loads are killed along with the insertelement chain,
+  // unless they have other users.
+  KillList.push_back(&IE);
+  return true;
+}
+
+bool CombineVectorInstructions::visitLoadInst(LoadInst &LI) {
+  // Re-materialize loads of constant vectors.
+  if (!DL || !LI.getType()->isVectorTy())
+    return false;
+  Constant *C = foldConstantLoad(&LI);
+  if (!C)
+    return false;
+  LI.replaceAllUsesWith(C);
+  KillList.push_back(&LI);
+  return true;
+}
+
+bool CombineVectorInstructions::visitStoreInst(StoreInst &SI) {
+  // Re-combine stores of all the elements of a vector to consecutive
+  // addresses, starting with this store.
+  if (!DL || !SI.isSimple())
+    return false;
+  ExtractElementInst *EI = dyn_cast<ExtractElementInst>(SI.getValueOperand());
+  if (!EI)
+    return false;
+  Value *Vec = EI->getVectorOperand();
+  VectorType *VecTy = cast<VectorType>(Vec->getType());
+  unsigned NumElts = VecTy->getNumElements();
+  uint64_t ElemSize = getElementSize(VecTy);
+  if (!ElemSize)
+    return false;
+
+  // The stores must be adjacent to each other, except for instructions
+  // which don't access memory.
+  SmallVector<StoreInst *, 16> Stores(NumElts, 0);
+  unsigned NumFound = 0;
+  StoreInst *Last = 0;
+  Value *Base = 0;
+  int64_t BaseOffset = 0;
+  for (BasicBlock::iterator I = &SI, E = SI.getParent()->end();
+       I != E && NumFound != NumElts; ++I) {
+    if (StoreInst *S = dyn_cast<StoreInst>(I)) {
+      ExtractElementInst *SEI =
+          dyn_cast<ExtractElementInst>(S->getValueOperand());
+      ConstantInt *Idx =
+          SEI ? dyn_cast<ConstantInt>(SEI->getIndexOperand()) : 0;
+      if (S->isSimple() && SEI && SEI->getVectorOperand() == Vec && Idx &&
+          Idx->getZExtValue() < NumElts && !Stores[Idx->getZExtValue()]) {
+        unsigned i = Idx->getZExtValue();
+        int64_t Offset;
+        Value *B = getBaseAndOffset(S->getPointerOperand(), *DL, Offset);
+        if (!Base) {
+          Base = B;
+          BaseOffset = Offset - int64_t(i * ElemSize);
+        }
+        if (B == Base && Offset == BaseOffset + int64_t(i * ElemSize)) {
+          Stores[i] = S;
+          Last = S;
+          ++NumFound;
+          continue;
+        }
+      }
+    }
+    if (I->mayReadOrWriteMemory())
+      return false;
+  }
+  if (NumFound != NumElts)
+    return false;
+
+  StoreInst *First = Stores[0];
+  unsigned Align =
+      First->getAlignment()
+          ? First->getAlignment()
+          : DL->getABITypeAlignment(VecTy->getElementType());
+  unsigned AS = First->getPointerAddressSpace();
+  IRBuilder<> IRB(Last->getParent(), llvm::next(BasicBlock::iterator(Last)));
+  Value *Ptr = IRB.CreateBitCast(First->getPointerOperand(),
+                                 VecTy->getPointerTo(AS));
+  StoreInst *VecStore = IRB.CreateAlignedStore(Vec, Ptr, Align);
+  VecStore->setSynchScope(First->getSynchScope());
+  KillList.append(Stores.begin(), Stores.end());
+  return true;
+}
+
 void CombineVectorInstructions::emptyKillList(BasicBlock &B) {
   const TargetLibraryInfo *TLI = &getAnalysis<TargetLibraryInfo>();
   while (!KillList.empty()) {
     Instruction *KillMe = KillList.pop_back_val();
-    if (isa<LoadInst>(KillMe) || isa<StoreInst>(KillMe)) {
-      // Load/store instructions can't traditionally be killed since
-      // they have side-effects. This pass combines load/store
-      // instructions and touches all the memory that the original
-      // load/store touched, it's therefore legal to kill these
-      // load/store instructions.
-      //
-      // TODO(jfb) Eliminate load/store once their combination is
-      //           implemented.
+    if (StoreInst *SI = dyn_cast<StoreInst>(KillMe)) {
+      // Store instructions can't traditionally be killed since they
+      // have side-effects. This pass combines store instructions and
+      // touches all the memory that the original stores touched, it's
+      // therefore legal to kill these stores.
+      Value *Val = SI->getValueOperand();
+      Value *Ptr = SI->getPointerOperand();
+      SI->eraseFromParent();
+      RecursivelyDeleteTriviallyDeadInstructions(Val, TLI);
+      RecursivelyDeleteTriviallyDeadInstructions(Ptr, TLI);
     } else
       RecursivelyDeleteTriviallyDeadInstructions(KillMe, TLI);
   }
@@ -32,12 +32,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Pass.h"
 #include "llvm/Transforms/NaCl.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
 
 using namespace llvm;
 
@@ -136,8 +138,44 @@ static bool ConvertFunction(Function *Func) {
   return true;
 }
 
-// Convert the given call to use normalized argument/return types.
-static bool ConvertCall(CallInst *Call) {
+// CopyCall() uses argument overloading so that it can be used by the
+// template ConvertCall().
+static CallInst *CopyCall(CallInst *Original, Value *Callee,
+                          ArrayRef<Value*> Args) {
+  CallInst *NewCall = CallInst::Create(Callee, Args, "", Original);
+  NewCall->setTailCall(Original->isTailCall());
+  return NewCall;
+}
+
+static InvokeInst *CopyCall(InvokeInst *Original, Value *Callee,
+                            ArrayRef<Value*> Args) {
+  return InvokeInst::Create(Callee, Original->getNormalDest(),
+                            Original->getUnwindDest(), Args, "", Original);
+}
+
+// Returns where to truncate the result of the given call.
+static Instruction *GetResultInsertPt(CallInst *Call) {
+  return llvm::next(BasicBlock::iterator(Call));
+}
+
+static Instruction *GetResultInsertPt(InvokeInst *Invoke) {
+  // The result is only available on the normal edge, which gets a
+  // block of its own if the normal destination has other predecessors.
+  // The original invoke is still in the same block as this one.
+  BasicBlock *Dest = Invoke->getNormalDest();
+  if (!Dest->getUniquePredecessor())
+    return SplitCriticalEdge(Invoke, 0)->getFirstInsertionPt();
+  // The PHI nodes of Dest come before the truncation, so they can't use
+  // it.  They have a single entry, such as LCSSA PHI nodes, and are
+  // replaced with their incoming value.
+  FoldSingleEntryPHINodes(Dest);
+  return Dest->getFirstInsertionPt();
+}
+
+// Convert the given call or invoke to use normalized argument/return
+// types.
+template <class InstType>
+static bool ConvertCall(InstType *Call) {
   // Don't try to change calls to intrinsics.
   if (isa<IntrinsicInst>(Call))
     return false;
@@ -163,17 +201,16 @@ static bool ConvertCall(CallInst *Call) {
   Value *CastFunc =
     CopyDebug(new BitCastInst(Call->getCalledValue(), NFTy->getPointerTo(),
                               Call->getName() + ".arg_cast", Call), Call);
-  CallInst *NewCall = CallInst::Create(CastFunc, Args, "", Call);
+  InstType *NewCall = CopyCall(Call, CastFunc, Args);
   CopyDebug(NewCall, Call);
   NewCall->takeName(Call);
   NewCall->setAttributes(Call->getAttributes());
   NewCall->setCallingConv(Call->getCallingConv());
-  NewCall->setTailCall(Call->isTailCall());
   Value *Result = NewCall;
   if (FTy->getReturnType() != NFTy->getReturnType()) {
     Result = CopyDebug(new TruncInst(NewCall, FTy->getReturnType(),
                                      NewCall->getName() + ".ret_trunc",
-                                     Call), Call);
+                                     GetResultInsertPt(NewCall)), Call);
   }
   Call->replaceAllUsesWith(Result);
   Call->eraseFromParent();
@@ -200,9 +237,8 @@ bool ExpandSmallArguments::runOnModule(Module &M) {
         Instruction *Inst = Iter++;
         if (CallInst *Call = dyn_cast<CallInst>(Inst)) {
           Changed |= ConvertCall(Call);
-        } else if (isa<InvokeInst>(Inst)) {
-          report_fatal_error(
-              "ExpandSmallArguments does not handle invoke instructions");
+        } else if (InvokeInst *Invoke = dyn_cast<InvokeInst>(Inst)) {
+          Changed |= ConvertCall(Invoke);
         }
       }
     }
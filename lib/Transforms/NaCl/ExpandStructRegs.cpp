@@ -22,6 +22,10 @@
 // ExpandStructRegs does not handle:
 //
 //  * Nested struct types.
+//  * The {i8*, i32} values of landingpad instructions, which only
+//    exist when zero-cost exception handling is enabled.  These are
+//    left in place, along with the extractvalue and insertvalue
+//    instructions that read and rebuild them for resume.
 //  * Array types.
 //  * Function types containing arguments or return values of struct
 //    type without the "byval" or "sret" attributes.  Since by-value
@@ -38,6 +42,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/Function.h"
@@ -191,7 +196,9 @@ static void SplitUpLoad(LoadInst *Load) {
   Load->eraseFromParent();
 }
 
-static void ExpandExtractValue(ExtractValueInst *EV) {
+// Returns false if the extractvalue was left in place because it
+// reads the result of a landingpad.
+static bool ExpandExtractValue(ExtractValueInst *EV) {
   // Search for the insertvalue instruction that inserts the struct
   // field referenced by this extractvalue instruction.
   Value *StructVal = EV->getAggregateOperand();
@@ -212,6 +219,9 @@ static void ExpandExtractValue(ExtractValueInst *EV) {
     } else if (Constant *C = dyn_cast<Constant>(StructVal)) {
       ResultField = ConstantExpr::getExtractValue(C, EV->getIndices());
       break;
+    } else if (isa<LandingPadInst>(StructVal)) {
+      EV->setOperand(0, StructVal);
+      return false;
     } else {
       errs() << "Value: " << *StructVal << "\n";
       report_fatal_error("Unrecognized struct value");
@@ -219,6 +229,7 @@ static void ExpandExtractValue(ExtractValueInst *EV) {
   }
   EV->replaceAllUsesWith(ResultField);
   EV->eraseFromParent();
+  return true;
 }
 
 bool ExpandStructRegs::runOnFunction(Function &Func) {
@@ -260,20 +271,39 @@ bool ExpandStructRegs::runOnFunction(Function &Func) {
   // the insertvalue instructions for later deletion so that we do not
   // need to make extra passes across the whole function.
   SmallVector<Instruction *, 10> ToErase;
+  SmallPtrSet<Instruction *, 4> ToKeep;
   for (Function::iterator BB = Func.begin(), E = Func.end();
        BB != E; ++BB) {
     for (BasicBlock::iterator Iter = BB->begin(), E = BB->end();
          Iter != E; ) {
       Instruction *Inst = Iter++;
       if (ExtractValueInst *EV = dyn_cast<ExtractValueInst>(Inst)) {
-        ExpandExtractValue(EV);
-        Changed = true;
+        if (ExpandExtractValue(EV))
+          Changed = true;
       } else if (isa<InsertValueInst>(Inst)) {
         ToErase.push_back(Inst);
         Changed = true;
+      } else if (ResumeInst *Resume = dyn_cast<ResumeInst>(Inst)) {
+        // A landingpad value that was split up by SplitUpPHINode or
+        // SplitUpSelect is rebuilt for resume.
+        Value *StructVal = Resume->getValue();
+        while (InsertValueInst *IV = dyn_cast<InsertValueInst>(StructVal)) {
+          ToKeep.insert(IV);
+          StructVal = IV->getAggregateOperand();
+        }
       }
     }
   }
+  if (!ToKeep.empty()) {
+    SmallVector<Instruction *, 10> Remaining;
+    for (SmallVectorImpl<Instruction *>::iterator I = ToErase.begin(),
+             E = ToErase.end();
+         I != E; ++I) {
+      if (!ToKeep.count(*I))
+        Remaining.push_back(*I);
+    }
+    ToErase.swap(Remaining);
+  }
   // Delete the insertvalue instructions.  These can reference each
   // other, so we must do dropAllReferences() before doing
   // eraseFromParent(), otherwise we will try to erase instructions
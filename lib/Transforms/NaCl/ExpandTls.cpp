@@ -12,7 +12,9 @@
 //
 // A reference to the address of a TLS variable is expanded into code
 // which gets the current thread's thread pointer using
-// @llvm.nacl.read.tp() and adds a fixed offset.
+// @llvm.nacl.read.tp() and adds a fixed offset.  Each reference gets its
+// own call; the translator's HoistNaClReadTp pass merges them so that the
+// thread pointer is read once per function.
 //
 // This pass allocates the offsets (relative to the thread pointer)
 // that will be used for TLS variables.  It sets up the global
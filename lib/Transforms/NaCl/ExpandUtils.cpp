@@ -43,6 +43,16 @@ void llvm::PhiSafeReplaceUses(Use *U, Value *NewVal) {
   }
 }
 
+void llvm::ReplaceAllUsesWithMap(const DenseMap<Value *, Value *> &Map) {
+  for (DenseMap<Value *, Value *>::const_iterator I = Map.begin(),
+           E = Map.end(); I != E; ++I) {
+    // Chained replacements would make the result depend on the map's
+    // iteration order.
+    assert(!Map.count(I->second) && "Value mapped to a value that is replaced");
+    I->first->replaceAllUsesWith(I->second);
+  }
+}
+
 Instruction *llvm::CopyDebug(Instruction *NewInst, Instruction *Original) {
   NewInst->setDebugLoc(Original->getDebugLoc());
   return NewInst;
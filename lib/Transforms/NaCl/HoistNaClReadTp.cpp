@@ -0,0 +1,129 @@
+//===- HoistNaClReadTp.cpp - Read the thread pointer once per function ----===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// ExpandTls turns each reference to a TLS variable into a call to
+// @llvm.nacl.read.tp() plus a fixed offset.  On x86-64, and on x86-32
+// with -mtls-use-call, each of those calls is lowered to a call to
+// __nacl_read_tp(), which the backend neither CSEs across basic blocks
+// nor hoists out of loops.
+//
+// The thread pointer doesn't change while a function runs, so this pass
+// replaces all the @llvm.nacl.read.tp() calls in a function with a single
+// call.  The call is placed in the nearest common dominator of the calls
+// it replaces, and is then hoisted out of the loops containing that
+// block, so that a function which accesses several thread-locals, or
+// accesses them in a loop, reads the thread pointer once.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Analysis/Dominators.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Transforms/NaCl.h"
+
+using namespace llvm;
+
+namespace {
+class HoistNaClReadTp : public FunctionPass {
+public:
+  static char ID; // Pass identification, replacement for typeid
+  HoistNaClReadTp() : FunctionPass(ID) {
+    initializeHoistNaClReadTpPass(*PassRegistry::getPassRegistry());
+  }
+
+  virtual void getAnalysisUsage(AnalysisUsage &AU) const {
+    AU.addRequired<DominatorTree>();
+    AU.addRequired<LoopInfo>();
+    AU.setPreservesCFG();
+  }
+
+  virtual bool runOnFunction(Function &F);
+};
+}
+
+char HoistNaClReadTp::ID = 0;
+INITIALIZE_PASS_BEGIN(HoistNaClReadTp, "hoist-nacl-read-tp",
+                      "Read the NaCl thread pointer once per function",
+                      false, false)
+INITIALIZE_PASS_DEPENDENCY(DominatorTree)
+INITIALIZE_PASS_DEPENDENCY(LoopInfo)
+INITIALIZE_PASS_END(HoistNaClReadTp, "hoist-nacl-read-tp",
+                    "Read the NaCl thread pointer once per function",
+                    false, false)
+
+bool HoistNaClReadTp::runOnFunction(Function &F) {
+  Function *ReadTp =
+      F.getParent()->getFunction(Intrinsic::getName(Intrinsic::nacl_read_tp));
+  if (!ReadTp)
+    return false;
+
+  DominatorTree &DT = getAnalysis<DominatorTree>();
+  LoopInfo &LI = getAnalysis<LoopInfo>();
+
+  // Scan F itself rather than the uses of ReadTp, which are spread over the
+  // whole module.  Calls in unreachable blocks are left alone, they aren't
+  // in the dominator tree.
+  SmallVector<CallInst *, 8> Calls;
+  BasicBlock *Dom = 0;
+  for (Function::iterator BB = F.begin(), E = F.end(); BB != E; ++BB) {
+    if (!DT.isReachableFromEntry(BB))
+      continue;
+    for (BasicBlock::iterator I = BB->begin(), IE = BB->end(); I != IE; ++I) {
+      IntrinsicInst *II = dyn_cast<IntrinsicInst>(I);
+      if (!II || II->getIntrinsicID() != Intrinsic::nacl_read_tp)
+        continue;
+      Calls.push_back(II);
+      Dom = Dom ? DT.findNearestCommonDominator(Dom, BB) : &*BB;
+    }
+  }
+  if (Calls.empty())
+    return false;
+
+  // Reading the thread pointer can't fault, so it can be hoisted into the
+  // block from which each loop is entered even if the loop doesn't always
+  // read it.
+  while (Loop *L = LI.getLoopFor(Dom)) {
+    BasicBlock *Pred = L->getLoopPredecessor();
+    if (!Pred)
+      break;
+    Dom = Pred;
+  }
+
+  // Read the thread pointer before the first call in Dom, or at the end
+  // of Dom if the calls are all in blocks it dominates.
+  Instruction *InsertPt = Dom->getTerminator();
+  for (BasicBlock::iterator I = Dom->begin(), E = Dom->end(); I != E; ++I) {
+    IntrinsicInst *II = dyn_cast<IntrinsicInst>(I);
+    if (II && II->getIntrinsicID() == Intrinsic::nacl_read_tp) {
+      InsertPt = II;
+      break;
+    }
+  }
+  if (Calls.size() == 1 && Calls[0] == InsertPt)
+    return false;
+
+  CallInst *ThreadPtr = CallInst::Create(ReadTp, "thread_ptr", InsertPt);
+  for (SmallVectorImpl<CallInst *>::iterator I = Calls.begin(),
+                                             E = Calls.end();
+       I != E; ++I) {
+    (*I)->replaceAllUsesWith(ThreadPtr);
+    (*I)->eraseFromParent();
+  }
+  return true;
+}
+
+FunctionPass *llvm::createHoistNaClReadTpPass() {
+  return new HoistNaClReadTp();
+}
@@ -27,8 +27,23 @@ EnableSjLjEH("enable-pnacl-sjlj-eh",
                       "as part of the pnacl-abi-simplify passes"),
              cl::init(false));
 
+static cl::opt<bool>
+EnableZeroCostEH("enable-pnacl-zero-cost-eh",
+                 cl::desc("Keep invoke, landingpad and resume instructions "
+                          "so that the translator emits unwind tables for "
+                          "C++ exception handling. The result is not stable "
+                          "PNaCl bitcode"),
+                 cl::init(false));
+
 void llvm::PNaClABISimplifyAddPreOptPasses(PassManagerBase &PM) {
-  if (EnableSjLjEH) {
+  if (EnableSjLjEH && EnableZeroCostEH)
+    report_fatal_error("-enable-pnacl-sjlj-eh and -enable-pnacl-zero-cost-eh "
+                       "are mutually exclusive");
+  if (EnableZeroCostEH) {
+    // Exception handling is left to the translator, which emits the
+    // unwind tables and landing pads of the native target. The
+    // non-exceptional path of an invoke is then an ordinary call.
+  } else if (EnableSjLjEH) {
     // This comes before ExpandTls because it introduces references to
     // a TLS variable, __pnacl_eh_stack.  This comes before
     // InternalizePass because it assumes various variables (including
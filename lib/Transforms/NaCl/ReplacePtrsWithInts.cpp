@@ -244,11 +244,12 @@ void FunctionConverter::convertInPlace(Instruction *Inst) {
 
 void FunctionConverter::eraseReplacedInstructions() {
   bool Error = false;
+  DenseMap<Value *, Value *> PlaceholderMap;
   for (DenseMap<Value *, RewrittenVal>::iterator I = RewriteMap.begin(),
            E = RewriteMap.end(); I != E; ++I) {
     if (I->second.Placeholder) {
       if (I->second.NewIntVal) {
-        I->second.Placeholder->replaceAllUsesWith(I->second.NewIntVal);
+        PlaceholderMap[I->second.Placeholder] = I->second.NewIntVal;
       } else {
         errs() << "Not converted: " << *I->first << "\n";
         Error = true;
@@ -257,6 +258,7 @@ void FunctionConverter::eraseReplacedInstructions() {
   }
   if (Error)
     report_fatal_error("Case not handled in ReplacePtrsWithInts");
+  ReplaceAllUsesWithMap(PlaceholderMap);
 
   // Delete the placeholders in a separate pass.  This means that if
   // one placeholder is accidentally rewritten to another, we will get
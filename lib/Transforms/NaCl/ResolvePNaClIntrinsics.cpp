@@ -14,6 +14,11 @@
 // pass. They are separate because one is a ModulePass and the other is
 // a FunctionPass.
 //
+// Atomics keep the memory order they were given, and fences which are
+// only separated by instructions that don't access memory are merged,
+// so that each target can use its cheapest correct instruction
+// sequences.
+//
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/SmallVector.h"
@@ -311,8 +316,9 @@ private:
     // Only valid values should pass validation.
     default: llvm_unreachable("unknown memory order");
     case NaCl::MemoryOrderRelaxed: return Monotonic;
-    // TODO Consume is unspecified by LLVM's internal IR.
-    case NaCl::MemoryOrderConsume: return SequentiallyConsistent;
+    // Consume is unspecified by LLVM's internal IR, acquire is the
+    // closest stronger order.
+    case NaCl::MemoryOrderConsume: return Acquire;
     case NaCl::MemoryOrderAcquire: return Acquire;
     case NaCl::MemoryOrderRelease: return Release;
     case NaCl::MemoryOrderAcquireRelease: return AcquireRelease;
@@ -518,6 +524,53 @@ private:
 };
 }
 
+/// Returns the weakest ordering that is at least as strong as both fence
+/// orderings \p A and \p B.
+static AtomicOrdering joinFenceOrderings(AtomicOrdering A, AtomicOrdering B) {
+  if (A == SequentiallyConsistent || B == SequentiallyConsistent)
+    return SequentiallyConsistent;
+  if (A == B)
+    return A;
+  // Any two of Acquire, Release and AcquireRelease.
+  return AcquireRelease;
+}
+
+/// Compiler barriers such as asm("":::"memory") don't access memory,
+/// and a fence is also a compiler barrier.
+static bool isCompilerBarrier(const Instruction *I) {
+  if (const CallInst *Call = dyn_cast<CallInst>(I))
+    if (const InlineAsm *Asm = dyn_cast<InlineAsm>(Call->getCalledValue()))
+      return Asm->isAsmMemory();
+  return false;
+}
+
+/// Merge each fence into the previous fence of its basic block when only
+/// instructions that don't access memory separate them.  The fences then
+/// order the same memory accesses, so the first one takes the strongest
+/// ordering of both and the second one is removed.
+static bool coalesceFences(Function &F) {
+  bool Changed = false;
+  for (Function::iterator BB = F.begin(), E = F.end(); BB != E; ++BB) {
+    FenceInst *Prev = 0;
+    for (BasicBlock::iterator II = BB->begin(), IE = BB->end(); II != IE;) {
+      Instruction *I = II++;
+      if (FenceInst *Fence = dyn_cast<FenceInst>(I)) {
+        if (Prev && Prev->getSynchScope() == Fence->getSynchScope()) {
+          Prev->setOrdering(
+              joinFenceOrderings(Prev->getOrdering(), Fence->getOrdering()));
+          Fence->eraseFromParent();
+          Changed = true;
+        } else {
+          Prev = Fence;
+        }
+      } else if (I->mayReadOrWriteMemory() && !isCompilerBarrier(I)) {
+        Prev = 0;
+      }
+    }
+  }
+  return Changed;
+}
+
 bool ResolvePNaClIntrinsics::visitCalls(
     ResolvePNaClIntrinsics::CallResolver &Resolver) {
   bool Changed = false;
@@ -564,6 +617,8 @@ bool ResolvePNaClIntrinsics::runOnFunction(Function &F) {
       F, Intrinsic::nacl_atomic_is_lock_free, IsLockFreeToConstant());
   Changed |= visitCalls(IsLockFreeResolver);
 
+  Changed |= coalesceFences(F);
+
   return Changed;
 }
 
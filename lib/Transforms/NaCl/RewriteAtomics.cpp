@@ -11,7 +11,11 @@
 // instead of LLVM's regular IR instructions.
 //
 // All of the above are transformed into one of the
-// @llvm.nacl.atomic.* intrinsics.
+// @llvm.nacl.atomic.* intrinsics.  All memory orders are promoted to
+// sequential consistency, which is the only memory order that stable
+// PNaCl translators accept.  With -enable-pnacl-memory-orders the memory
+// order of atomics is kept instead, so that the translator can pick the
+// cheapest correct instruction sequence for each target.
 //
 //===----------------------------------------------------------------------===//
 
@@ -25,6 +29,7 @@
 #include "llvm/IR/NaClAtomicIntrinsics.h"
 #include "llvm/InstVisitor.h"
 #include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/NaCl.h"
@@ -33,6 +38,14 @@
 
 using namespace llvm;
 
+static cl::opt<bool>
+EnableMemoryOrders("enable-pnacl-memory-orders",
+                   cl::desc("Keep the memory order of atomics instead of "
+                            "promoting it to seq_cst. The result is not "
+                            "stable PNaCl bitcode: only translators which "
+                            "accept weaker memory orders can translate it."),
+                   cl::init(false));
+
 namespace {
 class RewriteAtomics : public ModulePass {
 public:
@@ -88,6 +101,10 @@ private:
   template <class Instruction>
   ConstantInt *freezeMemoryOrder(const Instruction &I) const;
 
+  /// Create the failure memory order of compare exchange \p I, which is
+  /// its success memory order without the release part.
+  ConstantInt *freezeFailureMemoryOrder(const AtomicCmpXchgInst &I) const;
+
   /// Sanity-check that instruction \p I which has pointer and value
   /// parameters have matching sizes \p BitSize for the type-pointed-to
   /// and the value's type \p T.
@@ -184,12 +201,25 @@ ConstantInt *AtomicVisitor::freezeMemoryOrder(const Instruction &I) const {
     }
   }
 
-  // TODO For now only sequential consistency is allowed.
-  AO = NaCl::MemoryOrderSequentiallyConsistent;
+  // Stable translators only accept sequential consistency.
+  if (!EnableMemoryOrders)
+    AO = NaCl::MemoryOrderSequentiallyConsistent;
 
   return ConstantInt::get(Type::getInt32Ty(C), AO);
 }
 
+ConstantInt *
+AtomicVisitor::freezeFailureMemoryOrder(const AtomicCmpXchgInst &I) const {
+  ConstantInt *Success = freezeMemoryOrder(I);
+  switch (Success->getZExtValue()) {
+  default: return Success;
+  case NaCl::MemoryOrderRelease:
+    return ConstantInt::get(Type::getInt32Ty(C), NaCl::MemoryOrderRelaxed);
+  case NaCl::MemoryOrderAcquireRelease:
+    return ConstantInt::get(Type::getInt32Ty(C), NaCl::MemoryOrderAcquire);
+  }
+}
+
 void AtomicVisitor::checkSizeMatchesType(const Instruction &I, unsigned BitSize,
                                          const Type *T) const {
   Type *IntType = Type::getIntNTy(C, BitSize);
@@ -315,7 +345,7 @@ void AtomicVisitor::visitAtomicCmpXchgInst(AtomicCmpXchgInst &I) {
   //      IR implicitly drops the Release part of the specified memory
   //      order on failure.
   Value *Args[] = { PH.P, I.getCompareOperand(), I.getNewValOperand(),
-                    freezeMemoryOrder(I), freezeMemoryOrder(I) };
+                    freezeMemoryOrder(I), freezeFailureMemoryOrder(I) };
   replaceInstructionWithIntrinsicCall(I, Intrinsic::nacl_atomic_cmpxchg,
                                       PH.OriginalPET, PH.PET, Args);
 }
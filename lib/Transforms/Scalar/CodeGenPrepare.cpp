@@ -142,6 +142,9 @@ FunctionPass *llvm::createCodeGenPreparePass(const TargetMachine *TM) {
 }
 
 bool CodeGenPrepare::runOnFunction(Function &F) {
+  if (skipOptnoneFunction(F)) // @LOCALMOD
+    return false;
+
   bool EverMadeChange = false;
 
   ModifiedDT = false;
@@ -4912,6 +4912,13 @@ void LoopStrengthReduce::getAnalysisUsage(AnalysisUsage &AU) const {
 }
 
 bool LoopStrengthReduce::runOnLoop(Loop *L, LPPassManager & /*LPM*/) {
+  // @LOCALMOD-BEGIN
+  // Functions moved to the fast code generation path are not optimized.
+  if (L->getHeader()->getParent()->getAttributes().hasAttribute(
+          AttributeSet::FunctionIndex, Attribute::OptimizeNone))
+    return false;
+  // @LOCALMOD-END
+
   bool Changed = false;
 
   // Run the main LSR transformation.
@@ -0,0 +1,28 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=core2 -combiner-node-budget=1 | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=core2 -combiner-node-budget=1 -stats 2>&1 | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; Once the DAG combiner budget is used up, the remaining scalar nodes are no
+; longer combined generically, but the code is still selected correctly.
+
+; STATS: dagcombine {{.*}} Number of add nodes visited
+; STATS: dagcombine {{.*}} Number of combiner runs cut short by the budget
+; STATS: dagcombine {{.*}} Number of dag nodes visited by the combiner
+
+; CHECK-LABEL: test1:
+; CHECK: ret
+define i32 @test1(i32 %a, i32 %b) nounwind {
+  %x = add i32 %a, 0
+  %y = shl i32 %x, 2
+  %z = add i32 %y, %b
+  %w = xor i32 %z, -1
+  %v = xor i32 %w, -1
+  ret i32 %v
+}
+
+; CHECK-LABEL: test2:
+; CHECK: ret
+define float @test2(<4 x float> %a) nounwind {
+  %e = extractelement <4 x float> %a, i32 3
+  ret float %e
+}
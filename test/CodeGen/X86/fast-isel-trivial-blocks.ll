@@ -0,0 +1,50 @@
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=core2 -verify-machineinstrs -fast-isel-trivial-blocks | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=core2 -fast-isel-trivial-blocks -stats 2>&1 | FileCheck %s --check-prefix=STATS
+; REQUIRES: asserts
+
+; Blocks which only contain an unconditional branch are selected with
+; FastISel when -fast-isel-trivial-blocks is given, and the PHI copies they
+; feed are still emitted correctly.
+
+; STATS: 2 isel {{.*}} Number of trivial blocks selected by fast isel
+
+; CHECK-LABEL: test1:
+; CHECK: testl %edi, %edi
+; CHECK-NEXT: jne
+; CHECK: movl %esi, %edi
+; CHECK: movl %edi, %eax
+; CHECK-NEXT: ret
+define i32 @test1(i32 %a, i32 %b) nounwind {
+entry:
+  %c = icmp eq i32 %a, 0
+  br i1 %c, label %trivial, label %merge
+trivial:
+  br label %merge
+merge:
+  %r = phi i32 [ %b, %trivial ], [ %a, %entry ]
+  ret i32 %r
+}
+
+; A trivial block may start with PHI nodes; their machine PHIs exist before
+; the block is selected.
+
+; CHECK-LABEL: test2:
+; CHECK: # %join
+; CHECK-NEXT: movl %edi, %edx
+; CHECK-NEXT: # %merge
+; CHECK-NEXT: movl %edx, %eax
+; CHECK-NEXT: ret
+define i32 @test2(i32 %a, i32 %b, i32 %c) nounwind {
+entry:
+  %c0 = icmp eq i32 %a, 0
+  br i1 %c0, label %join, label %other
+other:
+  %c1 = icmp eq i32 %b, 0
+  br i1 %c1, label %join, label %merge
+join:
+  %p = phi i32 [ %a, %entry ], [ %b, %other ]
+  br label %merge
+merge:
+  %r = phi i32 [ %p, %join ], [ %c, %other ]
+  ret i32 %r
+}
@@ -0,0 +1,35 @@
+; REQUIRES: asserts
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=core2 -enable-misched -verify-misched -verify-machineinstrs -sched-huge-mem-region=4 -stats 2>&1 | FileCheck %s
+;
+; The count of memory references for -sched-huge-mem-region starts again at
+; every real barrier, here the volatile stores, so this region never gets
+; reduced memory dependencies.
+;
+; CHECK: Statistics Collected
+; CHECK-NOT: Number of scheduling regions with reduced memory dependencies
+
+define void @barriers(i32* %p, i32* %q, i32* %r) nounwind {
+entry:
+  %a0 = getelementptr i32* %p, i32 0
+  %v0 = load i32* %a0
+  %a1 = getelementptr i32* %q, i32 1
+  store i32 %v0, i32* %a1
+  %a2 = getelementptr i32* %p, i32 2
+  %v2 = load i32* %a2
+  store volatile i32 %v2, i32* %r
+  %a3 = getelementptr i32* %p, i32 3
+  %v3 = load i32* %a3
+  %a4 = getelementptr i32* %q, i32 4
+  store i32 %v3, i32* %a4
+  %a5 = getelementptr i32* %p, i32 5
+  %v5 = load i32* %a5
+  store volatile i32 %v5, i32* %r
+  %a6 = getelementptr i32* %p, i32 6
+  %v6 = load i32* %a6
+  %a7 = getelementptr i32* %q, i32 7
+  store i32 %v6, i32* %a7
+  %a8 = getelementptr i32* %p, i32 8
+  %v8 = load i32* %a8
+  store volatile i32 %v8, i32* %r
+  ret void
+}
@@ -0,0 +1,42 @@
+; REQUIRES: asserts
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=core2 -enable-misched -verify-misched -verify-machineinstrs -misched-window=8 -sched-huge-mem-region=4 -stats 2>&1 | FileCheck %s
+;
+; Test that huge regions are split into windows and that long runs of memory
+; references get chain barriers, without breaking the schedule.
+;
+; CHECK: misched {{.*}} Number of scheduling regions cut short by -misched-window
+; CHECK: misched {{.*}} Number of scheduling regions with reduced memory dependencies
+
+define void @huge(i32* %p, i32* %q, i32 %n) nounwind {
+entry:
+  %a0 = getelementptr i32* %p, i32 0
+  %v0 = load i32* %a0
+  %a1 = getelementptr i32* %q, i32 1
+  store i32 %v0, i32* %a1
+  %a2 = getelementptr i32* %p, i32 2
+  %v2 = load i32* %a2
+  %m2 = mul i32 %v2, %n
+  %a3 = getelementptr i32* %q, i32 3
+  store i32 %m2, i32* %a3
+  %a4 = getelementptr i32* %p, i32 4
+  %v4 = load i32* %a4
+  %m4 = mul i32 %v4, %m2
+  %a5 = getelementptr i32* %q, i32 5
+  store i32 %m4, i32* %a5
+  %a6 = getelementptr i32* %p, i32 6
+  %v6 = load i32* %a6
+  %m6 = add i32 %v6, %v0
+  %a7 = getelementptr i32* %q, i32 7
+  store i32 %m6, i32* %a7
+  %a8 = getelementptr i32* %p, i32 8
+  %v8 = load i32* %a8
+  %m8 = xor i32 %v8, %m6
+  %a9 = getelementptr i32* %q, i32 9
+  store i32 %m8, i32* %a9
+  %a10 = getelementptr i32* %p, i32 10
+  %v10 = load i32* %a10
+  %m10 = sub i32 %v10, %m4
+  %a11 = getelementptr i32* %q, i32 11
+  store i32 %m10, i32* %a11
+  ret void
+}
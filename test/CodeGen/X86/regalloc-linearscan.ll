@@ -0,0 +1,40 @@
+; RUN: llc < %s -mtriple=i686-unknown-linux-gnu -mcpu=core2 -regalloc=linearscan -verify-machineinstrs | FileCheck %s
+; RUN: llc < %s -mtriple=x86_64-unknown-linux-gnu -mcpu=core2 -regalloc=linearscan -verify-machineinstrs | FileCheck %s --check-prefix=X64
+
+; Values live across a call get callee-saved registers or are spilled.
+; CHECK-LABEL: across_call:
+; CHECK: calll g
+; CHECK: ret
+; X64-LABEL: across_call:
+; X64: callq g
+; X64: ret
+declare void @g()
+
+define i32 @across_call(i32 %a, i32 %b, i32 %c, i32 %d, i32 %e) nounwind {
+  %x1 = mul i32 %a, %b
+  %x2 = mul i32 %b, %c
+  %x3 = mul i32 %c, %d
+  %x4 = mul i32 %d, %e
+  %x5 = mul i32 %e, %a
+  %x6 = add i32 %a, %e
+  call void @g()
+  %s1 = add i32 %x1, %x2
+  %s2 = add i32 %x3, %x4
+  %s3 = add i32 %x5, %x6
+  %s4 = add i32 %s1, %s2
+  %s5 = add i32 %s4, %s3
+  ret i32 %s5
+}
+
+; The constrained GR32_ABCD register class of the 'q' constraint must still
+; find a register after the other outputs start at the same slot.  ECX is
+; clobbered, so on i686 that leaves AL, BL and DL.  In 64-bit mode 'q' allows
+; any register.
+; CHECK-LABEL: constrain_abcd:
+; CHECK: # q: {{%[abd]l$}}
+; X64-LABEL: constrain_abcd:
+define void @constrain_abcd(i8* %h) nounwind ssp {
+entry:
+  %0 = call { i32, i32, i32, i32, i32 } asm sideeffect "# q: ${4:b}", "=&r,=&r,=&r,=&r,=&q,r,~{ecx},~{memory},~{dirflag},~{fpsr},~{flags}"(i8* %h) nounwind
+  ret void
+}
@@ -642,98 +642,98 @@ end:                                              ; preds = %l3, %l2, %l1, %2
 ; DUMP-NEXT:    <DATA op0=97 op1=98 op2=99 op3=100/>
 ; DUMP-NEXT:  </GLOBALVAR_BLOCK>
 ; DUMP-NEXT:  <VALUE_SYMTAB>
-; DUMP-NEXT:    <ENTRY op0=2 op1=65 op2=108 op3=108 op4=111 op5=99
-; DUMP-NEXT:             op6=67 op7=97 op8=115 op9=116 op10=83 op11=105
-; DUMP-NEXT:             op12=109 op13=112 op14=108 op15=101/>
+; DUMP-NEXT:    <ENTRY op0=1 op1=102 op2=117 op3=110 op4=99/>
+; DUMP-NEXT:    <ENTRY op0=23 op1=99 op2=111 op3=109 op4=112 op5=111
+; DUMP-NEXT:           op6=117 op7=110 op8=100/>
+; DUMP-NEXT:    <ENTRY op0=27 op1=97 op2=100 op3=100 op4=101 op5=110
+; DUMP-NEXT:           op6=100 op7=95 op8=97 op9=114 op10=114 op11=97
+; DUMP-NEXT:           op12=121 op13=49/>
+; DUMP-NEXT:    <ENTRY op0=29 op1=97 op2=100 op3=100 op4=101 op5=110
+; DUMP-NEXT:           op6=100 op7=95 op8=97 op9=114 op10=114 op11=97
+; DUMP-NEXT:           op12=121 op13=51/>
+; DUMP-NEXT:    <ENTRY op0=34 op1=115 op2=104 op3=111 op4=114 op5=116/>
+; DUMP-NEXT:    <ENTRY op0=35 op1=98 op2=121 op3=116 op4=101 op5=115/>
+; DUMP-NEXT:    <ENTRY op0=4 op1=65 op2=108 op3=108 op4=111 op5=99
+; DUMP-NEXT:           op6=67 op7=97 op8=115 op9=116 op10=68 op11=101
+; DUMP-NEXT:           op12=108 op13=101 op14=116 op15=101/>
+; DUMP-NEXT:    <ENTRY op0=6 op1=65 op2=108 op3=108 op4=111 op5=99
+; DUMP-NEXT:           op6=66 op7=105 op8=116 op9=99 op10=97 op11=115
+; DUMP-NEXT:           op12=116/>
 ; DUMP-NEXT:    <ENTRY op0=10 op1=67 op2=97 op3=115 op4=116 op5=65
-; DUMP-NEXT:             op6=100 op7=100 op8=65 op9=108 op10=108 op11=111
-; DUMP-NEXT:             op12=99 op13=97/>
+; DUMP-NEXT:           op6=100 op7=100 op8=65 op9=108 op10=108 op11=111
+; DUMP-NEXT:           op12=99 op13=97/>
+; DUMP-NEXT:    <ENTRY op0=13 op1=84 op2=101 op3=115 op4=116 op5=83
+; DUMP-NEXT:           op6=97 op7=118 op8=101 op9=100 op10=80 op11=116
+; DUMP-NEXT:           op12=114 op13=84 op14=111 op15=73 op16=110 op17=116/>
+; DUMP-NEXT:    <ENTRY op0=14 op1=67 op2=97 op3=115 op4=116 op5=83
+; DUMP-NEXT:           op6=101 op7=108 op8=101 op9=99 op10=116/>
 ; DUMP-NEXT:    <ENTRY op0=20 op1=98 op2=121 op3=116 op4=101 op5=115
-; DUMP-NEXT:             op6=55/>
-; DUMP-NEXT:    <ENTRY op0=23 op1=99 op2=111 op3=109 op4=112 op5=111
-; DUMP-NEXT:             op6=117 op7=110 op8=100/>
+; DUMP-NEXT:           op6=55/>
+; DUMP-NEXT:    <ENTRY op0=21 op1=112 op2=116 op3=114 op4=95 op5=116
+; DUMP-NEXT:           op6=111 op7=95 op8=112 op9=116 op10=114/>
+; DUMP-NEXT:    <ENTRY op0=25 op1=97 op2=100 op3=100 op4=101 op5=110
+; DUMP-NEXT:           op6=100 op7=95 op8=112 op9=116 op10=114/>
+; DUMP-NEXT:    <ENTRY op0=26 op1=97 op2=100 op3=100 op4=101 op5=110
+; DUMP-NEXT:           op6=100 op7=95 op8=110 op9=101 op10=103 op11=97
+; DUMP-NEXT:           op12=116 op13=105 op14=118 op15=101/>
+; DUMP-NEXT:    <ENTRY op0=30 op1=97 op2=100 op3=100 op4=101 op5=110
+; DUMP-NEXT:           op6=100 op7=95 op8=115 op9=116 op10=114 op11=117
+; DUMP-NEXT:           op12=99 op13=116 op14=49/>
 ; DUMP-NEXT:    <ENTRY op0=5 op1=65 op2=108 op3=108 op4=111 op5=99
-; DUMP-NEXT:             op6=67 op7=97 op8=115 op9=116 op10=79 op11=112
-; DUMP-NEXT:             op12=116/>
-; DUMP-NEXT:    <ENTRY op0=32 op1=112 op2=116 op3=114 op4=95 op5=116
-; DUMP-NEXT:             op6=111 op7=95 op8=102 op9=117 op10=110 op11=99
-; DUMP-NEXT:             op12=95 op13=97 op14=108 op15=105 op16=103 op17=110/>
+; DUMP-NEXT:           op6=67 op7=97 op8=115 op9=116 op10=79 op11=112
+; DUMP-NEXT:           op12=116/>
+; DUMP-NEXT:    <ENTRY op0=11 op1=67 op2=97 op3=115 op4=116 op5=65
+; DUMP-NEXT:           op6=100 op7=100 op8=71 op9=108 op10=111 op11=98
+; DUMP-NEXT:           op12=97 op13=108/>
+; DUMP-NEXT:    <ENTRY op0=16 op1=80 op2=104 op3=105 op4=70 op5=111
+; DUMP-NEXT:           op6=114 op7=119 op8=97 op9=114 op10=100 op11=82
+; DUMP-NEXT:           op12=101 op13=102 op14=115/>
 ; DUMP-NEXT:    <ENTRY op0=18 op1=76 op2=111 op3=110 op4=103 op5=82
-; DUMP-NEXT:             op6=101 op7=97 op8=99 op9=104 op10=105 op11=110
-; DUMP-NEXT:             op12=103 op13=67 op14=97 op15=115 op16=116 op17=115/>
-; DUMP-NEXT:    <ENTRY op0=15 op1=80 op2=104 op3=105 op4=66 op5=97
-; DUMP-NEXT:             op6=99 op7=107 op8=119 op9=97 op10=114 op11=100
-; DUMP-NEXT:             op12=82 op13=101 op14=102 op15=115/>
-; DUMP-NEXT:    <ENTRY op0=26 op1=97 op2=100 op3=100 op4=101 op5=110
-; DUMP-NEXT:             op6=100 op7=95 op8=110 op9=101 op10=103 op11=97
-; DUMP-NEXT:             op12=116 op13=105 op14=118 op15=101/>
-; DUMP-NEXT:    <ENTRY op0=6 op1=65 op2=108 op3=108 op4=111 op5=99
-; DUMP-NEXT:             op6=66 op7=105 op8=116 op9=99 op10=97 op11=115
-; DUMP-NEXT:             op12=116/>
-; DUMP-NEXT:    <ENTRY op0=24 op1=112 op2=116 op3=114/>
-; DUMP-NEXT:    <ENTRY op0=25 op1=97 op2=100 op3=100 op4=101 op5=110
-; DUMP-NEXT:             op6=100 op7=95 op8=112 op9=116 op10=114/>
+; DUMP-NEXT:           op6=101 op7=97 op8=99 op9=104 op10=105 op11=110
+; DUMP-NEXT:           op12=103 op13=67 op14=97 op15=115 op16=116 op17=115/>
 ; DUMP-NEXT:    <ENTRY op0=19 op1=83 op2=119 op3=105 op4=116 op5=99
-; DUMP-NEXT:             op6=104 op7=86 op8=97 op9=114 op10=105 op11=97
-; DUMP-NEXT:             op12=98 op13=108 op14=101/>
-; DUMP-NEXT:    <ENTRY op0=0 op1=98 op2=97 op3=114/>
-; DUMP-NEXT:    <ENTRY op0=33 op1=99 op2=104 op3=97 op4=114/>
-; DUMP-NEXT:    <ENTRY op0=3 op1=65 op2=108 op3=108 op4=111 op5=99
-; DUMP-NEXT:             op6=67 op7=97 op8=115 op9=116 op10=83 op11=105
-; DUMP-NEXT:             op12=109 op13=112 op14=108 op15=101 op16=82 op17=101
-; DUMP-NEXT:             op18=118 op19=101 op20=114 op21=115 op22=101 op23=100/>
+; DUMP-NEXT:           op6=104 op7=86 op8=97 op9=114 op10=105 op11=97
+; DUMP-NEXT:           op12=98 op13=108 op14=101/>
+; DUMP-NEXT:    <ENTRY op0=24 op1=112 op2=116 op3=114/>
 ; DUMP-NEXT:    <ENTRY op0=22 op1=112 op2=116 op3=114 op4=95 op5=116
-; DUMP-NEXT:             op6=111 op7=95 op8=102 op9=117 op10=110 op11=99/>
-; DUMP-NEXT:    <ENTRY op0=12 op1=67 op2=97 op3=115 op4=116 op5=66
-; DUMP-NEXT:             op6=105 op7=110 op8=111 op9=112/>
-; DUMP-NEXT:    <ENTRY op0=11 op1=67 op2=97 op3=115 op4=116 op5=65
-; DUMP-NEXT:             op6=100 op7=100 op8=71 op9=108 op10=111 op11=98
-; DUMP-NEXT:             op12=97 op13=108/>
-; DUMP-NEXT:    <ENTRY op0=16 op1=80 op2=104 op3=105 op4=70 op5=111
-; DUMP-NEXT:             op6=114 op7=119 op8=97 op9=114 op10=100 op11=82
-; DUMP-NEXT:             op12=101 op13=102 op14=115/>
-; DUMP-NEXT:    <ENTRY op0=35 op1=98 op2=121 op3=116 op4=101 op5=115/>
-; DUMP-NEXT:    <ENTRY op0=4 op1=65 op2=108 op3=108 op4=111 op5=99
-; DUMP-NEXT:             op6=67 op7=97 op8=115 op9=116 op10=68 op11=101
-; DUMP-NEXT:             op12=108 op13=101 op14=116 op15=101/>
-; DUMP-NEXT:    <ENTRY op0=14 op1=67 op2=97 op3=115 op4=116 op5=83
-; DUMP-NEXT:             op6=101 op7=108 op8=101 op9=99 op10=116/>
-; DUMP-NEXT:    <ENTRY op0=1 op1=102 op2=117 op3=110 op4=99/>
-; DUMP-NEXT:    <ENTRY op0=21 op1=112 op2=116 op3=114 op4=95 op5=116
-; DUMP-NEXT:             op6=111 op7=95 op8=112 op9=116 op10=114/>
-; DUMP-NEXT:    <ENTRY op0=27 op1=97 op2=100 op3=100 op4=101 op5=110
-; DUMP-NEXT:             op6=100 op7=95 op8=97 op9=114 op10=114 op11=97
-; DUMP-NEXT:             op12=121 op13=49/>
+; DUMP-NEXT:           op6=111 op7=95 op8=102 op9=117 op10=110 op11=99/>
 ; DUMP-NEXT:    <ENTRY op0=28 op1=97 op2=100 op3=100 op4=101 op5=110
-; DUMP-NEXT:             op6=100 op7=95 op8=97 op9=114 op10=114 op11=97
-; DUMP-NEXT:             op12=121 op13=50/>
-; DUMP-NEXT:    <ENTRY op0=29 op1=97 op2=100 op3=100 op4=101 op5=110
-; DUMP-NEXT:             op6=100 op7=95 op8=97 op9=114 op10=114 op11=97
-; DUMP-NEXT:             op12=121 op13=51/>
-; DUMP-NEXT:    <ENTRY op0=34 op1=115 op2=104 op3=111 op4=114 op5=116/>
-; DUMP-NEXT:    <ENTRY op0=30 op1=97 op2=100 op3=100 op4=101 op5=110
-; DUMP-NEXT:             op6=100 op7=95 op8=115 op9=116 op10=114 op11=117
-; DUMP-NEXT:             op12=99 op13=116 op14=49/>
+; DUMP-NEXT:           op6=100 op7=95 op8=97 op9=114 op10=114 op11=97
+; DUMP-NEXT:           op12=121 op13=50/>
+; DUMP-NEXT:    <ENTRY op0=33 op1=99 op2=104 op3=97 op4=114/>
+; DUMP-NEXT:    <ENTRY op0=0 op1=98 op2=97 op3=114/>
+; DUMP-NEXT:    <ENTRY op0=2 op1=65 op2=108 op3=108 op4=111 op5=99
+; DUMP-NEXT:           op6=67 op7=97 op8=115 op9=116 op10=83 op11=105
+; DUMP-NEXT:           op12=109 op13=112 op14=108 op15=101/>
+; DUMP-NEXT:    <ENTRY op0=9 op1=83 op2=116 op3=111 op4=114 op5=101
+; DUMP-NEXT:           op6=71 op7=108 op8=111 op9=98 op10=97 op11=108
+; DUMP-NEXT:           op12=67 op13=97 op14=115 op15=116 op16=80 op17=116
+; DUMP-NEXT:           op18=114 op19=50 op20=73 op21=110 op22=116/>
+; DUMP-NEXT:    <ENTRY op0=12 op1=67 op2=97 op3=115 op4=116 op5=66
+; DUMP-NEXT:           op6=105 op7=110 op8=111 op9=112/>
+; DUMP-NEXT:    <ENTRY op0=15 op1=80 op2=104 op3=105 op4=66 op5=97
+; DUMP-NEXT:           op6=99 op7=107 op8=119 op9=97 op10=114 op11=100
+; DUMP-NEXT:           op12=82 op13=101 op14=102 op15=115/>
 ; DUMP-NEXT:    <ENTRY op0=31 op1=97 op2=100 op3=100 op4=101 op5=110
-; DUMP-NEXT:             op6=100 op7=95 op8=115 op9=116 op10=114 op11=117
-; DUMP-NEXT:             op12=99 op13=116 op14=50/>
-; DUMP-NEXT:    <ENTRY op0=13 op1=84 op2=101 op3=115 op4=116 op5=83
-; DUMP-NEXT:             op6=97 op7=118 op8=101 op9=100 op10=80 op11=116
-; DUMP-NEXT:             op12=114 op13=84 op14=111 op15=73 op16=110 op17=116/>
-; DUMP-NEXT:    <ENTRY op0=17 op1=80 op2=104 op3=105 op4=77 op5=101
-; DUMP-NEXT:             op6=114 op7=103 op8=101 op9=67 op10=97 op11=115
-; DUMP-NEXT:             op12=116/>
-; DUMP-NEXT:    <ENTRY op0=8 op1=83 op2=116 op3=111 op4=114 op5=101
-; DUMP-NEXT:             op6=71 op7=108 op8=111 op9=98 op10=97 op11=108
-; DUMP-NEXT:             op12=67 op13=97 op14=115 op15=116 op16=115 op17=82
-; DUMP-NEXT:             op18=101 op19=118 op20=101 op21=114 op22=115 op23=101
-; DUMP-NEXT:             op24=100/>
+; DUMP-NEXT:           op6=100 op7=95 op8=115 op9=116 op10=114 op11=117
+; DUMP-NEXT:           op12=99 op13=116 op14=50/>
+; DUMP-NEXT:    <ENTRY op0=32 op1=112 op2=116 op3=114 op4=95 op5=116
+; DUMP-NEXT:           op6=111 op7=95 op8=102 op9=117 op10=110 op11=99
+; DUMP-NEXT:           op12=95 op13=97 op14=108 op15=105 op16=103 op17=110/>
+; DUMP-NEXT:    <ENTRY op0=3 op1=65 op2=108 op3=108 op4=111 op5=99
+; DUMP-NEXT:           op6=67 op7=97 op8=115 op9=116 op10=83 op11=105
+; DUMP-NEXT:           op12=109 op13=112 op14=108 op15=101 op16=82 op17=101
+; DUMP-NEXT:           op18=118 op19=101 op20=114 op21=115 op22=101 op23=100/>
 ; DUMP-NEXT:    <ENTRY op0=7 op1=83 op2=116 op3=111 op4=114 op5=101
-; DUMP-NEXT:             op6=71 op7=108 op8=111 op9=98 op10=97 op11=108/>
-; DUMP-NEXT:    <ENTRY op0=9 op1=83 op2=116 op3=111 op4=114 op5=101
-; DUMP-NEXT:             op6=71 op7=108 op8=111 op9=98 op10=97 op11=108
-; DUMP-NEXT:             op12=67 op13=97 op14=115 op15=116 op16=80 op17=116
-; DUMP-NEXT:             op18=114 op19=50 op20=73 op21=110 op22=116/>
+; DUMP-NEXT:           op6=71 op7=108 op8=111 op9=98 op10=97 op11=108/>
+; DUMP-NEXT:    <ENTRY op0=8 op1=83 op2=116 op3=111 op4=114 op5=101
+; DUMP-NEXT:           op6=71 op7=108 op8=111 op9=98 op10=97 op11=108
+; DUMP-NEXT:           op12=67 op13=97 op14=115 op15=116 op16=115 op17=82
+; DUMP-NEXT:           op18=101 op19=118 op20=101 op21=114 op22=115 op23=101
+; DUMP-NEXT:           op24=100/>
+; DUMP-NEXT:    <ENTRY op0=17 op1=80 op2=104 op3=105 op4=77 op5=101
+; DUMP-NEXT:           op6=114 op7=103 op8=101 op9=67 op10=97 op11=115
+; DUMP-NEXT:           op12=116/>
 ; DUMP-NEXT:  </VALUE_SYMTAB>
 ; DUMP-NEXT:  <FUNCTION_BLOCK>
 ; DUMP-NEXT:    <DECLAREBLOCKS op0=1/>
@@ -73,6 +73,13 @@ merge:                                            ; preds = %false, %true
 ; DR:     <RELOC op0=3/>
 ; DR:   </GLOBALVAR_BLOCK>
 ; DR:   <VALUE_SYMTAB>
+; DR:     <ENTRY op0=3 op1=98 op2=121 op3=116
+; DR:            op4=101 op5=115/>
+; DR:     <ENTRY op0=5 op1=112 op2=116 op3=114/>
+; DR:     <ENTRY op0=4 op1=112 op2=116 op3=114
+; DR:            op4=95 op5=116 op6=111 op7=95
+; DR:            op8=112 op9=116 op10=114/>
+; DR:     <ENTRY op0=0 op1=98 op2=97 op3=114/>
 ; DR:     <ENTRY op0=1 op1=65 op2=108 op3=108
 ; DR:            op4=111 op5=99 op6=67 op7=97
 ; DR:            op8=115 op9=116 op10=83 op11=105
@@ -81,13 +88,6 @@ merge:                                            ; preds = %false, %true
 ; DR:            op4=66 op5=97 op6=99 op7=107
 ; DR:            op8=119 op9=97 op10=114 op11=100
 ; DR:            op12=82 op13=101 op14=102 op15=115/>
-; DR:     <ENTRY op0=0 op1=98 op2=97 op3=114/>
-; DR:     <ENTRY op0=5 op1=112 op2=116 op3=114/>
-; DR:     <ENTRY op0=3 op1=98 op2=121 op3=116
-; DR:            op4=101 op5=115/>
-; DR:     <ENTRY op0=4 op1=112 op2=116 op3=114
-; DR:            op4=95 op5=116 op6=111 op7=95
-; DR:            op8=112 op9=116 op10=114/>
 ; DR:   </VALUE_SYMTAB>
 ; DR:   <FUNCTION_BLOCK>
 ; DR:     <DECLAREBLOCKS op0=1/>
@@ -195,6 +195,15 @@ merge:                                            ; preds = %false, %true
 ; DRWD:     <RELOC abbrev=8 op0=3/>
 ; DRWD:   </GLOBALVAR_BLOCK abbrev='END_BLOCK'>
 ; DRWD:   <VALUE_SYMTAB abbrev='ENTER_SUBBLOCK' NumWords={{.*}} BlockCodeSize=3>
+; DRWD:     <ENTRY abbrev=6 op0=3 op1=98 op2=121
+; DRWD:            op3=116 op4=101 op5=115/>
+; DRWD:     <ENTRY abbrev=6 op0=5 op1=112 op2=116
+; DRWD:            op3=114/>
+; DRWD:     <ENTRY abbrev=6 op0=4 op1=112 op2=116
+; DRWD:            op3=114 op4=95 op5=116 op6=111
+; DRWD:            op7=95 op8=112 op9=116 op10=114/>
+; DRWD:     <ENTRY abbrev=6 op0=0 op1=98 op2=97
+; DRWD:            op3=114/>
 ; DRWD:     <ENTRY abbrev=6 op0=1 op1=65 op2=108
 ; DRWD:            op3=108 op4=111 op5=99 op6=67
 ; DRWD:            op7=97 op8=115 op9=116 op10=83
@@ -205,15 +214,6 @@ merge:                                            ; preds = %false, %true
 ; DRWD:            op7=107 op8=119 op9=97 op10=114
 ; DRWD:            op11=100 op12=82 op13=101 op14=102
 ; DRWD:            op15=115/>
-; DRWD:     <ENTRY abbrev=6 op0=0 op1=98 op2=97
-; DRWD:            op3=114/>
-; DRWD:     <ENTRY abbrev=6 op0=5 op1=112 op2=116
-; DRWD:            op3=114/>
-; DRWD:     <ENTRY abbrev=6 op0=3 op1=98 op2=121
-; DRWD:            op3=116 op4=101 op5=115/>
-; DRWD:     <ENTRY abbrev=6 op0=4 op1=112 op2=116
-; DRWD:            op3=114 op4=95 op5=116 op6=111
-; DRWD:            op7=95 op8=112 op9=116 op10=114/>
 ; DRWD:   </VALUE_SYMTAB abbrev='END_BLOCK'>
 ; DRWD:   <FUNCTION_BLOCK abbrev='ENTER_SUBBLOCK' NumWords={{.*}} BlockCodeSize=4>
 ; DRWD:     <DECLAREBLOCKS abbrev='UNABBREVIATED' op0=1/>
@@ -90,8 +90,8 @@ define i8 @foo(i32 %i) {
 ; DUNS-NEXT:     <INST_LOAD op0=1 op1=0 op2=1/>
 ; DUNS-NEXT:     <INST_RET op0=1/>
 ; DUNS-NEXT:     <VALUE_SYMTAB>
-; DUNS-NEXT:       <ENTRY op0=2 op1=118 op2=49/>
 ; DUNS-NEXT:       <ENTRY op0=1 op1=105/>
+; DUNS-NEXT:       <ENTRY op0=2 op1=118 op2=49/>
 ; DUNS-NEXT:       <ENTRY op0=3 op1=118 op2=51/>
 ; DUNS-NEXT:     </VALUE_SYMTAB>
 ; DUNS-NEXT:   </FUNCTION_BLOCK>
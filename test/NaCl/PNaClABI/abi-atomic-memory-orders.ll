@@ -0,0 +1,64 @@
+; RUN: not pnacl-abicheck < %s | FileCheck %s
+
+; Test which memory orders each atomic intrinsic accepts.  Memory orders
+; are: 1 relaxed, 2 consume, 3 acquire, 4 release, 5 acq_rel, 6 seq_cst.
+
+target datalayout = "e-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-p:32:32:32-v128:32:32"
+target triple = "le32-unknown-nacl"
+
+declare i32 @llvm.nacl.atomic.load.i32(i32*, i32)
+declare void @llvm.nacl.atomic.store.i32(i32, i32*, i32)
+declare i32 @llvm.nacl.atomic.rmw.i32(i32, i32*, i32, i32)
+declare i32 @llvm.nacl.atomic.cmpxchg.i32(i32*, i32, i32, i32, i32)
+declare void @llvm.nacl.atomic.fence(i32)
+
+define internal void @allowed(i32 %addr) {
+  %ptr = inttoptr i32 %addr to i32*
+  %l1 = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 1)
+  %l2 = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 2)
+  %l3 = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 3)
+  %l6 = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 6)
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 1)
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 4)
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 6)
+  %r1 = call i32 @llvm.nacl.atomic.rmw.i32(i32 1, i32* %ptr, i32 1, i32 1)
+  %r4 = call i32 @llvm.nacl.atomic.rmw.i32(i32 1, i32* %ptr, i32 1, i32 4)
+  %r5 = call i32 @llvm.nacl.atomic.rmw.i32(i32 1, i32* %ptr, i32 1, i32 5)
+  %c11 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 1, i32 1)
+  %c33 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 3, i32 3)
+  %c41 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 4, i32 1)
+  %c53 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 5, i32 3)
+  %c66 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 6, i32 6)
+  call void @llvm.nacl.atomic.fence(i32 3)
+  call void @llvm.nacl.atomic.fence(i32 4)
+  call void @llvm.nacl.atomic.fence(i32 5)
+  call void @llvm.nacl.atomic.fence(i32 6)
+  ret void
+}
+; CHECK-NOT: ERROR: Function allowed
+
+define internal void @disallowed(i32 %addr) {
+; CHECK: ERROR: Function disallowed
+  %ptr = inttoptr i32 %addr to i32*
+  %l4 = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 4)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.load.i32(i32* %ptr, i32 4)
+  %l5 = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 5)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.load.i32(i32* %ptr, i32 5)
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 3)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 3)
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 5)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 5)
+  %c14 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 1, i32 4)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 1, i32 4)
+  %c13 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 1, i32 3)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 1, i32 3)
+  %c43 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 4, i32 3)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 4, i32 3)
+  %c56 = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 5, i32 6)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 5, i32 6)
+  call void @llvm.nacl.atomic.fence(i32 1)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.fence(i32 1)
+  %l7 = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 7)
+; CHECK-NEXT: disallowed: invalid memory order: {{.*}} @llvm.nacl.atomic.load.i32(i32* %ptr, i32 7)
+  ret void
+}
@@ -0,0 +1,90 @@
+; RUN: not pnacl-abicheck < %s | FileCheck %s
+; RUN: not pnacl-abicheck -pnaclabi-allow-zero-cost-eh < %s | \
+; RUN:   FileCheck %s --check-prefix=EH
+
+; Test the instructions left by -enable-pnacl-zero-cost-eh.  They are
+; only allowed with -pnaclabi-allow-zero-cost-eh.
+
+target datalayout = "e-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-p:32:32:32-v128:32:32"
+target triple = "le32-unknown-nacl"
+
+@typeinfo = internal constant [4 x i8] zeroinitializer
+
+declare i32 @llvm.eh.typeid.for(i8*)
+; CHECK: Function llvm.eh.typeid.for is a disallowed LLVM intrinsic
+; EH-NOT: llvm.eh.typeid.for
+
+define internal i32 @personality(i32 %arg) {
+  ret i32 0
+}
+
+define internal void @may_throw(i32 %arg) {
+  ret void
+}
+
+define internal i32 @catch_typeinfo(i32 %arg) {
+  %callee = bitcast void (i32)* @may_throw to void (i32)*
+  invoke void %callee(i32 %arg) to label %cont unwind label %lpad
+; CHECK: ERROR: Function catch_typeinfo
+; CHECK: disallowed: bad instruction opcode: invoke
+cont:
+  ret i32 0
+lpad:
+  %lp = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (i32)* @personality to i8*)
+      catch i8* getelementptr inbounds ([4 x i8]* @typeinfo, i32 0, i32 0)
+      catch i8* null
+      filter [1 x i8*] [i8* getelementptr inbounds ([4 x i8]* @typeinfo, i32 0, i32 0)]
+      filter [0 x i8*] zeroinitializer
+; CHECK: disallowed: bad instruction opcode: {{.*}} landingpad
+  %exc = extractvalue { i8*, i32 } %lp, 0
+  %exc.asint = ptrtoint i8* %exc to i32
+  %sel = extractvalue { i8*, i32 } %lp, 1
+; CHECK: disallowed: bad instruction opcode: {{.*}} extractvalue
+  %ti = bitcast [4 x i8]* @typeinfo to i8*
+  %tid = call i32 @llvm.eh.typeid.for(i8* %ti)
+  %match = icmp eq i32 %sel, %tid
+  br i1 %match, label %caught, label %rethrow
+caught:
+  ret i32 %exc.asint
+rethrow:
+  %lp.exc = inttoptr i32 %exc.asint to i8*
+  %lp.1 = insertvalue { i8*, i32 } undef, i8* %lp.exc, 0
+  %lp.2 = insertvalue { i8*, i32 } %lp.1, i32 %sel, 1
+; CHECK: disallowed: bad instruction opcode: {{.*}} insertvalue
+  resume { i8*, i32 } %lp.2
+; CHECK: disallowed: bad instruction opcode: resume
+}
+; EH-NOT: ERROR: Function catch_typeinfo
+
+define internal void @bad_landing_pads(i32 %arg) {
+  %callee = bitcast void (i32)* @may_throw to void (i32)*
+  invoke void %callee(i32 %arg) to label %next unwind label %lpad1
+next:
+  invoke void %callee(i32 %arg) to label %cont unwind label %lpad2
+cont:
+  ret void
+lpad1:
+  %lp1 = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (i32)* @personality to i8*)
+      catch i8* inttoptr (i32 4 to i8*)
+; EH: ERROR: Function bad_landing_pads
+; EH: disallowed: bad landingpad clause: {{.*}} landingpad
+  %v = insertvalue { i32, i32 } undef, i32 %arg, 0
+; EH: disallowed: bad instruction opcode: {{.*}} insertvalue
+  %f = extractvalue { i32, i32 } %v, 0
+; EH: disallowed: bad instruction opcode: {{.*}} extractvalue
+  resume { i32, i32 } %v
+; EH: disallowed: bad instruction opcode: resume
+lpad2:
+  %lp2 = landingpad i32
+      personality i8* bitcast (i32 (i32)* @personality to i8*)
+      cleanup
+; EH: disallowed: bad landingpad type: {{.*}} landingpad i32
+  ret void
+}
+
+; Keep the module entry point check from failing.
+define void @_start() {
+  ret void
+}
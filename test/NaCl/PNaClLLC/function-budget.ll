@@ -0,0 +1,34 @@
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=asm %s \
+; RUN:   -function-inst-budget=8 -o - 2>&1 | FileCheck %s
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=asm %s \
+; RUN:   -function-inst-budget=8 -O0 -o - 2>&1 | FileCheck %s --check-prefix=O0
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=asm %s \
+; RUN:   -o - 2>&1 | FileCheck %s --check-prefix=NOBUDGET
+
+; Test that functions over the instruction budget are compiled with the fast
+; code generation path and reported, and that small functions are not.
+
+; CHECK-NOT: function 'small'
+; CHECK: function 'large': 10 instructions, {{[0-9]+}} ms, compiled with the fast path
+; CHECK-NOT: function 'small'
+
+; O0-NOT: compiled with the fast path
+; NOBUDGET-NOT: instructions,
+
+define i32 @small(i32 %a, i32 %b) {
+  %x = add i32 %a, %b
+  ret i32 %x
+}
+
+define i32 @large(i32 %a, i32 %b, i32 %c) {
+  %x = add i32 %a, %b
+  %y = mul i32 %x, %c
+  %z = sub i32 %y, %a
+  %w = xor i32 %z, %b
+  %v = and i32 %w, %c
+  %u = or i32 %v, %x
+  %t = shl i32 %u, 3
+  %s = lshr i32 %t, 1
+  %r = add i32 %s, %y
+  ret i32 %r
+}
@@ -0,0 +1,20 @@
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=obj %s -o /dev/null \
+; RUN:   -report-startup-time 2>&1 | FileCheck %s
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=obj %s -o /dev/null \
+; RUN:   -report-startup-time -split-module=2 2>&1 | FileCheck %s
+
+; Test that -report-startup-time reports the time to main and to the first
+; function exactly once, also when several threads compile functions.
+
+; CHECK: startup: {{[0-9.]+}} ms to main, {{[0-9.]+}} ms from main to the first function
+; CHECK-NOT: startup:
+
+define i32 @f(i32 %a, i32 %b) {
+  %x = add i32 %a, %b
+  ret i32 %x
+}
+
+define i32 @g(i32 %a, i32 %b) {
+  %x = mul i32 %a, %b
+  ret i32 %x
+}
@@ -0,0 +1,26 @@
+; RUN: llvm-as < %s | pnacl-freeze > %t.pexe
+; RUN: echo "%t.pexe %t.1.s" > %t.requests
+; RUN: echo "%t.missing.pexe %t.2.s" >> %t.requests
+; RUN: echo "%t.pexe %t.3.s" >> %t.requests
+; RUN: pnacl-llc -bitcode-format=pnacl -streaming-bitcode \
+; RUN:   -mtriple=i686-none-nacl-gnu -filetype=asm -server < %t.requests \
+; RUN:   2> %t.err | FileCheck %s
+; RUN: FileCheck %s --check-prefix=ERR < %t.err
+; RUN: FileCheck %s --check-prefix=ASM < %t.1.s
+; RUN: FileCheck %s --check-prefix=ASM < %t.3.s
+
+; Test that the server mode translates each request read from stdin, and
+; keeps serving requests after one of them fails.
+
+; CHECK: 1.s: ok
+; CHECK-NEXT: 2.s: error
+; CHECK-NEXT: 3.s: ok
+
+; ERR: missing.pexe
+
+define i32 @add(i32 %a, i32 %b) {
+  %x = add i32 %a, %b
+  ret i32 %x
+}
+; ASM-LABEL: add:
+; ASM: addl
@@ -0,0 +1,60 @@
+; RUN: llvm-as < %s | pnacl-freeze > %t.pexe
+; RUN: pnacl-llc -bitcode-format=pnacl -streaming-bitcode -split-module=2 \
+; RUN:   -split-module-sched=static -mtriple=i686-none-nacl-gnu \
+; RUN:   -filetype=asm %t.pexe -o %t.s
+; RUN: FileCheck %s --check-prefix=MOD0 < %t.s
+; RUN: FileCheck %s --check-prefix=MOD1 < %t.s.module1
+
+; Test that global variables are only defined by the first split module, and
+; that the other modules, which read them as declarations, still reference
+; them correctly from the function bodies they compile.
+
+@counter = internal global [4 x i8] zeroinitializer, align 4
+@table = internal constant <{ i32, [4 x i8] }> <{ i32 ptrtoint ([4 x i8]* @counter to i32), [4 x i8] c"abcd" }>, align 4
+@msg = internal constant [6 x i8] c"hello\00"
+
+define i32 @first() {
+  %p = bitcast [4 x i8]* @counter to i32*
+  %v = load i32* %p, align 4
+  %n = add i32 %v, 1
+  store i32 %n, i32* %p, align 4
+  ret i32 %n
+}
+; MOD0-LABEL: first:
+; MOD0: movl counter, %eax
+; MOD1-NOT: first:
+
+define i32 @second() {
+  %p = bitcast <{ i32, [4 x i8] }>* @table to i32*
+  %v = load i32* %p, align 4
+  ret i32 %v
+}
+; MOD1-LABEL: second:
+; MOD1: movl table, %eax
+
+define i32 @third() {
+  %m = ptrtoint [6 x i8]* @msg to i32
+  ret i32 %m
+}
+; MOD0-LABEL: third:
+; MOD0: movl $msg, %eax
+
+define i32 @fourth() {
+  %a = call i32 @first()
+  %b = call i32 @second()
+  %c = add i32 %a, %b
+  ret i32 %c
+}
+; MOD1-LABEL: fourth:
+; MOD1: naclcall first
+; MOD1: naclcall second
+
+; MOD0: counter:
+; MOD0: table:
+; MOD0-NEXT: .long counter
+; MOD0: msg:
+; MOD0-NEXT: .asciz "hello"
+
+; MOD1-NOT: counter:
+; MOD1-NOT: table:
+; MOD1-NOT: msg:
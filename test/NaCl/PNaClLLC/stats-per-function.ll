@@ -0,0 +1,41 @@
+; REQUIRES: asserts
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=asm %s -o /dev/null \
+; RUN:   -stats -stats-per-function 2>&1 | FileCheck %s
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=asm %s -o /dev/null \
+; RUN:   -stats -stats-per-function -stats-json 2>&1 \
+; RUN:   | FileCheck %s --check-prefix=JSON
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=asm %s -o /dev/null \
+; RUN:   -stats 2>&1 | FileCheck %s --check-prefix=NOFN
+
+; Test that -stats-per-function attributes statistics to the functions that
+; bumped them, and that -stats-json prints the same data as JSON.
+
+; CHECK: Statistics Collected ...
+; CHECK: asm-printer - Number of machine instrs printed
+; CHECK: Statistics Collected Per Function
+; CHECK: Function 'f':
+; CHECK: asm-printer - Number of machine instrs printed
+; CHECK: Function 'g':
+; CHECK: asm-printer - Number of machine instrs printed
+
+; JSON: "statistics": [
+; JSON: {"name": "asm-printer", "desc": "Number of machine instrs printed", "value": {{[0-9]+}}}
+; JSON: "functions": {
+; JSON: "f": [
+; JSON: {"name": "asm-printer", "desc": "Number of machine instrs printed", "value": {{[0-9]+}}}
+; JSON: "g": [
+; JSON: {"name": "asm-printer", "desc": "Number of machine instrs printed", "value": {{[0-9]+}}}
+
+; NOFN: Statistics Collected ...
+; NOFN-NOT: Per Function
+
+define i32 @f(i32 %a, i32 %b) {
+  %x = add i32 %a, %b
+  ret i32 %x
+}
+
+define i32 @g(i32 %a, i32 %b) {
+  %x = mul i32 %a, %b
+  %y = sub i32 %x, %a
+  ret i32 %y
+}
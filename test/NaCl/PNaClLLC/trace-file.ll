@@ -0,0 +1,25 @@
+; RUN: pnacl-llc -mtriple=x86_64-unknown-nacl -filetype=obj %s -o /dev/null \
+; RUN:   -trace-file=%t.json
+; RUN: FileCheck %s < %t.json
+
+; Test that -trace-file writes the phases, functions and passes run as a
+; Chrome trace-event file.
+
+; CHECK: {"traceEvents": [
+; CHECK-DAG: {"name": "parse module", "cat": "phase", "ph": "X", "ts": {{[0-9.]+}}, "dur": {{[0-9.]+}}, "pid": 0, "tid": 0}
+; CHECK-DAG: {"name": "f", "cat": "function", "ph": "X"
+; CHECK-DAG: {"name": "g", "cat": "function", "ph": "X"
+; CHECK-DAG: {"name": "X86 DAG->DAG Instruction Selection", "cat": "pass", "ph": "X"
+; CHECK-DAG: {"name": "MCAssembler::Finish", "cat": "mc", "ph": "X"
+; CHECK: ], "displayTimeUnit": "ms"}
+
+define i32 @f(i32 %a, i32 %b) {
+  %x = add i32 %a, %b
+  ret i32 %x
+}
+
+define i32 @g(i32 %a, i32 %b) {
+  %x = mul i32 %a, %b
+  %y = sub i32 %x, %a
+  ret i32 %y
+}
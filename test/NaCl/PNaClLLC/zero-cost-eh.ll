@@ -0,0 +1,86 @@
+; RUN: opt %s -enable-pnacl-zero-cost-eh -pnacl-abi-simplify-preopt \
+; RUN:   -pnacl-abi-simplify-postopt -o %t.bc
+; RUN: pnacl-llc -pnaclabi-verify -pnaclabi-verify-fatal-errors \
+; RUN:   -pnaclabi-allow-zero-cost-eh -mtriple=x86_64-none-nacl \
+; RUN:   -filetype=asm %t.bc -o - | FileCheck %s
+; RUN: pnacl-llc -pnaclabi-verify -pnaclabi-verify-fatal-errors \
+; RUN:   -pnaclabi-allow-zero-cost-eh -mtriple=i686-none-nacl \
+; RUN:   -filetype=asm %t.bc -o - | FileCheck %s
+
+; Test that with zero-cost exception handling the translator emits the
+; unwind tables of the native target, and that the path through the
+; invokes does not save any context.
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-p:32:32:32-v128:32:32"
+target triple = "le32-unknown-nacl"
+
+@_ZTIi = internal constant i8* null
+
+define internal i32 @__gxx_personality_v0(...) {
+  ret i32 0
+}
+
+define internal i32 @work(i32 %n) {
+  ret i32 %n
+}
+
+define internal void @destroy(i32* %obj) {
+  ret void
+}
+
+define internal i8* @__cxa_begin_catch(i8* %exc) {
+  ret i8* %exc
+}
+
+define internal void @__cxa_end_catch() {
+  ret void
+}
+
+declare i32 @llvm.eh.typeid.for(i8*)
+
+define internal i32 @call_twice(i32 %n) {
+entry:
+  %obj = alloca i32
+  %r1 = invoke i32 @work(i32 %n) to label %next unwind label %lpad
+next:
+  %r2 = invoke i32 @work(i32 %r1) to label %done unwind label %lpad
+done:
+  call void @destroy(i32* %obj)
+  ret i32 %r2
+lpad:
+  %lp = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (...)* @__gxx_personality_v0 to i8*)
+      cleanup
+      catch i8* bitcast (i8** @_ZTIi to i8*)
+  %sel = extractvalue { i8*, i32 } %lp, 1
+  %tid = call i32 @llvm.eh.typeid.for(i8* bitcast (i8** @_ZTIi to i8*))
+  %caught = icmp eq i32 %sel, %tid
+  call void @destroy(i32* %obj)
+  br i1 %caught, label %catch, label %rethrow
+catch:
+  %exc = extractvalue { i8*, i32 } %lp, 0
+  %thrown = call i8* @__cxa_begin_catch(i8* %exc)
+  %ptr = bitcast i8* %thrown to i32*
+  %val = load i32* %ptr
+  call void @__cxa_end_catch()
+  ret i32 %val
+rethrow:
+  resume { i8*, i32 } %lp
+}
+; CHECK-LABEL: call_twice:
+; CHECK: .cfi_personality {{[0-9]+}}, __gxx_personality_v0
+; CHECK: .cfi_lsda {{[0-9]+}}, [[LSDA:.Lexception[0-9]+]]
+; CHECK-NOT: setjmp
+; CHECK: call{{.*}} work
+; CHECK-NOT: setjmp
+; CHECK: call{{.*}} work
+; CHECK: call{{.*}} __cxa_begin_catch
+; CHECK: call{{.*}} __cxa_end_catch
+; CHECK: call{{.*}} _Unwind_Resume
+; CHECK: .section .gcc_except_table
+; CHECK: [[LSDA]]:
+
+define void @_start(i32 %arg) {
+  %r = call i32 @call_twice(i32 %arg)
+  ret void
+}
@@ -0,0 +1,95 @@
+; RUN: pnacl-llc -O2 -mtriple=x86_64-none-nacl < %s | FileCheck %s
+; RUN: pnacl-llc -O2 -mtriple=i686-none-nacl < %s | FileCheck %s
+
+; Litmus tests for the memory orders of the NaCl atomic intrinsics.  x86
+; only needs a full barrier to order a store before a later load, so only
+; seq_cst stores and fences may cost an xchg or an mfence.
+
+target datalayout = "e-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-p:32:32:32-v128:32:32"
+target triple = "le32-unknown-nacl"
+
+declare i32 @llvm.nacl.atomic.load.i32(i32*, i32)
+declare void @llvm.nacl.atomic.store.i32(i32, i32*, i32)
+declare void @llvm.nacl.atomic.fence(i32)
+
+; Message passing: the release store of the flag and the acquire load
+; which reads it are plain moves.
+define void @mp_send(i32 %data, i32 %flag) {
+  %d = inttoptr i32 %data to i32*
+  %f = inttoptr i32 %flag to i32*
+  store i32 42, i32* %d, align 4
+  call void @llvm.nacl.atomic.store.i32(i32 1, i32* %f, i32 4)
+  ret void
+}
+; CHECK-LABEL: mp_send:
+; CHECK-NOT: xchg
+; CHECK-NOT: mfence
+; CHECK: nacljmp
+
+define i32 @mp_recv(i32 %data, i32 %flag) {
+  %d = inttoptr i32 %data to i32*
+  %f = inttoptr i32 %flag to i32*
+  %r = call i32 @llvm.nacl.atomic.load.i32(i32* %f, i32 3)
+  %v = load i32* %d, align 4
+  %s = add i32 %r, %v
+  ret i32 %s
+}
+; CHECK-LABEL: mp_recv:
+; CHECK-NOT: xchg
+; CHECK-NOT: mfence
+; CHECK: nacljmp
+
+; Store buffering: seq_cst stores must not be reordered with later loads.
+define i32 @sb_seq_cst(i32 %x, i32 %y) {
+  %px = inttoptr i32 %x to i32*
+  %py = inttoptr i32 %y to i32*
+  call void @llvm.nacl.atomic.store.i32(i32 1, i32* %px, i32 6)
+  %r = call i32 @llvm.nacl.atomic.load.i32(i32* %py, i32 6)
+  ret i32 %r
+}
+; CHECK-LABEL: sb_seq_cst:
+; CHECK: xchgl
+; CHECK-NOT: mfence
+; CHECK: nacljmp
+
+; Store buffering with relaxed accesses and fences: the adjacent release
+; and seq_cst fences become a single mfence.
+define i32 @sb_fences(i32 %x, i32 %y) {
+  %px = inttoptr i32 %x to i32*
+  %py = inttoptr i32 %y to i32*
+  call void @llvm.nacl.atomic.store.i32(i32 1, i32* %px, i32 1)
+  call void @llvm.nacl.atomic.fence(i32 4)
+  call void @llvm.nacl.atomic.fence(i32 6)
+  %r = call i32 @llvm.nacl.atomic.load.i32(i32* %py, i32 1)
+  ret i32 %r
+}
+; CHECK-LABEL: sb_fences:
+; CHECK: movl {{.*}}, {{.*}}(%{{.*}})
+; CHECK-NEXT: mfence
+; CHECK-NOT: mfence
+; CHECK: nacljmp
+
+; Fences separated by a memory access both stay.
+define i32 @fences_around_load(i32 %x) {
+  %px = inttoptr i32 %x to i32*
+  call void @llvm.nacl.atomic.fence(i32 6)
+  %r = call i32 @llvm.nacl.atomic.load.i32(i32* %px, i32 1)
+  call void @llvm.nacl.atomic.fence(i32 6)
+  ret i32 %r
+}
+; CHECK-LABEL: fences_around_load:
+; CHECK: mfence
+; CHECK: mfence
+; CHECK: nacljmp
+
+; Acquire and release fences only restrict the compiler.
+define i32 @fence_acquire_release(i32 %x) {
+  %px = inttoptr i32 %x to i32*
+  %r = call i32 @llvm.nacl.atomic.load.i32(i32* %px, i32 1)
+  call void @llvm.nacl.atomic.fence(i32 3)
+  call void @llvm.nacl.atomic.fence(i32 4)
+  ret i32 %r
+}
+; CHECK-LABEL: fence_acquire_release:
+; CHECK-NOT: mfence
+; CHECK: nacljmp
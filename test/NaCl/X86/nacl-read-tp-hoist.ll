@@ -0,0 +1,50 @@
+; RUN: pnacl-llc -O2 -mtriple=x86_64-unknown-nacl -filetype=asm %s -o - \
+; RUN:   | FileCheck -check-prefix=USE_CALL %s
+; RUN: pnacl-llc -O2 -mtriple=i386-unknown-nacl -mtls-use-call -filetype=asm \
+; RUN:   %s -o - | FileCheck -check-prefix=USE_CALL %s
+; RUN: pnacl-llc -O2 -mtriple=i386-unknown-nacl -filetype=asm %s -o - \
+; RUN:   | FileCheck -check-prefix=X32 %s
+; RUN: pnacl-llc -O0 -mtriple=x86_64-unknown-nacl -filetype=asm %s -o - \
+; RUN:   | FileCheck -check-prefix=O0 %s
+
+; Test that a function which accesses thread-locals in a loop, as
+; expanded by ExpandTls, reads the thread pointer once, before the loop.
+
+declare i8* @llvm.nacl.read.tp()
+
+define void @tls_loop(i32 %n) {
+entry:
+  br label %loop
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %tp1 = call i8* @llvm.nacl.read.tp()
+  %a1 = ptrtoint i8* %tp1 to i32
+  %a2 = add i32 %a1, -8
+  %p1 = inttoptr i32 %a2 to i32*
+  %v = load i32* %p1, align 4
+  %tp2 = call i8* @llvm.nacl.read.tp()
+  %b1 = ptrtoint i8* %tp2 to i32
+  %b2 = add i32 %b1, -4
+  %p2 = inttoptr i32 %b2 to i32*
+  %w = add i32 %v, %i
+  store i32 %w, i32* %p2, align 4
+  %i.next = add i32 %i, 1
+  %done = icmp eq i32 %i.next, %n
+  br i1 %done, label %exit, label %loop
+exit:
+  ret void
+}
+
+; USE_CALL-LABEL: tls_loop:
+; USE_CALL: naclcall __nacl_read_tp
+; USE_CALL-NOT: __nacl_read_tp
+; USE_CALL: nacljmp
+
+; X32-LABEL: tls_loop:
+; X32: movl %gs:0,
+; X32-NOT: %gs:0
+; X32: nacljmp
+
+; O0-LABEL: tls_loop:
+; O0: naclcall __nacl_read_tp
+; O0: naclcall __nacl_read_tp
@@ -0,0 +1,133 @@
+; RUN: opt -nacl-rewrite-atomics -S < %s | FileCheck %s --check-prefix=SEQCST
+; RUN: opt -nacl-rewrite-atomics -enable-pnacl-memory-orders -S < %s | \
+;   FileCheck %s --check-prefix=ORDERS
+
+; Test that memory orders other than seq_cst are promoted to seq_cst by
+; default, which is the only memory order stable translators accept, and
+; that they are kept with -enable-pnacl-memory-orders.  The failure
+; memory order of compare exchange is the success one without its release
+; part.
+
+target datalayout = "p:32:32:32"
+
+; SEQCST: @test_load_acquire_i32
+; ORDERS: @test_load_acquire_i32
+define i32 @test_load_acquire_i32(i32* %ptr) {
+  ; SEQCST-NEXT: %res = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 6)
+  ; ORDERS-NEXT: %res = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 3)
+  ; SEQCST-NEXT: ret i32 %res
+  ; ORDERS-NEXT: ret i32 %res
+  %res = load atomic i32* %ptr acquire, align 4
+  ret i32 %res
+}
+
+; SEQCST: @test_load_relaxed_i32
+; ORDERS: @test_load_relaxed_i32
+define i32 @test_load_relaxed_i32(i32* %ptr) {
+  ; SEQCST-NEXT: %res = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 6)
+  ; ORDERS-NEXT: %res = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 1)
+  ; SEQCST-NEXT: ret i32 %res
+  ; ORDERS-NEXT: ret i32 %res
+  %res = load atomic i32* %ptr monotonic, align 4
+  ret i32 %res
+}
+
+; SEQCST: @test_load_unordered_i32
+; ORDERS: @test_load_unordered_i32
+define i32 @test_load_unordered_i32(i32* %ptr) {
+  ; SEQCST-NEXT: %res = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 6)
+  ; ORDERS-NEXT: %res = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 1)
+  ; SEQCST-NEXT: ret i32 %res
+  ; ORDERS-NEXT: ret i32 %res
+  %res = load atomic i32* %ptr unordered, align 4
+  ret i32 %res
+}
+
+; SEQCST: @test_store_relaxed_i32
+; ORDERS: @test_store_relaxed_i32
+define void @test_store_relaxed_i32(i32* %ptr, i32 %value) {
+  ; SEQCST-NEXT: call void @llvm.nacl.atomic.store.i32(i32 %value, i32* %ptr, i32 6)
+  ; ORDERS-NEXT: call void @llvm.nacl.atomic.store.i32(i32 %value, i32* %ptr, i32 1)
+  ; SEQCST-NEXT: ret void
+  ; ORDERS-NEXT: ret void
+  store atomic i32 %value, i32* %ptr monotonic, align 4
+  ret void
+}
+
+; SEQCST: @test_store_release_i32
+; ORDERS: @test_store_release_i32
+define void @test_store_release_i32(i32* %ptr, i32 %value) {
+  ; SEQCST-NEXT: call void @llvm.nacl.atomic.store.i32(i32 %value, i32* %ptr, i32 6)
+  ; ORDERS-NEXT: call void @llvm.nacl.atomic.store.i32(i32 %value, i32* %ptr, i32 4)
+  ; SEQCST-NEXT: ret void
+  ; ORDERS-NEXT: ret void
+  store atomic i32 %value, i32* %ptr release, align 4
+  ret void
+}
+
+; SEQCST: @test_fetch_and_add_acq_rel_i32
+; ORDERS: @test_fetch_and_add_acq_rel_i32
+define i32 @test_fetch_and_add_acq_rel_i32(i32* %ptr, i32 %value) {
+  ; SEQCST-NEXT: %res = call i32 @llvm.nacl.atomic.rmw.i32(i32 1, i32* %ptr, i32 %value, i32 6)
+  ; ORDERS-NEXT: %res = call i32 @llvm.nacl.atomic.rmw.i32(i32 1, i32* %ptr, i32 %value, i32 5)
+  ; SEQCST-NEXT: ret i32 %res
+  ; ORDERS-NEXT: ret i32 %res
+  %res = atomicrmw add i32* %ptr, i32 %value acq_rel
+  ret i32 %res
+}
+
+; without its release part.
+; SEQCST: @test_cmpxchg_acquire_i32
+; ORDERS: @test_cmpxchg_acquire_i32
+define i32 @test_cmpxchg_acquire_i32(i32* %ptr, i32 %oldval, i32 %newval) {
+  ; SEQCST-NEXT: %res = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 %oldval, i32 %newval, i32 6, i32 6)
+  ; ORDERS-NEXT: %res = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 %oldval, i32 %newval, i32 3, i32 3)
+  ; SEQCST-NEXT: ret i32 %res
+  ; ORDERS-NEXT: ret i32 %res
+  %res = cmpxchg i32* %ptr, i32 %oldval, i32 %newval acquire
+  ret i32 %res
+}
+
+; SEQCST: @test_cmpxchg_release_i32
+; ORDERS: @test_cmpxchg_release_i32
+define i32 @test_cmpxchg_release_i32(i32* %ptr, i32 %oldval, i32 %newval) {
+  ; SEQCST-NEXT: %res = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 %oldval, i32 %newval, i32 6, i32 6)
+  ; ORDERS-NEXT: %res = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 %oldval, i32 %newval, i32 4, i32 1)
+  ; SEQCST-NEXT: ret i32 %res
+  ; ORDERS-NEXT: ret i32 %res
+  %res = cmpxchg i32* %ptr, i32 %oldval, i32 %newval release
+  ret i32 %res
+}
+
+; SEQCST: @test_cmpxchg_acq_rel_i32
+; ORDERS: @test_cmpxchg_acq_rel_i32
+define i32 @test_cmpxchg_acq_rel_i32(i32* %ptr, i32 %oldval, i32 %newval) {
+  ; SEQCST-NEXT: %res = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 %oldval, i32 %newval, i32 6, i32 6)
+  ; ORDERS-NEXT: %res = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 %oldval, i32 %newval, i32 5, i32 3)
+  ; SEQCST-NEXT: ret i32 %res
+  ; ORDERS-NEXT: ret i32 %res
+  %res = cmpxchg i32* %ptr, i32 %oldval, i32 %newval acq_rel
+  ret i32 %res
+}
+
+; SEQCST: @test_fence_acquire
+; ORDERS: @test_fence_acquire
+define void @test_fence_acquire() {
+  ; SEQCST-NEXT: call void @llvm.nacl.atomic.fence(i32 6)
+  ; ORDERS-NEXT: call void @llvm.nacl.atomic.fence(i32 3)
+  ; SEQCST-NEXT: ret void
+  ; ORDERS-NEXT: ret void
+  fence acquire
+  ret void
+}
+
+; SEQCST: @test_fence_release
+; ORDERS: @test_fence_release
+define void @test_fence_release() {
+  ; SEQCST-NEXT: call void @llvm.nacl.atomic.fence(i32 6)
+  ; ORDERS-NEXT: call void @llvm.nacl.atomic.fence(i32 4)
+  ; SEQCST-NEXT: ret void
+  ; ORDERS-NEXT: ret void
+  fence release
+  ret void
+}
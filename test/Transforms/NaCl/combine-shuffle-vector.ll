@@ -27,17 +27,15 @@ define <4 x i32> @test_splat_hi_4xi32(<4 x i32> %lhs, <4 x i32> %rhs) {
 
 define <4 x i32> @test_id_lo_4xi32(<4 x i32> %lhs, <4 x i32> %rhs) {
   ; CHECK-LABEL: test_id_lo_4xi32
-  ; CHECK-NEXT: %[[R:[0-9]+]] = shufflevector <4 x i32> %lhs, <4 x i32> undef, <4 x i32> <i32 0, i32 1, i32 2, i32 3>
   %res = shufflevector <4 x i32> %lhs, <4 x i32> %rhs, <4 x i32> <i32 0, i32 1, i32 2, i32 3>
-  ; CHECK-NEXT: ret <4 x i32> %[[R]]
+  ; CHECK-NEXT: ret <4 x i32> %lhs
   ret <4 x i32> %res
 }
 
 define <4 x i32> @test_id_hi_4xi32(<4 x i32> %lhs, <4 x i32> %rhs) {
   ; CHECK-LABEL: test_id_hi_4xi32
-  ; CHECK-NEXT: %[[R:[0-9]+]] = shufflevector <4 x i32> %rhs, <4 x i32> undef, <4 x i32> <i32 0, i32 1, i32 2, i32 3>
   %res = shufflevector <4 x i32> %lhs, <4 x i32> %rhs, <4 x i32> <i32 4, i32 5, i32 6, i32 7>
-  ; CHECK-NEXT: ret <4 x i32> %[[R]]
+  ; CHECK-NEXT: ret <4 x i32> %rhs
   ret <4 x i32> %res
 }
 
@@ -56,3 +54,65 @@ define <4 x i32> @test_interleave_hi_4xi32(<4 x i32> %lhs, <4 x i32> %rhs) {
   ; CHECK-NEXT: ret <4 x i32> %[[R]]
   ret <4 x i32> %res
 }
+
+; The following insertelement / extractelement chains weren't created by
+; -expand-shufflevector, they don't map to a single shufflevector of the
+; chain's own inputs.
+
+; Lanes from three vectors are blended with two shuffles.
+define <4 x i32> @test_blend3_4xi32(<4 x i32> %a, <4 x i32> %b, <4 x i32> %c) {
+  ; CHECK-LABEL: test_blend3_4xi32
+  ; CHECK-NEXT: %[[T:[0-9]+]] = shufflevector <4 x i32> %a, <4 x i32> %b, <4 x i32> <i32 3, i32 4, i32 undef, i32 1>
+  ; CHECK-NEXT: %[[R:[0-9]+]] = shufflevector <4 x i32> %[[T]], <4 x i32> %c, <4 x i32> <i32 0, i32 1, i32 6, i32 3>
+  ; CHECK-NEXT: ret <4 x i32> %[[R]]
+  %a3 = extractelement <4 x i32> %a, i32 3
+  %b0 = extractelement <4 x i32> %b, i32 0
+  %c2 = extractelement <4 x i32> %c, i32 2
+  %a1 = extractelement <4 x i32> %a, i32 1
+  %v0 = insertelement <4 x i32> undef, i32 %a3, i32 0
+  %v1 = insertelement <4 x i32> %v0, i32 %b0, i32 1
+  %v2 = insertelement <4 x i32> %v1, i32 %c2, i32 2
+  %v3 = insertelement <4 x i32> %v2, i32 %a1, i32 3
+  ret <4 x i32> %v3
+}
+
+; A scalar inserted in every lane is splatted.
+define <4 x float> @test_splat_scalar_4xfloat(float %f) {
+  ; CHECK-LABEL: test_splat_scalar_4xfloat
+  ; CHECK-NEXT: %[[I:[0-9]+]] = insertelement <4 x float> undef, float %f, i32 0
+  ; CHECK-NEXT: %[[R:[0-9]+]] = shufflevector <4 x float> %[[I]], <4 x float> undef, <4 x i32> zeroinitializer
+  ; CHECK-NEXT: ret <4 x float> %[[R]]
+  %v0 = insertelement <4 x float> undef, float %f, i32 0
+  %v1 = insertelement <4 x float> %v0, float %f, i32 1
+  %v2 = insertelement <4 x float> %v1, float %f, i32 2
+  %v3 = insertelement <4 x float> %v2, float %f, i32 3
+  ret <4 x float> %v3
+}
+
+; Lanes are traced through existing shufflevectors, and constant lanes come
+; from a constant vector.
+define <8 x i16> @test_through_shuffle_8xi16(<8 x i16> %a) {
+  ; CHECK-LABEL: test_through_shuffle_8xi16
+  ; CHECK-NEXT: %[[R:[0-9]+]] = shufflevector <8 x i16> %a, <8 x i16> <i16 undef, i16 undef, i16 undef, i16 undef, i16 undef, i16 undef, i16 0, i16 0>, <8 x i32> <i32 7, i32 6, i32 5, i32 4, i32 3, i32 2, i32 14, i32 15>
+  ; CHECK-NEXT: ret <8 x i16> %[[R]]
+  %rev = shufflevector <8 x i16> %a, <8 x i16> undef, <8 x i32> <i32 7, i32 6, i32 5, i32 4, i32 3, i32 2, i32 1, i32 0>
+  %v0 = insertelement <8 x i16> %rev, i16 0, i32 6
+  %v1 = insertelement <8 x i16> %v0, i16 0, i32 7
+  ret <8 x i16> %v1
+}
+
+; A lone scalar is inserted after the shuffle.
+define <4 x i32> @test_scalar_lane_4xi32(<4 x i32> %a, i32 %s) {
+  ; CHECK-LABEL: test_scalar_lane_4xi32
+  ; CHECK-NEXT: %[[T:[0-9]+]] = shufflevector <4 x i32> %a, <4 x i32> undef, <4 x i32> <i32 3, i32 2, i32 1, i32 undef>
+  ; CHECK-NEXT: %[[R:[0-9]+]] = insertelement <4 x i32> %[[T]], i32 %s, i32 3
+  ; CHECK-NEXT: ret <4 x i32> %[[R]]
+  %a3 = extractelement <4 x i32> %a, i32 3
+  %a2 = extractelement <4 x i32> %a, i32 2
+  %a1 = extractelement <4 x i32> %a, i32 1
+  %v0 = insertelement <4 x i32> undef, i32 %a3, i32 0
+  %v1 = insertelement <4 x i32> %v0, i32 %a2, i32 1
+  %v2 = insertelement <4 x i32> %v1, i32 %a1, i32 2
+  %v3 = insertelement <4 x i32> %v2, i32 %s, i32 3
+  ret <4 x i32> %v3
+}
@@ -0,0 +1,189 @@
+; RUN: opt -fix-vector-load-store-alignment -globalize-constant-vectors %s \
+; RUN:   -S | opt -combine-vector-instructions -S | FileCheck %s
+
+; Test that vector load/store which were split into element accesses
+; because they weren't element-aligned are re-combined, and that constant
+; vectors which were turned into loads from globals are re-materialized.
+
+target datalayout = "e-p:32:32:32-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-p:32:32:32-v128:32:32"
+
+define <4 x i32> @load_align1(<4 x i32>* %p) {
+  ; CHECK-LABEL: load_align1
+  ; CHECK-NEXT: %[[P:[0-9]+]] = bitcast <4 x i32>* %p to i32*
+  ; CHECK-NEXT: %[[G:[0-9]+]] = getelementptr inbounds i32* %[[P]], i32 0
+  ; CHECK-NEXT: %[[V:[0-9]+]] = bitcast i32* %[[G]] to <4 x i32>*
+  ; CHECK-NEXT: %[[L:[0-9]+]] = load <4 x i32>* %[[V]], align 1
+  ; CHECK-NEXT: ret <4 x i32> %[[L]]
+  %l = load <4 x i32>* %p, align 1
+  ret <4 x i32> %l
+}
+
+define void @store_align2(<8 x i16> %v, <8 x i16>* %p) {
+  ; CHECK-LABEL: store_align2
+  ; CHECK-NEXT: %[[P:[0-9]+]] = bitcast <8 x i16>* %p to i16*
+  ; CHECK-NEXT: %[[G:[0-9]+]] = getelementptr inbounds i16* %[[P]], i32 0
+  ; CHECK-NEXT: %[[V:[0-9]+]] = bitcast i16* %[[G]] to <8 x i16>*
+  ; CHECK-NEXT: store <8 x i16> %v, <8 x i16>* %[[V]], align 1
+  ; CHECK-NEXT: ret void
+  store <8 x i16> %v, <8 x i16>* %p, align 1
+  ret void
+}
+
+define void @copy_float4(<4 x float>* %src, <4 x float>* %dst) {
+  ; CHECK-LABEL: copy_float4
+  ; CHECK: load <4 x float>* %{{[0-9]+}}, align 2
+  ; CHECK-NOT: load
+  ; CHECK: store <4 x float> %{{[0-9]+}}, <4 x float>* %{{[0-9]+}}, align 2
+  ; CHECK-NOT: store
+  ; CHECK: ret void
+  %l = load <4 x float>* %src, align 2
+  store <4 x float> %l, <4 x float>* %dst, align 2
+  ret void
+}
+
+; Addresses in PNaCl bitcode are integers, offset with add.
+define <4 x i32> @load_inttoptr(i32 %addr) {
+  ; CHECK-LABEL: load_inttoptr
+  ; CHECK-NEXT: %p0 = inttoptr i32 %addr to i32*
+  ; CHECK-NEXT: %[[V:[0-9]+]] = bitcast i32* %p0 to <4 x i32>*
+  ; CHECK-NEXT: %[[L:[0-9]+]] = load <4 x i32>* %[[V]], align 1
+  ; CHECK-NEXT: ret <4 x i32> %[[L]]
+  %p0 = inttoptr i32 %addr to i32*
+  %l0 = load i32* %p0, align 1
+  %v0 = insertelement <4 x i32> undef, i32 %l0, i32 0
+  %a1 = add i32 %addr, 4
+  %p1 = inttoptr i32 %a1 to i32*
+  %l1 = load i32* %p1, align 1
+  %v1 = insertelement <4 x i32> %v0, i32 %l1, i32 1
+  %a2 = add i32 %addr, 8
+  %p2 = inttoptr i32 %a2 to i32*
+  %l2 = load i32* %p2, align 1
+  %v2 = insertelement <4 x i32> %v1, i32 %l2, i32 2
+  %a3 = add i32 %addr, 12
+  %p3 = inttoptr i32 %a3 to i32*
+  %l3 = load i32* %p3, align 1
+  %v3 = insertelement <4 x i32> %v2, i32 %l3, i32 3
+  ret <4 x i32> %v3
+}
+
+; A store between the element loads may alias them.
+define <4 x i32> @load_clobbered(i32 %addr, i32* %q) {
+  ; CHECK-LABEL: load_clobbered
+  ; CHECK-NOT: load <4 x i32>
+  ; CHECK: ret <4 x i32>
+  %p0 = inttoptr i32 %addr to i32*
+  %l0 = load i32* %p0, align 1
+  %v0 = insertelement <4 x i32> undef, i32 %l0, i32 0
+  store i32 0, i32* %q, align 4
+  %a1 = add i32 %addr, 4
+  %p1 = inttoptr i32 %a1 to i32*
+  %l1 = load i32* %p1, align 1
+  %v1 = insertelement <4 x i32> %v0, i32 %l1, i32 1
+  %a2 = add i32 %addr, 8
+  %p2 = inttoptr i32 %a2 to i32*
+  %l2 = load i32* %p2, align 1
+  %v2 = insertelement <4 x i32> %v1, i32 %l2, i32 2
+  %a3 = add i32 %addr, 12
+  %p3 = inttoptr i32 %a3 to i32*
+  %l3 = load i32* %p3, align 1
+  %v3 = insertelement <4 x i32> %v2, i32 %l3, i32 3
+  ret <4 x i32> %v3
+}
+
+; The elements aren't consecutive.
+define <4 x i32> @load_gap(i32 %addr) {
+  ; CHECK-LABEL: load_gap
+  ; CHECK-NOT: load <4 x i32>
+  ; CHECK: ret <4 x i32>
+  %p0 = inttoptr i32 %addr to i32*
+  %l0 = load i32* %p0, align 1
+  %v0 = insertelement <4 x i32> undef, i32 %l0, i32 0
+  %a1 = add i32 %addr, 4
+  %p1 = inttoptr i32 %a1 to i32*
+  %l1 = load i32* %p1, align 1
+  %v1 = insertelement <4 x i32> %v0, i32 %l1, i32 1
+  %a2 = add i32 %addr, 8
+  %p2 = inttoptr i32 %a2 to i32*
+  %l2 = load i32* %p2, align 1
+  %v2 = insertelement <4 x i32> %v1, i32 %l2, i32 2
+  %a3 = add i32 %addr, 16
+  %p3 = inttoptr i32 %a3 to i32*
+  %l3 = load i32* %p3, align 1
+  %v3 = insertelement <4 x i32> %v2, i32 %l3, i32 3
+  ret <4 x i32> %v3
+}
+
+define void @store_volatile(<4 x i32> %v, <4 x i32>* %p) {
+  ; CHECK-LABEL: store_volatile
+  ; CHECK-NOT: store <4 x i32>
+  ; CHECK: ret void
+  store volatile <4 x i32> %v, <4 x i32>* %p, align 1
+  ret void
+}
+
+; A load between the element stores could observe a partial vector.
+define i32 @store_read_between(<4 x i32> %v, i32 %addr) {
+  ; CHECK-LABEL: store_read_between
+  ; CHECK-NOT: store <4 x i32>
+  ; CHECK: ret i32
+  %e0 = extractelement <4 x i32> %v, i32 0
+  %p0 = inttoptr i32 %addr to i32*
+  store i32 %e0, i32* %p0, align 1
+  %r = load i32* %p0, align 1
+  %a1 = add i32 %addr, 4
+  %e1 = extractelement <4 x i32> %v, i32 1
+  %p1 = inttoptr i32 %a1 to i32*
+  store i32 %e1, i32* %p1, align 1
+  %a2 = add i32 %addr, 8
+  %e2 = extractelement <4 x i32> %v, i32 2
+  %p2 = inttoptr i32 %a2 to i32*
+  store i32 %e2, i32* %p2, align 1
+  %a3 = add i32 %addr, 12
+  %e3 = extractelement <4 x i32> %v, i32 3
+  %p3 = inttoptr i32 %a3 to i32*
+  store i32 %e3, i32* %p3, align 1
+  ret i32 %r
+}
+
+define <4 x i32> @constant_arg(<4 x i32> %v) {
+  ; CHECK-LABEL: constant_arg
+  ; CHECK-NEXT: %[[R:[0-9a-z_]+]] = add <4 x i32> %v, <i32 1, i32 2, i32 3, i32 4>
+  ; CHECK-NEXT: ret <4 x i32> %[[R]]
+  %r = add <4 x i32> %v, <i32 1, i32 2, i32 3, i32 4>
+  ret <4 x i32> %r
+}
+
+define <4 x float> @constant_zero(<4 x float> %v) {
+  ; CHECK-LABEL: constant_zero
+  ; CHECK-NEXT: %[[R:[0-9a-z_]+]] = fsub <4 x float> zeroinitializer, %v
+  ; CHECK-NEXT: ret <4 x float> %[[R]]
+  %r = fsub <4 x float> zeroinitializer, %v
+  ret <4 x float> %r
+}
+
+; Constant vectors of i1 are loaded element by element.
+@mask = internal constant [4 x i8] c"\01\00\01\01", align 4
+
+define <4 x i32> @constant_i1(<4 x i32> %a, <4 x i32> %b) {
+  ; CHECK-LABEL: constant_i1
+  ; CHECK-NEXT: %s = select <4 x i1> <i1 true, i1 false, i1 true, i1 true>, <4 x i32> %a, <4 x i32> %b
+  ; CHECK-NEXT: ret <4 x i32> %s
+  %p0 = bitcast [4 x i8]* @mask to i1*
+  %l0 = load i1* %p0, align 1
+  %v0 = insertelement <4 x i1> undef, i1 %l0, i32 0
+  %base = ptrtoint [4 x i8]* @mask to i32
+  %a1 = add i32 %base, 1
+  %p1 = inttoptr i32 %a1 to i1*
+  %l1 = load i1* %p1, align 1
+  %v1 = insertelement <4 x i1> %v0, i1 %l1, i32 1
+  %a2 = add i32 %base, 2
+  %p2 = inttoptr i32 %a2 to i1*
+  %l2 = load i1* %p2, align 1
+  %v2 = insertelement <4 x i1> %v1, i1 %l2, i32 2
+  %a3 = add i32 %base, 3
+  %p3 = inttoptr i32 %a3 to i1*
+  %l3 = load i1* %p3, align 1
+  %v3 = insertelement <4 x i1> %v2, i1 %l3, i32 3
+  %s = select <4 x i1> %v3, <4 x i32> %a, <4 x i32> %b
+  ret <4 x i32> %s
+}
@@ -81,6 +81,75 @@ define i64 @larger_arguments(i32 %a, i64 %b, i8* %ptr, double %d) {
 ; CHECK-NEXT: ret i64 %r
 
 
+declare i32 @__gxx_personality_v0(...)
+declare i8 @small_ext(i8)
+
+define i8 @invoke_small(i8 %arg) {
+  %r = invoke i8 @small_ext(i8 %arg) to label %cont unwind label %lpad
+cont:
+  ret i8 %r
+lpad:
+  %lp = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (...)* @__gxx_personality_v0 to i8*)
+      cleanup
+  resume { i8*, i32 } %lp
+}
+; CHECK: define i32 @invoke_small(i32 %arg) {
+; CHECK: %arg_ext = zext i8 %arg.arg_trunc to i32
+; CHECK-NEXT: %r.arg_cast = bitcast i8 (i8)* @small_ext to i32 (i32)*
+; CHECK-NEXT: %r = invoke i32 %r.arg_cast(i32 %arg_ext)
+; CHECK-NEXT: to label %cont unwind label %lpad
+; CHECK: cont:
+; CHECK-NEXT: %r.ret_trunc = trunc i32 %r to i8
+; CHECK-NEXT: %r.ret_trunc.ret_ext = zext i8 %r.ret_trunc to i32
+; CHECK-NEXT: ret i32 %r.ret_trunc.ret_ext
+
+; The result is truncated on the normal edge, which must be split when
+; the normal destination has other predecessors.
+define i8 @invoke_critical_edge(i8 %arg, i1 %c) {
+  br i1 %c, label %call, label %join
+call:
+  %r = invoke i8 @small_ext(i8 %arg) to label %join unwind label %lpad
+join:
+  %p = phi i8 [ 0, %0 ], [ %r, %call ]
+  ret i8 %p
+lpad:
+  %lp = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (...)* @__gxx_personality_v0 to i8*)
+      cleanup
+  resume { i8*, i32 } %lp
+}
+; CHECK: define i32 @invoke_critical_edge(i32 %arg, i32 %c) {
+; CHECK: %r = invoke i32 %r.arg_cast(i32 %arg_ext)
+; CHECK-NEXT: to label %[[SPLIT:.*]] unwind label %lpad
+; CHECK: [[SPLIT]]:
+; CHECK-NEXT: %r.ret_trunc = trunc i32 %r to i8
+; CHECK-NEXT: br label %join
+; CHECK: join:
+; CHECK-NEXT: %p = phi i8 [ 0, %0 ], [ %r.ret_trunc, %[[SPLIT]] ]
+
+; A PHI node in the normal destination can't use the truncated result,
+; which comes after it.  A single-entry PHI node is folded away.
+define i8 @invoke_phi(i8 %arg) {
+  %r = invoke i8 @small_ext(i8 %arg) to label %cont unwind label %lpad
+cont:
+  %p = phi i8 [ %r, %0 ]
+  ret i8 %p
+lpad:
+  %lp = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (...)* @__gxx_personality_v0 to i8*)
+      cleanup
+  resume { i8*, i32 } %lp
+}
+; CHECK: define i32 @invoke_phi(i32 %arg) {
+; CHECK: %r = invoke i32 %r.arg_cast(i32 %arg_ext)
+; CHECK-NEXT: to label %cont unwind label %lpad
+; CHECK: cont:
+; CHECK-NEXT: %r.ret_trunc = trunc i32 %r to i8
+; CHECK-NEXT: %r.ret_trunc.ret_ext = zext i8 %r.ret_trunc to i32
+; CHECK-NEXT: ret i32 %r.ret_trunc.ret_ext
+
+
 ; Intrinsics must be left alone since the pass cannot change their types.
 
 declare void @llvm.memset.p0i8.i32(i8* nocapture, i8, i32, i32, i1)
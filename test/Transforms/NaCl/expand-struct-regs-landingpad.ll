@@ -0,0 +1,66 @@
+; RUN: opt %s -expand-struct-regs -S | FileCheck %s
+
+; The results of landingpad instructions, which are only left in place
+; when zero-cost exception handling is enabled, keep their struct type.
+
+declare i32 @__gxx_personality_v0(...)
+declare void @may_throw()
+declare void @use(i8*, i32)
+
+define void @extract_fields() {
+  invoke void @may_throw() to label %cont unwind label %lpad
+cont:
+  ret void
+lpad:
+  %lp = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (...)* @__gxx_personality_v0 to i8*)
+      catch i8* null
+  %exc = extractvalue { i8*, i32 } %lp, 0
+  %sel = extractvalue { i8*, i32 } %lp, 1
+  call void @use(i8* %exc, i32 %sel)
+  resume { i8*, i32 } %lp
+}
+; CHECK-LABEL: define void @extract_fields()
+; CHECK: %exc = extractvalue { i8*, i32 } %lp, 0
+; CHECK-NEXT: %sel = extractvalue { i8*, i32 } %lp, 1
+; CHECK-NEXT: call void @use(i8* %exc, i32 %sel)
+; CHECK-NEXT: resume { i8*, i32 } %lp
+
+; Two landing pads that share a cleanup: the phi node is split up, and
+; the value is rebuilt for resume.
+define void @merged_landing_pads() {
+  invoke void @may_throw() to label %next unwind label %lpad1
+next:
+  invoke void @may_throw() to label %cont unwind label %lpad2
+cont:
+  ret void
+lpad1:
+  %lp1 = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (...)* @__gxx_personality_v0 to i8*)
+      cleanup
+  br label %cleanup
+lpad2:
+  %lp2 = landingpad { i8*, i32 }
+      personality i8* bitcast (i32 (...)* @__gxx_personality_v0 to i8*)
+      cleanup
+  br label %cleanup
+cleanup:
+  %lp = phi { i8*, i32 } [ %lp1, %lpad1 ], [ %lp2, %lpad2 ]
+  %sel = extractvalue { i8*, i32 } %lp, 1
+  call void @use(i8* null, i32 %sel)
+  resume { i8*, i32 } %lp
+}
+; CHECK-LABEL: define void @merged_landing_pads()
+; CHECK: lpad1:
+; CHECK: %lp.extract = extractvalue { i8*, i32 } %lp1, 0
+; CHECK-NEXT: %lp.extract3 = extractvalue { i8*, i32 } %lp1, 1
+; CHECK: lpad2:
+; CHECK: %lp.extract1 = extractvalue { i8*, i32 } %lp2, 0
+; CHECK-NEXT: %lp.extract4 = extractvalue { i8*, i32 } %lp2, 1
+; CHECK: cleanup:
+; CHECK-NEXT: %lp.index = phi i8* [ %lp.extract, %lpad1 ], [ %lp.extract1, %lpad2 ]
+; CHECK-NEXT: %lp.index2 = phi i32 [ %lp.extract3, %lpad1 ], [ %lp.extract4, %lpad2 ]
+; CHECK-NEXT: %lp.insert = insertvalue { i8*, i32 } undef, i8* %lp.index, 0
+; CHECK-NEXT: %lp.insert5 = insertvalue { i8*, i32 } %lp.insert, i32 %lp.index2, 1
+; CHECK-NEXT: call void @use(i8* null, i32 %lp.index2)
+; CHECK-NEXT: resume { i8*, i32 } %lp.insert5
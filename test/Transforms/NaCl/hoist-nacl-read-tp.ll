@@ -0,0 +1,99 @@
+; RUN: opt < %s -hoist-nacl-read-tp -S | FileCheck %s
+
+; Test that the thread pointer is read once per function, in the nearest
+; common dominator of the reads, outside of loops.
+
+declare i8* @llvm.nacl.read.tp()
+
+; CHECK-LABEL: @same_block
+define i32 @same_block() {
+  ; CHECK-NEXT: %thread_ptr = call i8* @llvm.nacl.read.tp()
+  ; CHECK-NEXT: %a = bitcast i8* %thread_ptr to i32*
+  ; CHECK-NEXT: %b = bitcast i8* %thread_ptr to i32*
+  ; CHECK-NOT: @llvm.nacl.read.tp
+  %tp1 = call i8* @llvm.nacl.read.tp()
+  %a = bitcast i8* %tp1 to i32*
+  %tp2 = call i8* @llvm.nacl.read.tp()
+  %b = bitcast i8* %tp2 to i32*
+  %x = load i32* %a
+  %y = load i32* %b
+  %r = add i32 %x, %y
+  ret i32 %r
+}
+
+; The reads on both sides of a branch are replaced by one in the block
+; which dominates them.
+; CHECK-LABEL: @diamond
+define i8* @diamond(i1 %c) {
+  ; CHECK: entry:
+  ; CHECK-NEXT: %thread_ptr = call i8* @llvm.nacl.read.tp()
+  ; CHECK-NEXT: br i1 %c
+  ; CHECK-NOT: @llvm.nacl.read.tp
+  ; CHECK: %p = phi i8* [ %thread_ptr, %then ], [ %thread_ptr, %else ]
+entry:
+  br i1 %c, label %then, label %else
+then:
+  %tp1 = call i8* @llvm.nacl.read.tp()
+  br label %join
+else:
+  %tp2 = call i8* @llvm.nacl.read.tp()
+  br label %join
+join:
+  %p = phi i8* [ %tp1, %then ], [ %tp2, %else ]
+  ret i8* %p
+}
+
+; A read in a loop nest is hoisted out of the outermost loop.
+; CHECK-LABEL: @loop
+define i32 @loop(i32 %n) {
+  ; CHECK: entry:
+  ; CHECK-NEXT: %thread_ptr = call i8* @llvm.nacl.read.tp()
+  ; CHECK-NEXT: br label %outer
+  ; CHECK-NOT: @llvm.nacl.read.tp
+  ; CHECK: bitcast i8* %thread_ptr to i32*
+entry:
+  br label %outer
+outer:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %outer.latch ]
+  br label %inner
+inner:
+  %j = phi i32 [ 0, %outer ], [ %j.next, %inner ]
+  %tp = call i8* @llvm.nacl.read.tp()
+  %p = bitcast i8* %tp to i32*
+  store i32 %j, i32* %p
+  %j.next = add i32 %j, 1
+  %j.done = icmp eq i32 %j.next, %n
+  br i1 %j.done, label %outer.latch, label %inner
+outer.latch:
+  %i.next = add i32 %i, 1
+  %i.done = icmp eq i32 %i.next, %n
+  br i1 %i.done, label %exit, label %outer
+exit:
+  ret i32 %i
+}
+
+; A single read outside of loops is left alone.
+; CHECK-LABEL: @single
+define i8* @single(i1 %c) {
+  ; CHECK: then:
+  ; CHECK-NEXT: %tp = call i8* @llvm.nacl.read.tp()
+entry:
+  br i1 %c, label %then, label %else
+then:
+  %tp = call i8* @llvm.nacl.read.tp()
+  ret i8* %tp
+else:
+  ret i8* null
+}
+
+; Reads in unreachable blocks aren't in the dominator tree.
+; CHECK-LABEL: @unreachable
+define i8* @unreachable() {
+  ; CHECK: dead:
+  ; CHECK-NEXT: %tp2 = call i8* @llvm.nacl.read.tp()
+  %tp1 = call i8* @llvm.nacl.read.tp()
+  ret i8* %tp1
+dead:
+  %tp2 = call i8* @llvm.nacl.read.tp()
+  ret i8* %tp2
+}
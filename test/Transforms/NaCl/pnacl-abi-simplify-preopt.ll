@@ -1,4 +1,8 @@
 ; RUN: opt %s -pnacl-abi-simplify-preopt -S | FileCheck %s
+; RUN: opt %s -pnacl-abi-simplify-preopt -enable-pnacl-zero-cost-eh -S | \
+; RUN:   FileCheck %s -check-prefix=ZEROCOST
+; RUN: not opt %s -pnacl-abi-simplify-preopt -enable-pnacl-zero-cost-eh \
+; RUN:   -enable-pnacl-sjlj-eh -S 2>&1 | FileCheck %s -check-prefix=CONFLICT
 
 ; "-pnacl-abi-simplify-preopt" runs various passes which are tested
 ; thoroughly in other *.ll files.  This file is a smoke test to check
@@ -18,6 +22,13 @@ lpad:
 ; CHECK-NOT: invoke void @ext_func()
 ; CHECK-NOT: landingpad
 
+; Zero-cost exception handling leaves invokes for the translator.
+; ZEROCOST: define internal void @invoke_func()
+; ZEROCOST-NEXT: invoke void @ext_func()
+; ZEROCOST: landingpad
+
+; CONFLICT: -enable-pnacl-sjlj-eh and -enable-pnacl-zero-cost-eh are mutually exclusive
+
 
 define void @varargs_func(...) {
   ret void
@@ -0,0 +1,130 @@
+; RUN: opt < %s -resolve-pnacl-intrinsics -S | FileCheck %s
+
+; Test that the memory orders of atomics are kept, and that fences which
+; only non-memory instructions separate are merged.
+
+declare i32 @llvm.nacl.atomic.load.i32(i32*, i32)
+declare void @llvm.nacl.atomic.store.i32(i32, i32*, i32)
+declare i32 @llvm.nacl.atomic.rmw.i32(i32, i32*, i32, i32)
+declare i32 @llvm.nacl.atomic.cmpxchg.i32(i32*, i32, i32, i32, i32)
+declare void @llvm.nacl.atomic.fence(i32)
+declare void @llvm.nacl.atomic.fence.all()
+declare void @external()
+
+; The function pass expects to find these declarations.
+declare i32 @setjmp(i8*)
+declare void @longjmp(i8*, i32)
+
+; CHECK-LABEL: @memory_orders
+define void @memory_orders(i32* %ptr) {
+  ; CHECK-NEXT: %relaxed{{[0-9]*}} = load atomic i32* %ptr monotonic, align 4
+  %relaxed = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 1)
+  ; CHECK-NEXT: %consume{{[0-9]*}} = load atomic i32* %ptr acquire, align 4
+  %consume = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 2)
+  ; CHECK-NEXT: %acquire{{[0-9]*}} = load atomic i32* %ptr acquire, align 4
+  %acquire = call i32 @llvm.nacl.atomic.load.i32(i32* %ptr, i32 3)
+  ; CHECK-NEXT: store atomic i32 0, i32* %ptr monotonic, align 4
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 1)
+  ; CHECK-NEXT: store atomic i32 0, i32* %ptr release, align 4
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 4)
+  ; CHECK-NEXT: %rmw{{[0-9]*}} = atomicrmw add i32* %ptr, i32 1 acq_rel
+  %rmw = call i32 @llvm.nacl.atomic.rmw.i32(i32 1, i32* %ptr, i32 1, i32 5)
+  ; CHECK-NEXT: %cmpxchg{{[0-9]*}} = cmpxchg i32* %ptr, i32 0, i32 1 release
+  %cmpxchg = call i32 @llvm.nacl.atomic.cmpxchg.i32(i32* %ptr, i32 0, i32 1, i32 4, i32 1)
+  ; CHECK-NEXT: ret void
+  ret void
+}
+
+; CHECK-LABEL: @fence_acquire_release
+define void @fence_acquire_release() {
+  ; CHECK-NEXT: fence acq_rel
+  ; CHECK-NEXT: ret void
+  call void @llvm.nacl.atomic.fence(i32 3)
+  call void @llvm.nacl.atomic.fence(i32 4)
+  ret void
+}
+
+; CHECK-LABEL: @fence_same_order
+define void @fence_same_order() {
+  ; CHECK-NEXT: fence release
+  ; CHECK-NEXT: ret void
+  call void @llvm.nacl.atomic.fence(i32 4)
+  call void @llvm.nacl.atomic.fence(i32 4)
+  ret void
+}
+
+; CHECK-LABEL: @fence_seq_cst
+define i32 @fence_seq_cst(i32 %a) {
+  ; CHECK-NEXT: fence seq_cst
+  ; CHECK-NEXT: %b = add i32 %a, 1
+  ; CHECK-NEXT: ret i32 %b
+  call void @llvm.nacl.atomic.fence(i32 5)
+  %b = add i32 %a, 1
+  call void @llvm.nacl.atomic.fence(i32 6)
+  call void @llvm.nacl.atomic.fence(i32 3)
+  ret i32 %b
+}
+
+; The fence.all's compiler barriers are kept.
+; CHECK-LABEL: @fence_all_twice
+define void @fence_all_twice() {
+  ; CHECK-NEXT: call void asm sideeffect "", "~{memory}"()
+  ; CHECK-NEXT: fence seq_cst
+  ; CHECK-NEXT: call void asm sideeffect "", "~{memory}"()
+  ; CHECK-NEXT: call void asm sideeffect "", "~{memory}"()
+  ; CHECK-NEXT: call void asm sideeffect "", "~{memory}"()
+  ; CHECK-NEXT: ret void
+  call void @llvm.nacl.atomic.fence.all()
+  call void @llvm.nacl.atomic.fence.all()
+  ret void
+}
+
+; CHECK-LABEL: @fence_load_between
+define i32 @fence_load_between(i32* %ptr) {
+  ; CHECK-NEXT: fence acquire
+  ; CHECK-NEXT: %l = load i32* %ptr
+  ; CHECK-NEXT: fence acquire
+  ; CHECK-NEXT: ret i32 %l
+  call void @llvm.nacl.atomic.fence(i32 3)
+  %l = load i32* %ptr, align 4
+  call void @llvm.nacl.atomic.fence(i32 3)
+  ret i32 %l
+}
+
+; CHECK-LABEL: @fence_store_between
+define void @fence_store_between(i32* %ptr) {
+  ; CHECK-NEXT: fence release
+  ; CHECK-NEXT: store i32 0, i32* %ptr
+  ; CHECK-NEXT: fence release
+  ; CHECK-NEXT: ret void
+  call void @llvm.nacl.atomic.fence(i32 4)
+  store i32 0, i32* %ptr, align 4
+  call void @llvm.nacl.atomic.fence(i32 4)
+  ret void
+}
+
+; CHECK-LABEL: @fence_call_between
+define void @fence_call_between() {
+  ; CHECK-NEXT: fence seq_cst
+  ; CHECK-NEXT: call void @external()
+  ; CHECK-NEXT: fence seq_cst
+  ; CHECK-NEXT: ret void
+  call void @llvm.nacl.atomic.fence(i32 6)
+  call void @external()
+  call void @llvm.nacl.atomic.fence(i32 6)
+  ret void
+}
+
+; CHECK-LABEL: @fence_across_blocks
+define void @fence_across_blocks() {
+  ; CHECK-NEXT: fence seq_cst
+  ; CHECK-NEXT: br label %next
+  ; CHECK: next:
+  ; CHECK-NEXT: fence seq_cst
+  ; CHECK-NEXT: ret void
+  call void @llvm.nacl.atomic.fence(i32 6)
+  br label %next
+next:
+  call void @llvm.nacl.atomic.fence(i32 6)
+  ret void
+}
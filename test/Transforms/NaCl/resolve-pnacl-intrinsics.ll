@@ -151,9 +151,8 @@ define i32 @test_lock_test_and_set_i32(i32* %ptr, i32 %value) {
 
 ; CHECK: @test_lock_release_i32
 define void @test_lock_release_i32(i32* %ptr) {
-  ; Note that the 'release' was changed to a 'seq_cst'.
-  ; CHECK: store atomic i32 0, i32* %ptr seq_cst, align 4
-  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 6)
+  ; CHECK: store atomic i32 0, i32* %ptr release, align 4
+  call void @llvm.nacl.atomic.store.i32(i32 0, i32* %ptr, i32 4)
   ret void
 }
 
@@ -646,6 +646,7 @@ int main(int argc, char **argv) {
   initializeFlattenGlobalsPass(Registry);
   initializeGlobalCleanupPass(Registry);
   initializeGlobalizeConstantVectorsPass(Registry);
+  initializeHoistNaClReadTpPass(Registry);
   initializeInsertDivideCheckPass(Registry);
   initializePNaClABIVerifyFunctionsPass(Registry);
   initializePNaClABIVerifyModulePass(Registry);
@@ -11,6 +11,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/NaCl.h"
 #include "llvm/Analysis/Verifier.h"
@@ -20,6 +23,7 @@
 #include "llvm/CodeGen/CommandFlags.h"
 #include "llvm/CodeGen/LinkAllAsmWriterComponents.h"
 #include "llvm/CodeGen/LinkAllCodegenComponents.h"
+#include "llvm/CodeGen/MachineScheduler.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -27,21 +31,26 @@
 #include "llvm/MC/SubtargetFeature.h"
 #include "llvm/Pass.h"
 #include "llvm/PassManager.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/DataStream.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Mutex.h"
 #include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Process.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/StreamableMemoryObject.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Timer.h"
 #include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/Trace.h"
 #include "llvm/Target/TargetLibraryInfo.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/NaCl.h"
@@ -150,16 +159,84 @@ SplitModuleSched(
         clEnumValEnd),
     cl::init(SplitModuleDynamic));
 
-/// Compile the module provided to pnacl-llc. The file name for reading the
-/// module and other options are taken from globals populated by command-line
-/// option parsing.
-static int compileModule(StringRef ProgramName);
+// Per-function compile budget. A few functions in a pexe (e.g. with huge
+// switches) can take minutes in the optimizing code generator. Functions with
+// more IR instructions than the budget are compiled as optnone instead, which
+// selects them with FastISel and skips the optional machine passes.
+static cl::opt<unsigned>
+FunctionInstBudget("function-inst-budget",
+  cl::desc("Compile functions with more than this many IR instructions "
+           "with the fast code generation path (0 = no limit)"),
+  cl::init(0));
+
+static cl::opt<unsigned>
+FunctionTimeBudget("function-time-budget",
+  cl::desc("Report functions which take more than this many milliseconds "
+           "to compile (0 = no limit)"),
+  cl::init(0));
+
+// SelectionDAG, MC and the register allocator create short-lived bump
+// allocators for every function. Caching their slabs per thread avoids going
+// back to malloc for each one.
+static cl::opt<bool>
+RecycleSlabs("recycle-slabs",
+  cl::desc("Reuse bump allocator slabs through per-thread caches"),
+  cl::init(true));
+
+static cl::opt<bool>
+HugePageSlabs("huge-page-slabs",
+  cl::desc("With -recycle-slabs, carve slabs out of 2MB huge-page regions"),
+  cl::init(false));
+
+// Startup is a measurable part of the translation of a small pexe. This
+// reports the CPU time spent before main (dynamic linking and static
+// constructors) and the wall time from main to the first function given to
+// the code generator.
+static cl::opt<bool>
+ReportStartupTime("report-startup-time",
+  cl::desc("Report the time to main and to the first function on stderr"),
+  cl::init(false));
+
+// CPU time used before main and wall time at main, for -report-startup-time.
+static double TimeToMain;
+static double MainWallTime;
+
+#if !defined(__native_client__)
+// Server mode. Instead of translating one module, read translation requests
+// from stdin, one per line, each naming an input and an output file:
+//   <input> <output>
+// and answer each on stdout with "<output>: ok" or "<output>: error" once it
+// is done. All requests are translated with the options given on the command
+// line, so targets, options and target machines are set up once and reused.
+// A fatal error still terminates the server.
+static cl::opt<bool>
+ServerMode("server",
+  cl::desc("Translate '<input> <output>' requests read from stdin"),
+  cl::init(false));
+
+static cl::opt<unsigned>
+ServerJobs("server-jobs",
+  cl::desc("Number of requests translated concurrently in server mode"),
+  cl::init(1U));
+
+static int serverMain(StringRef ProgramName);
+#endif
+
+class TargetMachineCache;
+
+/// Compile the module InputName provided to pnacl-llc into OutputName. Other
+/// options are taken from globals populated by command-line option parsing.
+/// If TMCache is non-null, target machines are taken from and returned to it
+/// instead of being created for this module only.
+static int compileModule(StringRef ProgramName, StringRef InputName,
+                         StringRef OutputName,
+                         TargetMachineCache *TMCache = 0);
 
 #if !defined(__native_client__)
 // GetFileNameRoot - Helper function to get the basename of a filename.
 static std::string
-GetFileNameRoot(StringRef InputFilename) {
-  std::string IFN = InputFilename;
+GetFileNameRoot(StringRef InputName) {
+  std::string IFN = InputName;
   std::string outputFilename;
   int Len = IFN.length();
   if ((Len > 2) &&
@@ -175,13 +252,14 @@ GetFileNameRoot(StringRef InputFilename) {
 
 static tool_output_file *GetOutputStream(const char *TargetName,
                                          Triple::OSType OS,
-                                         std::string Filename) {
+                                         std::string Filename,
+                                         StringRef InputName) {
   // If we don't yet have an output filename, make one.
   if (Filename.empty()) {
-    if (InputFilename == "-")
+    if (InputName == "-")
       Filename = "-";
     else {
-      Filename = GetFileNameRoot(InputFilename);
+      Filename = GetFileNameRoot(InputName);
 
       switch (FileType) {
       case TargetMachine::CGFT_AssemblyFile:
@@ -235,9 +313,61 @@ static tool_output_file *GetOutputStream(const char *TargetName,
 }
 #endif // !defined(__native_client__)
 
+static void printRegisteredTargetsForVersion() {
+  InitializeAllTargetInfos();
+  TargetRegistry::printRegisteredTargetsForVersion();
+}
+
+/// Set up the target that TargetRegistry::lookupTarget picks for -march and
+/// -mtriple, with its MC layer and asm printer, but not the other targets.
+/// Returns false if no target matches.
+static bool initializeTargetForTriple(const std::string &TargetTriple) {
+  InitializeAllTargetInfos();
+  Triple TheTriple(TargetTriple);
+  std::string Error;
+  const Target *TheTarget =
+      TargetRegistry::lookupTarget(MArch, TheTriple, Error);
+  if (!TheTarget)
+    return false;
+  // Registering a target's machine is cheap. The first target whose
+  // registration reaches TheTarget is the one whose MC layer and asm printer
+  // are needed.
+  StringRef Name;
+#define LLVM_TARGET(TargetName)                                               \
+  if (Name.empty()) {                                                         \
+    LLVMInitialize##TargetName##Target();                                     \
+    if (TheTarget->hasTargetMachine()) {                                      \
+      LLVMInitialize##TargetName##TargetMC();                                 \
+      Name = #TargetName;                                                     \
+    }                                                                         \
+  }
+#include "llvm/Config/Targets.def"
+  if (Name.empty())
+    return false;
+#define LLVM_ASM_PRINTER(TargetName)                                          \
+  if (Name == #TargetName)                                                    \
+    LLVMInitialize##TargetName##AsmPrinter();
+#include "llvm/Config/AsmPrinters.def"
+  return true;
+}
+
+/// Set up the target for -mtriple. If the triple does not name a target, set
+/// up all of them so that the error reported later lists them.
+static void initializeTarget() {
+  if (!UserDefinedTriple.empty() &&
+      initializeTargetForTriple(Triple::normalize(UserDefinedTriple)))
+    return;
+  InitializeAllTargets();
+  InitializeAllTargetMCs();
+  InitializeAllAsmPrinters();
+}
+
 // main - Entry point for the llc compiler.
 //
 int llc_main(int argc, char **argv) {
+  MainWallTime = TimeRecord::getCurrentTime(true).getWallTime();
+  sys::TimeValue CPUTime = sys::process::get_self()->get_user_time();
+  TimeToMain = CPUTime.seconds() + CPUTime.nanoseconds() / 1e9;
   sys::PrintStackTraceOnErrorSignal();
   PrettyStackTraceProgram X(argc, argv);
 
@@ -250,10 +380,8 @@ int llc_main(int argc, char **argv) {
   install_fatal_error_handler(getSRPCErrorHandler(), NULL);
 #endif
 
-  // Initialize targets first, so that --version shows registered targets.
-  InitializeAllTargets();
-  InitializeAllTargetMCs();
-  InitializeAllAsmPrinters();
+  // Only the target for -mtriple is set up, once the command line has been
+  // parsed; see initializeTarget.
 #if !defined(__native_client__)
   // Prune asm parsing from sandboxed translator.
   // Do not prune "AsmPrinters" because that includes
@@ -271,7 +399,7 @@ int llc_main(int argc, char **argv) {
   initializeUnreachableBlockElimPass(*Registry);
 
   // Register the target printer for --version.
-  cl::AddExtraVersionPrinter(TargetRegistry::printRegisteredTargetsForVersion);
+  cl::AddExtraVersionPrinter(printRegisteredTargetsForVersion);
 
   // Enable the PNaCl ABI verifier by default in sandboxed mode.
 #if defined(__native_client__)
@@ -279,7 +407,13 @@ int llc_main(int argc, char **argv) {
   PNaClABIVerifyFatalErrors = true;
 #endif
 
+  // Pexes from emscripten-style producers can have basic blocks of tens of
+  // thousands of instructions; bound the cost of scheduling them.
+  MISchedWindow = 2048;
+  HugeMemRegion = 1000;
+
   cl::ParseCommandLineOptions(argc, argv, "pnacl-llc\n");
+  initializeTarget();
 
 #if defined(__native_client__)
   // If the user explicitly requests LLVM format in sandboxed mode
@@ -290,10 +424,26 @@ int llc_main(int argc, char **argv) {
   }
 #endif
 
+  // Must happen before any thread is started.
+  if (RecycleSlabs)
+    enableSlabRecycling(HugePageSlabs);
+
+  // No need for dynamic scheduling with one thread.
+  if (SplitModuleCount == 1)
+    SplitModuleSched = SplitModuleStatic;
+
+#if !defined(__native_client__)
+  if (ServerMode) {
+    if (SplitModuleCount > 1 || ServerJobs > 1)
+      LLVMStartMultithreaded();
+    return serverMain(argv[0]);
+  }
+#endif
+
   if (SplitModuleCount > 1)
     LLVMStartMultithreaded();
 
-  return compileModule(argv[0]);
+  return compileModule(argv[0], InputFilename, OutputFilename);
 }
 
 static void CheckABIVerifyErrors(PNaClABIErrorReporter &Reporter,
@@ -312,32 +462,41 @@ static void CheckABIVerifyErrors(PNaClABIErrorReporter &Reporter,
   Reporter.reset();
 }
 
-static Module* getModule(StringRef ProgramName, LLVMContext &Context,
-                         StreamingMemoryObject *StreamingObject) {
+/// Reads the input module into Context. When streaming PNaCl bitcode,
+/// function body offsets are shared with the other threads' readers through
+/// SharedInfo, and if GlobalsAsDeclarations is set the global variables are
+/// read as declarations, which is all a secondary split module needs.
+static Module* getModule(StringRef ProgramName, StringRef InputName,
+                         LLVMContext &Context,
+                         StreamingMemoryObject *StreamingObject,
+                         NaClStreamSharedInfo *SharedInfo = 0,
+                         bool GlobalsAsDeclarations = false) {
+  TraceScope Trace("phase", "parse module");
   Module *M = 0;
   SMDiagnostic Err;
   if (LazyBitcode) {
     std::string StrError;
     if (InputFileFormat == PNaClFormat) {
       M = getNaClStreamedBitcodeModule(
-          InputFilename,
-          new ThreadedStreamingCache(StreamingObject), Context, &StrError);
+          InputName,
+          new ThreadedStreamingCache(StreamingObject), Context, &StrError,
+          /* AcceptSupportedOnly */ true, SharedInfo, GlobalsAsDeclarations);
     } else if (InputFileFormat == LLVMFormat) {
       M = getStreamedBitcodeModule(
-          InputFilename,
+          InputName,
           new ThreadedStreamingCache(StreamingObject), Context, &StrError);
     } else {
       llvm_unreachable("Unknown bitcode format");
     }
     if (!StrError.empty())
-      Err = SMDiagnostic(InputFilename, SourceMgr::DK_Error, StrError);
+      Err = SMDiagnostic(InputName, SourceMgr::DK_Error, StrError);
   } else {
 #if defined(__native_client__)
     llvm_unreachable("native client SRPC only supports streaming");
 #else
     // Parses binary bitcode as well as textual assembly
     // (so pulls in more code into pnacl-llc).
-    M = NaClParseIRFile(InputFilename, InputFileFormat, Err, Context);
+    M = NaClParseIRFile(InputName, InputFileFormat, Err, Context);
 #endif
   }
   if (M == 0) {
@@ -352,6 +511,73 @@ static Module* getModule(StringRef ProgramName, LLVMContext &Context,
   return M;
 }
 
+// Serializes the reports the compile threads print to errs().
+static ManagedStatic<sys::SmartMutex<false> > ReportLock;
+
+static void reportFirstFunction(StringRef ProgramName) {
+  static bool Reported = false;
+  double Now = TimeRecord::getCurrentTime(false).getWallTime();
+  sys::SmartScopedLock<false> Lock(*ReportLock);
+  if (Reported)
+    return;
+  Reported = true;
+  errs() << ProgramName << ": startup: "
+         << format("%.3f", TimeToMain * 1000) << " ms to main, "
+         << format("%.3f", (Now - MainWallTime) * 1000)
+         << " ms from main to the first function\n";
+}
+
+/// Run the code generation passes on F. If F is over the instruction budget
+/// it is first moved to the fast path; functions over either budget are
+/// reported on stderr. The statistics F bumps are recorded for
+/// -stats-per-function.
+static void runFunctionWithBudget(FunctionPassManager &PM, Function &F,
+                                  StringRef ProgramName) {
+  if (ReportStartupTime)
+    reportFirstFunction(ProgramName);
+  // Statistics are counted per thread, so this works with -split-module.
+  beginFunctionStatistics();
+  if (!FunctionInstBudget && !FunctionTimeBudget) {
+    PM.run(F);
+    endFunctionStatistics(F.getName());
+    return;
+  }
+
+  // The pass manager materializes F itself and reports errors doing so; only
+  // count instructions if materialization succeeded.
+  std::string ErrInfo;
+  unsigned NumInsts = 0;
+  if (!F.isMaterializable() || !F.Materialize(&ErrInfo))
+    for (Function::iterator BB = F.begin(), E = F.end(); BB != E; ++BB)
+      NumInsts += BB->size();
+
+  bool Degraded = false;
+  if (FunctionInstBudget && NumInsts > FunctionInstBudget &&
+      OptLevel != '0') {
+    F.removeFnAttr(Attribute::OptimizeForSize);
+    F.removeFnAttr(Attribute::MinSize);
+    F.removeFnAttr(Attribute::AlwaysInline);
+    F.addFnAttr(Attribute::NoInline);
+    F.addFnAttr(Attribute::OptimizeNone);
+    Degraded = true;
+  }
+
+  double Start = TimeRecord::getCurrentTime(true).getWallTime();
+  PM.run(F);
+  unsigned Millis = static_cast<unsigned>(
+      (TimeRecord::getCurrentTime(false).getWallTime() - Start) * 1000);
+  endFunctionStatistics(F.getName());
+  bool OverTime = FunctionTimeBudget && Millis > FunctionTimeBudget;
+
+  if (Degraded || OverTime) {
+    sys::SmartScopedLock<false> Lock(*ReportLock);
+    errs() << ProgramName << ": function '" << F.getName() << "': "
+           << NumInsts << " instructions, " << Millis << " ms"
+           << (Degraded ? ", compiled with the fast path" : "")
+           << (OverTime ? ", over the time budget" : "") << '\n';
+  }
+}
+
 static int runCompilePasses(Module *mod,
                             unsigned ModuleIndex,
                             ThreadedFunctionQueue *FuncQueue,
@@ -381,11 +607,13 @@ static int runCompilePasses(Module *mod,
     }
     if (ModuleIndex > 0) {
       // Remove the initializers for all global variables, turning them into
-      // declarations.
+      // declarations. The PNaCl reader already creates them as declarations
+      // for streamed secondary modules.
       for (Module::global_iterator GI = mod->global_begin(),
           GE = mod->global_end();
           GI != GE; ++GI) {
-        assert(GI->hasInitializer() && "Global variable missing initializer");
+        if (!GI->hasInitializer())
+          continue;
         Constant *Init = GI->getInitializer();
         GI->setInitializer(NULL);
         if (Init->getNumUses() == 0)
@@ -418,6 +646,12 @@ static int runCompilePasses(Module *mod,
   // Add the intrinsic resolution pass. It assumes ABI-conformant code.
   PM->add(createResolvePNaClIntrinsicsPass());
 
+  // Read the thread pointer once per function instead of once per TLS
+  // access.  This needs the dominator tree and loop info, which -O0
+  // doesn't otherwise compute.
+  if (OptLevel != '0')
+    PM->add(createHoistNaClReadTpPass());
+
   // Add an appropriate TargetLibraryInfo pass for the module's triple.
   TargetLibraryInfo *TLI = new TargetLibraryInfo(TheTriple);
   if (DisableSimplifyLibCalls)
@@ -440,14 +674,17 @@ static int runCompilePasses(Module *mod,
     return 1;
   }
 
-  PM->doInitialization();
+  {
+    TraceScope Trace("phase", "initialize passes");
+    PM->doInitialization();
+  }
   if (LazyBitcode) {
     unsigned FuncIndex = 0;
     switch (SplitModuleSched) {
     case SplitModuleStatic:
       for (Module::iterator I = mod->begin(), E = mod->end(); I != E; ++I) {
         if (FuncQueue->GrabFunctionStatic(FuncIndex, ModuleIndex)) {
-          PM->run(*I);
+          runFunctionWithBudget(*PM, *I, ProgramName);
           CheckABIVerifyErrors(ABIErrorReporter, "Function " + I->getName());
           I->Dematerialize();
         }
@@ -469,7 +706,7 @@ static int runCompilePasses(Module *mod,
               ++I;
               continue;
             }
-            PM->run(*I);
+            runFunctionWithBudget(*PM, *I, ProgramName);
             CheckABIVerifyErrors(ABIErrorReporter, "Function " + I->getName());
             I->Dematerialize();
             ++FuncIndex;
@@ -490,37 +727,79 @@ static int runCompilePasses(Module *mod,
     }
   } else {
     for (Module::iterator I = mod->begin(), E = mod->end(); I != E; ++I)
-      PM->run(*I);
+      runFunctionWithBudget(*PM, *I, ProgramName);
+  }
+  {
+    // Emits the object file.
+    TraceScope Trace("phase", "finalize passes");
+    PM->doFinalization();
   }
-  PM->doFinalization();
   return 0;
 }
 
+/// A set of idle target machines, all created with the same options, that
+/// can be reused for the translation of another module. Used by the server
+/// mode so that every request does not pay for target machine creation.
+class TargetMachineCache {
+public:
+  TargetMachineCache() {}
+  ~TargetMachineCache() { DeleteContainerPointers(Idle); }
+
+  /// Returns an idle target machine, or null if there is none.
+  TargetMachine *take() {
+    sys::SmartScopedLock<false> Lock(CacheLock);
+    if (Idle.empty())
+      return 0;
+    TargetMachine *TM = Idle.back();
+    Idle.pop_back();
+    return TM;
+  }
+
+  /// Makes TM available to later translations.
+  void give(TargetMachine *TM) {
+    sys::SmartScopedLock<false> Lock(CacheLock);
+    Idle.push_back(TM);
+  }
+
+private:
+  sys::SmartMutex<false> CacheLock;
+  std::vector<TargetMachine *> Idle;
+};
+
 static int compileSplitModule(const TargetOptions &Options,
                               const Triple &TheTriple,
                               const Target *TheTarget,
                               const std::string &FeaturesStr,
                               CodeGenOpt::Level OLvl,
                               const StringRef &ProgramName,
+                              StringRef InputName,
+                              StringRef OutputName,
                               Module *GlobalModule,
                               StreamingMemoryObject *StreamingObject,
+                              NaClStreamSharedInfo *SharedInfo,
                               unsigned ModuleIndex,
-                              ThreadedFunctionQueue *FuncQueue) {
-  std::auto_ptr<TargetMachine>
-    target(TheTarget->createTargetMachine(TheTriple.getTriple(),
-                                          MCPU, FeaturesStr, Options,
-                                          RelocModel, CMModel, OLvl));
-  assert(target.get() && "Could not allocate target machine!");
-  TargetMachine &Target = *target.get();
-  // Override default to generate verbose assembly.
-  Target.setAsmVerbosityDefault(true);
-  if (RelaxAll) {
-    if (FileType != TargetMachine::CGFT_ObjectFile)
-      errs() << ProgramName
-             << ": warning: ignoring -mc-relax-all because filetype != obj";
-    else
-      Target.setMCRelaxAll(true);
+                              ThreadedFunctionQueue *FuncQueue,
+                              TargetMachineCache *TMCache) {
+  if (SplitModuleCount > 1)
+    setTraceThreadName("module " + utostr(ModuleIndex));
+  TraceScope Trace("phase", "compile module");
+  std::auto_ptr<TargetMachine> target(TMCache ? TMCache->take() : 0);
+  if (!target.get()) {
+    target.reset(TheTarget->createTargetMachine(TheTriple.getTriple(),
+                                                MCPU, FeaturesStr, Options,
+                                                RelocModel, CMModel, OLvl));
+    assert(target.get() && "Could not allocate target machine!");
+    // Override default to generate verbose assembly.
+    target->setAsmVerbosityDefault(true);
+    if (RelaxAll) {
+      if (FileType != TargetMachine::CGFT_ObjectFile)
+        errs() << ProgramName
+               << ": warning: ignoring -mc-relax-all because filetype != obj";
+      else
+        target->setMCRelaxAll(true);
+    }
   }
+  TargetMachine &Target = *target.get();
   // The OwningPtrs are only used if we are not the primary module.
   OwningPtr<LLVMContext> C;
   OwningPtr<Module> M;
@@ -530,7 +809,8 @@ static int compileSplitModule(const TargetOptions &Options,
     mod = GlobalModule;
   } else {
     C.reset(new LLVMContext());
-    mod = getModule(ProgramName, *C, StreamingObject);
+    mod = getModule(ProgramName, InputName, *C, StreamingObject, SharedInfo,
+                    /* GlobalsAsDeclarations */ true);
     if (!mod)
       return 1;
     M.reset(mod);
@@ -547,13 +827,13 @@ static int compileSplitModule(const TargetOptions &Options,
   {
 #if !defined(__native_client__)
       // Figure out where we are going to send the output.
-    std::string N(OutputFilename);
+    std::string N(OutputName);
     raw_string_ostream OutFileName(N);
     if (ModuleIndex > 0)
       OutFileName << ".module" << ModuleIndex;
     OwningPtr<tool_output_file> Out
         (GetOutputStream(TheTarget->getName(), TheTriple.getOS(),
-                         OutFileName.str()));
+                         OutFileName.str(), InputName));
     if (!Out) return 1;
     formatted_raw_ostream FOS(Out->os());
 #else
@@ -574,6 +854,8 @@ static int compileSplitModule(const TargetOptions &Options,
     Out->keep();
 #endif // __native_client__
   }
+  if (TMCache)
+    TMCache->give(target.release());
   return 0;
 }
 
@@ -584,10 +866,14 @@ struct ThreadData {
   std::string FeaturesStr;
   CodeGenOpt::Level OLvl;
   std::string ProgramName;
+  std::string InputName;
+  std::string OutputName;
   Module *GlobalModule;
   StreamingMemoryObject *StreamingObject;
+  NaClStreamSharedInfo *SharedInfo;
   unsigned ModuleIndex;
   ThreadedFunctionQueue *FuncQueue;
+  TargetMachineCache *TMCache;
 };
 
 
@@ -599,14 +885,20 @@ static void *runCompileThread(void *arg) {
                                Data->FeaturesStr,
                                Data->OLvl,
                                Data->ProgramName,
+                               Data->InputName,
+                               Data->OutputName,
                                Data->GlobalModule,
                                Data->StreamingObject,
+                               Data->SharedInfo,
                                Data->ModuleIndex,
-                               Data->FuncQueue);
+                               Data->FuncQueue,
+                               Data->TMCache);
   return reinterpret_cast<void *>(static_cast<intptr_t>(ret));
 }
 
-static int compileModule(StringRef ProgramName) {
+static int compileModule(StringRef ProgramName, StringRef InputName,
+                         StringRef OutputName,
+                         TargetMachineCache *TMCache) {
   // Use a new context instead of the global context for the main module. It must
   // outlive the module object, declared below. We do this because
   // lib/CodeGen/PseudoSourceValue.cpp gets a type from the global context and
@@ -618,6 +910,9 @@ static int compileModule(StringRef ProgramName) {
   Triple TheTriple;
   PNaClABIErrorReporter ABIErrorReporter;
   OwningPtr<StreamingMemoryObject> StreamingObject;
+  // Function body offsets found by any thread's reader, so that the other
+  // threads do not have to scan the stream for them again.
+  NaClStreamSharedInfo SharedInfo;
 
   if (!MainContext) return 1;
 
@@ -627,9 +922,9 @@ static int compileModule(StringRef ProgramName) {
 #else
   if (LazyBitcode) {
     std::string StrError;
-    DataStreamer* FileStreamer(getDataFileStreamer(InputFilename, &StrError));
+    DataStreamer* FileStreamer(getDataFileStreamer(InputName, &StrError));
     if (!StrError.empty()) {
-      SMDiagnostic Err(InputFilename, SourceMgr::DK_Error, StrError);
+      SMDiagnostic Err(InputName, SourceMgr::DK_Error, StrError);
       Err.print(ProgramName.data(), errs());
     }
     if (!FileStreamer)
@@ -637,7 +932,8 @@ static int compileModule(StringRef ProgramName) {
     StreamingObject.reset(new StreamingMemoryObjectImpl(FileStreamer));
   }
 #endif
-  mod.reset(getModule(ProgramName, *MainContext.get(), StreamingObject.get()));
+  mod.reset(getModule(ProgramName, InputName, *MainContext.get(),
+                      StreamingObject.get(), &SharedInfo));
 
   if (!mod) return 1;
 
@@ -724,11 +1020,10 @@ static int compileModule(StringRef ProgramName) {
   ThreadedFunctionQueue FuncQueue(mod.get(), SplitModuleCount);
 
   if (SplitModuleCount == 1) {
-    // No need for dynamic scheduling with one thread.
-    SplitModuleSched = SplitModuleStatic;
+    // Scheduling was already made static by llc_main.
     return compileSplitModule(Options, TheTriple, TheTarget, FeaturesStr,
-                              OLvl, ProgramName, mod.get(), NULL, 0,
-                              &FuncQueue);
+                              OLvl, ProgramName, InputName, OutputName,
+                              mod.get(), NULL, NULL, 0, &FuncQueue, TMCache);
   }
 
   for(unsigned ModuleIndex = 0; ModuleIndex < SplitModuleCount; ++ModuleIndex) {
@@ -738,10 +1033,14 @@ static int compileModule(StringRef ProgramName) {
     ThreadDatas[ModuleIndex].FeaturesStr = FeaturesStr;
     ThreadDatas[ModuleIndex].OLvl = OLvl;
     ThreadDatas[ModuleIndex].ProgramName = ProgramName.str();
+    ThreadDatas[ModuleIndex].InputName = InputName.str();
+    ThreadDatas[ModuleIndex].OutputName = OutputName.str();
     ThreadDatas[ModuleIndex].GlobalModule = mod.get();
     ThreadDatas[ModuleIndex].StreamingObject = StreamingObject.get();
+    ThreadDatas[ModuleIndex].SharedInfo = &SharedInfo;
     ThreadDatas[ModuleIndex].ModuleIndex = ModuleIndex;
     ThreadDatas[ModuleIndex].FuncQueue = &FuncQueue;
+    ThreadDatas[ModuleIndex].TMCache = TMCache;
     if (pthread_create(&Pthreads[ModuleIndex], NULL, runCompileThread,
                         &ThreadDatas[ModuleIndex])) {
       report_fatal_error("Failed to create thread");
@@ -758,6 +1057,75 @@ static int compileModule(StringRef ProgramName) {
   return 0;
 }
 
+#if !defined(__native_client__)
+// Serialize reading requests and writing replies between the server's jobs.
+// They are separate so that a job waiting for the next request does not hold
+// up the reply of a job that has just finished.
+static ManagedStatic<sys::SmartMutex<false> > ServerInputLock;
+static ManagedStatic<sys::SmartMutex<false> > ServerOutputLock;
+
+struct ServerData {
+  std::string ProgramName;
+  TargetMachineCache *TMCache;
+};
+
+/// Reads the next request line from stdin into Line. Returns false at the end
+/// of the input.
+static bool readServerRequest(std::string &Line) {
+  Line.clear();
+  int C;
+  while ((C = getchar()) != EOF && C != '\n')
+    Line += static_cast<char>(C);
+  return C != EOF || !Line.empty();
+}
+
+static void *runServerJob(void *arg) {
+  ServerData *Data = static_cast<ServerData *>(arg);
+  std::string Line;
+  while (1) {
+    {
+      sys::SmartScopedLock<false> Lock(*ServerInputLock);
+      if (!readServerRequest(Line))
+        break;
+    }
+    std::pair<StringRef, StringRef> Request =
+        StringRef(Line).trim().split(' ');
+    StringRef InputName = Request.first;
+    StringRef OutputName = Request.second.trim();
+    if (InputName.empty())
+      continue;
+    int Ret = 1;
+    if (OutputName.empty() || OutputName == "-")
+      errs() << Data->ProgramName << ": " << InputName
+             << ": server requests need an output file\n";
+    else
+      Ret = compileModule(Data->ProgramName, InputName, OutputName,
+                          Data->TMCache);
+    sys::SmartScopedLock<false> Lock(*ServerOutputLock);
+    outs() << (OutputName.empty() ? InputName : OutputName)
+           << (Ret ? ": error\n" : ": ok\n");
+    outs().flush();
+  }
+  return 0;
+}
+
+static int serverMain(StringRef ProgramName) {
+  TargetMachineCache TMCache;
+  ServerData Data = { ProgramName.str(), &TMCache };
+  unsigned NumJobs = std::max(1U, static_cast<unsigned>(ServerJobs));
+  SmallVector<pthread_t, 4> Pthreads(NumJobs);
+  for (unsigned Job = 0; Job < NumJobs; ++Job) {
+    if (pthread_create(&Pthreads[Job], NULL, runServerJob, &Data))
+      report_fatal_error("Failed to create thread");
+  }
+  for (unsigned Job = 0; Job < NumJobs; ++Job) {
+    if (pthread_join(Pthreads[Job], NULL))
+      report_fatal_error("Failed to join thread");
+  }
+  return 0;
+}
+#endif // !defined(__native_client__)
+
 int main(int argc, char **argv) {
 #if defined(__native_client__)
   return srpc_main(argc, argv);
@@ -0,0 +1,103 @@
+//===- llvm/unittest/ADT/FlatStringMapTest.cpp - FlatStringMap unit tests -===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+#include "llvm/ADT/FlatStringMap.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/DataTypes.h"
+#include "llvm/Support/raw_ostream.h"
+using namespace llvm;
+
+namespace {
+
+static StringRef getKey(SmallString<16> &Buf, unsigned I) {
+  Buf.clear();
+  raw_svector_ostream(Buf) << "key" << I;
+  return Buf.str();
+}
+
+TEST(FlatStringMapTest, EmptyMap) {
+  FlatStringMap<uint32_t> Map;
+  EXPECT_EQ(0u, Map.size());
+  EXPECT_TRUE(Map.empty());
+  EXPECT_TRUE(Map.begin() == Map.end());
+  EXPECT_EQ(0u, Map.count("key"));
+  EXPECT_TRUE(Map.find("key") == Map.end());
+  EXPECT_EQ(0u, Map.lookup("key"));
+}
+
+TEST(FlatStringMapTest, InsertFindErase) {
+  FlatStringMap<uint32_t> Map;
+  Map["key"] = 1u;
+  EXPECT_EQ(1u, Map.size());
+  EXPECT_EQ(1u, Map.lookup("key"));
+
+  FlatStringMap<uint32_t>::iterator It = Map.begin();
+  EXPECT_EQ("key", It->getKey());
+  EXPECT_EQ(1u, It->getValue());
+  ++It;
+  EXPECT_TRUE(It == Map.end());
+
+  // Keys need not be null-terminated.
+  EXPECT_TRUE(Map.find(StringRef("keyboard", 3)) == Map.begin());
+
+  EXPECT_TRUE(Map.erase("key"));
+  EXPECT_FALSE(Map.erase("key"));
+  EXPECT_TRUE(Map.empty());
+  EXPECT_TRUE(Map.begin() == Map.end());
+}
+
+// Grow the table through several rehashes, removing and re-adding keys so
+// that tombstones are created and reused.
+TEST(FlatStringMapTest, ManyKeys) {
+  FlatStringMap<uint32_t> Map;
+  SmallString<16> Buf;
+  const unsigned N = 5000;
+  for (unsigned I = 0; I != N; ++I)
+    EXPECT_EQ(I + 1, Map.GetOrCreateValue(getKey(Buf, I), I + 1).getValue());
+  EXPECT_EQ(N, Map.size());
+
+  for (unsigned I = 0; I < N; I += 2)
+    EXPECT_TRUE(Map.erase(getKey(Buf, I)));
+  EXPECT_EQ(N / 2, Map.size());
+
+  for (unsigned I = 0; I != N; ++I)
+    EXPECT_EQ(I % 2 ? I + 1 : 0u, Map.lookup(getKey(Buf, I)));
+
+  for (unsigned I = 0; I < N; I += 2)
+    Map[getKey(Buf, I)] = I + 1;
+  EXPECT_EQ(N, Map.size());
+
+  unsigned Count = 0;
+  for (FlatStringMap<uint32_t>::const_iterator I = Map.begin(), E = Map.end();
+       I != E; ++I) {
+    EXPECT_EQ(Map.lookup(I->getKey()), I->getValue());
+    ++Count;
+  }
+  EXPECT_EQ(N, Count);
+
+  Map.clear();
+  EXPECT_TRUE(Map.empty());
+  EXPECT_EQ(0u, Map.count(getKey(Buf, 1)));
+}
+
+// Entries created outside of the map can be inserted and removed again.
+TEST(FlatStringMapTest, InsertEntry) {
+  FlatStringMap<uint32_t, MallocAllocator> Map;
+  StringMapEntry<uint32_t> *Entry =
+    StringMapEntry<uint32_t>::Create("key", "key" + 3, 1u);
+  EXPECT_TRUE(Map.insert(Entry));
+  EXPECT_FALSE(Map.insert(Entry));
+  EXPECT_EQ(1u, Map.lookup("key"));
+  Map.remove(Entry);
+  EXPECT_TRUE(Map.empty());
+  Entry->Destroy();
+}
+
+}  // anonymous namespace
@@ -12,7 +12,14 @@
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Metadata.h"
 #include "llvm/IR/Module.h"
+// @LOCALMOD-BEGIN
+#include "llvm/Config/config.h"
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+// @LOCALMOD-END
 #include "gtest/gtest.h"
 
 namespace llvm {
@@ -256,5 +263,56 @@ TEST(ConstantsTest, AsInstructionsTest) {
 
 #undef CHECK
 
+// @LOCALMOD-BEGIN
+#if LLVM_ENABLE_THREADS != 0 && defined(HAVE_PTHREAD_H)
+namespace uniquing {
+const unsigned NumThreads = 4;
+const unsigned NumValues = 5000;
+
+struct Results {
+  LLVMContext *Context;
+  Value *Values[NumValues][4];
+};
+
+void *createConstants(void *Arg) {
+  Results *R = static_cast<Results *>(Arg);
+  LLVMContext &C = *R->Context;
+  for (unsigned I = 0; I != NumValues; ++I) {
+    Type *ArrTy = ArrayType::get(Type::getInt8Ty(C), I % 64 + 1);
+    Constant *Int = ConstantInt::get(Type::getInt32Ty(C), I);
+    R->Values[I][0] = Int;
+    R->Values[I][1] = ConstantExpr::getIntToPtr(Int, ArrTy->getPointerTo());
+    R->Values[I][2] = ConstantAggregateZero::get(ArrTy);
+    Value *Op = Int;
+    R->Values[I][3] = MDNode::get(C, Op);
+  }
+  return 0;
+}
+} // end namespace uniquing
+
+TEST(ConstantsTest, ThreadSafeUniquing) {
+  LLVMContext C;
+  EXPECT_FALSE(C.isThreadSafeUniquing());
+  C.enableThreadSafeUniquing();
+  EXPECT_TRUE(C.isThreadSafeUniquing());
+
+  uniquing::Results R[uniquing::NumThreads];
+  pthread_t Threads[uniquing::NumThreads];
+  for (unsigned T = 0; T != uniquing::NumThreads; ++T) {
+    R[T].Context = &C;
+    pthread_create(&Threads[T], NULL, uniquing::createConstants, &R[T]);
+  }
+  for (unsigned T = 0; T != uniquing::NumThreads; ++T)
+    pthread_join(Threads[T], NULL);
+
+  // Every thread must have been handed the same uniqued values.
+  for (unsigned T = 1; T != uniquing::NumThreads; ++T)
+    for (unsigned I = 0; I != uniquing::NumValues; ++I)
+      for (unsigned K = 0; K != 4; ++K)
+        EXPECT_EQ(R[0].Values[I][K], R[T].Values[I][K]);
+}
+#endif
+// @LOCALMOD-END
+
 }  // end anonymous namespace
 }  // end namespace llvm
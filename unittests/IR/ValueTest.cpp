@@ -43,6 +43,49 @@ TEST(ValueTest, UsedInBasicBlock) {
   EXPECT_TRUE(F->arg_begin()->isUsedInBasicBlock(F->begin()));
 }
 
+// @LOCALMOD-BEGIN
+TEST(ValueTest, ReplaceAllUsesWithKeepsUseOrder) {
+  LLVMContext C;
+
+  const char *ModuleString = "define void @f(i32 %x, i32 %y) {\n"
+                             "bb0:\n"
+                             "  %y1 = add i32 %x, 1\n"
+                             "  %y2 = add i32 %x, %y\n"
+                             "  %y3 = add i32 %x, %x\n"
+                             "  %y4 = add i32 %y, 2\n"
+                             "  ret void\n"
+                             "}\n";
+  SMDiagnostic Err;
+  OwningPtr<Module> M(ParseAssemblyString(ModuleString, NULL, Err, C));
+
+  Function *F = M->getFunction("f");
+  Argument *X = F->arg_begin();
+  Argument *Y = ++F->arg_begin();
+
+  // The expected order is what moving each use with Use::set() gives.
+  SmallVector<Use *, 8> Expected;
+  for (Value::use_iterator UI = X->use_begin(), E = X->use_end(); UI != E;
+       ++UI)
+    Expected.insert(Expected.begin(), &UI.getUse());
+  for (Value::use_iterator UI = Y->use_begin(), E = Y->use_end(); UI != E;
+       ++UI)
+    Expected.push_back(&UI.getUse());
+
+  X->replaceAllUsesWith(Y);
+
+  EXPECT_TRUE(X->use_empty());
+  SmallVector<Use *, 8> Actual;
+  for (Value::use_iterator UI = Y->use_begin(), E = Y->use_end(); UI != E;
+       ++UI) {
+    EXPECT_EQ(Y, UI.getUse().get());
+    Actual.push_back(&UI.getUse());
+  }
+  ASSERT_EQ(Expected.size(), Actual.size());
+  for (unsigned I = 0, E = Expected.size(); I != E; ++I)
+    EXPECT_EQ(Expected[I], Actual[I]);
+}
+// @LOCALMOD-END
+
 TEST(GlobalTest, CreateAddressSpace) {
   LLVMContext &Ctx = getGlobalContext();
   OwningPtr<Module> M(new Module("TestModule", Ctx));
@@ -147,4 +147,53 @@ TEST(AllocatorTest, TestBigAlignment) {
   EXPECT_LE(Ptr + 3000, ((uintptr_t)Slab) + Slab->Size);
 }
 
+// @LOCALMOD-BEGIN
+// Slabs freed by one bump allocator are reused by the next one on the same
+// thread instead of going back to the underlying slab allocator.
+TEST(AllocatorTest, TestRecyclingSlabAllocator) {
+  MockSlabAllocator SlabAlloc;
+  RecyclingSlabAllocator Recycler(SlabAlloc);
+  MemSlab *FirstSlab;
+  {
+    BumpPtrAllocator Alloc(4096, 4096, Recycler);
+    Alloc.Allocate(100, 0);
+    FirstSlab = SlabAlloc.GetLastSlab();
+  }
+  {
+    BumpPtrAllocator Alloc(4096, 4096, Recycler);
+    uintptr_t Ptr = (uintptr_t)Alloc.Allocate(100, 0);
+    EXPECT_LE((uintptr_t)FirstSlab, Ptr);
+    EXPECT_GT((uintptr_t)FirstSlab + 4096, Ptr);
+  }
+}
+
+// Slabs that would overflow the cache go back to the underlying allocator.
+TEST(AllocatorTest, TestRecyclingSlabAllocatorLimit) {
+  MockSlabAllocator SlabAlloc;
+  RecyclingSlabAllocator Recycler(SlabAlloc, 4096);
+  MemSlab *A = Recycler.Allocate(4096);
+  MemSlab *B = Recycler.Allocate(4096);
+  Recycler.Deallocate(A);
+  Recycler.Deallocate(B);
+  EXPECT_EQ(A, Recycler.Allocate(4096));
+  Recycler.Deallocate(A);
+}
+
+TEST(AllocatorTest, TestHugePageSlabAllocator) {
+  HugePageSlabAllocator SlabAlloc;
+  MemSlab *A = SlabAlloc.Allocate(4096);
+  MemSlab *B = SlabAlloc.Allocate(8192);
+  EXPECT_EQ(4096U, A->Size);
+  EXPECT_EQ(8192U, B->Size);
+  SlabAlloc.Deallocate(A);
+  EXPECT_EQ(A, SlabAlloc.Allocate(4096));
+  // Sizes that are not a power of two are served by malloc.
+  MemSlab *C = SlabAlloc.Allocate(5000);
+  EXPECT_EQ(5000U, C->Size);
+  SlabAlloc.Deallocate(C);
+  SlabAlloc.Deallocate(B);
+  SlabAlloc.Deallocate(A);
+}
+// @LOCALMOD-END
+
 }  // anonymous namespace
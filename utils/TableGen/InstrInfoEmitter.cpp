@@ -67,18 +67,21 @@ private:
             const std::vector<const CodeGenInstruction*> &NumberedInstructions);
 
   // Operand information.
-  void EmitOperandInfo(raw_ostream &OS, OperandInfoMapTy &OperandInfoIDs);
+  unsigned EmitOperandInfo(raw_ostream &OS,                    // @LOCALMOD
+                           OperandInfoMapTy &OperandInfoIDs);
   std::vector<std::string> GetOperandInfo(const CodeGenInstruction &Inst);
 };
 } // End anonymous namespace
 
+// @LOCALMOD-BEGIN
 static void PrintDefList(const std::vector<Record*> &Uses,
-                         unsigned Num, raw_ostream &OS) {
-  OS << "static const uint16_t ImplicitList" << Num << "[] = { ";
+                         unsigned Index, raw_ostream &OS) {
+  OS << "    /* " << Index << " */ ";
   for (unsigned i = 0, e = Uses.size(); i != e; ++i)
     OS << getQualifiedName(Uses[i]) << ", ";
-  OS << "0 };\n";
+  OS << "0,\n";
 }
+// @LOCALMOD-END
 
 //===----------------------------------------------------------------------===//
 // Operand Info Emission.
@@ -169,27 +172,32 @@ InstrInfoEmitter::GetOperandInfo(const CodeGenInstruction &Inst) {
   return Result;
 }
 
-void InstrInfoEmitter::EmitOperandInfo(raw_ostream &OS,
-                                       OperandInfoMapTy &OperandInfoIDs) {
-  // ID #0 is for no operand info.
-  unsigned OperandListNum = 0;
-  OperandInfoIDs[std::vector<std::string>()] = ++OperandListNum;
-
-  OS << "\n";
+// @LOCALMOD-BEGIN
+/// EmitOperandInfo - Print the initializers of the operand info lists of all
+/// the instructions as one array, and map each list to its index in the
+/// array plus one.  Returns the number of elements printed.
+unsigned InstrInfoEmitter::EmitOperandInfo(raw_ostream &OS,
+                                           OperandInfoMapTy &OperandInfoIDs) {
+  unsigned NumOperandInfos = 0;
   const CodeGenTarget &Target = CDP.getTargetInfo();
   for (CodeGenTarget::inst_iterator II = Target.inst_begin(),
        E = Target.inst_end(); II != E; ++II) {
     std::vector<std::string> OperandInfo = GetOperandInfo(**II);
+    if (OperandInfo.empty())
+      continue;
     unsigned &N = OperandInfoIDs[OperandInfo];
     if (N != 0) continue;
 
-    N = ++OperandListNum;
-    OS << "static const MCOperandInfo OperandInfo" << N << "[] = { ";
+    N = NumOperandInfos + 1;
+    OS << "    /* " << NumOperandInfos << " */ ";
     for (unsigned i = 0, e = OperandInfo.size(); i != e; ++i)
       OS << "{ " << OperandInfo[i] << " }, ";
-    OS << "};\n";
+    OS << "\n";
+    NumOperandInfos += OperandInfo.size();
   }
+  return NumOperandInfos;
 }
+// @LOCALMOD-END
 
 
 /// Initialize data structures for generating operand name mappings.
@@ -360,41 +368,91 @@ void InstrInfoEmitter::run(raw_ostream &OS) {
   const std::string &TargetName = Target.getName();
   Record *InstrInfo = Target.getInstructionSet();
 
-  // Keep track of all of the def lists we have emitted already.
+  // @LOCALMOD-BEGIN
+  // The instruction descriptors, the operand info lists and the implicit
+  // register lists are the members of one object, so that the descriptors
+  // can refer to the lists by offsets that are constants instead of by
+  // pointers that need relocating; see MCInstrTablePtr.
+
+  // Keep track of all of the def lists we have emitted already, mapping
+  // each to its index in the ImplicitLists array plus one.
   std::map<std::vector<Record*>, unsigned> EmittedLists;
-  unsigned ListNumber = 0;
+  std::string ImplicitListsStr;
+  raw_string_ostream ImplicitListsOS(ImplicitListsStr);
+  unsigned NumImplicit = 0;
 
-  // Emit all of the instruction's implicit uses and defs.
+  // Print all of the instruction's implicit uses and defs.
   for (CodeGenTarget::inst_iterator II = Target.inst_begin(),
          E = Target.inst_end(); II != E; ++II) {
     Record *Inst = (*II)->TheDef;
     std::vector<Record*> Uses = Inst->getValueAsListOfDefs("Uses");
     if (!Uses.empty()) {
       unsigned &IL = EmittedLists[Uses];
-      if (!IL) PrintDefList(Uses, IL = ++ListNumber, OS);
+      if (!IL) {
+        IL = NumImplicit + 1;
+        PrintDefList(Uses, NumImplicit, ImplicitListsOS);
+        NumImplicit += Uses.size() + 1;
+      }
     }
     std::vector<Record*> Defs = Inst->getValueAsListOfDefs("Defs");
     if (!Defs.empty()) {
       unsigned &IL = EmittedLists[Defs];
-      if (!IL) PrintDefList(Defs, IL = ++ListNumber, OS);
+      if (!IL) {
+        IL = NumImplicit + 1;
+        PrintDefList(Defs, NumImplicit, ImplicitListsOS);
+        NumImplicit += Defs.size() + 1;
+      }
     }
   }
 
   OperandInfoMapTy OperandInfoIDs;
 
-  // Emit all of the operand info records.
-  EmitOperandInfo(OS, OperandInfoIDs);
+  // Print all of the operand info records.
+  std::string OperandInfoStr;
+  raw_string_ostream OperandInfoOS(OperandInfoStr);
+  unsigned NumOperandInfos = EmitOperandInfo(OperandInfoOS, OperandInfoIDs);
 
-  // Emit all of the MCInstrDesc records in their ENUM ordering.
-  //
-  OS << "\nextern const MCInstrDesc " << TargetName << "Insts[] = {\n";
   const std::vector<const CodeGenInstruction*> &NumberedInstructions =
     Target.getInstructionsByEnumValue();
 
+  std::string TableTy = TargetName + "InstrTable";
+  OS << "namespace {\n"
+     << "struct " << TableTy << " {\n"
+     << "  MCInstrDesc Insts[" << NumberedInstructions.size() << "];\n"
+     << "  MCOperandInfo OperandInfo[" << std::max(NumOperandInfos, 1U)
+     << "];\n"
+     << "  uint16_t ImplicitLists[" << std::max(NumImplicit, 1U) << "];\n"
+     << "};\n"
+     << "} // End anonymous namespace\n\n";
+
+  // Offsets from the field of the descriptor of instruction Num to element
+  // Index of the operand info and implicit list arrays.
+  std::string Prefix = StringRef(TargetName).upper();
+  OS << "#define " << Prefix << "_OPERAND_INFO(Num, Index) \\\n"
+     << "  { int32_t(offsetof(" << TableTy << ", OperandInfo)) + \\\n"
+     << "    int32_t((Index) * sizeof(MCOperandInfo)) - \\\n"
+     << "    int32_t((Num) * sizeof(MCInstrDesc)) - \\\n"
+     << "    int32_t(offsetof(MCInstrDesc, OpInfo)) }\n";
+  OS << "#define " << Prefix << "_IMPLICIT_LIST(Num, Field, Index) \\\n"
+     << "  { int32_t(offsetof(" << TableTy << ", ImplicitLists)) + \\\n"
+     << "    int32_t((Index) * sizeof(uint16_t)) - \\\n"
+     << "    int32_t((Num) * sizeof(MCInstrDesc)) - \\\n"
+     << "    int32_t(offsetof(MCInstrDesc, Field)) }\n\n";
+
+  // Emit all of the MCInstrDesc records in their ENUM ordering.
+  //
+  OS << "static const " << TableTy << " The" << TableTy << " = {\n  {\n";
   for (unsigned i = 0, e = NumberedInstructions.size(); i != e; ++i)
     emitRecord(*NumberedInstructions[i], i, InstrInfo, EmittedLists,
                OperandInfoIDs, OS);
-  OS << "};\n\n";
+  OS << "  },\n  {\n" << OperandInfoOS.str() << "  },\n"
+     << "  {\n" << ImplicitListsOS.str() << "  }\n};\n\n";
+  OS << "#undef " << Prefix << "_OPERAND_INFO\n"
+     << "#undef " << Prefix << "_IMPLICIT_LIST\n\n";
+
+  OS << "extern const MCInstrDesc *const " << TargetName << "Insts = The"
+     << TableTy << ".Insts;\n\n";
+  // @LOCALMOD-END
 
   // Build an array of instruction names
   SequenceToOffsetTable<std::string> InstrNames;
@@ -447,7 +505,8 @@ void InstrInfoEmitter::run(raw_ostream &OS) {
   OS << "#undef GET_INSTRINFO_CTOR_DTOR\n";
 
   OS << "namespace llvm {\n";
-  OS << "extern const MCInstrDesc " << TargetName << "Insts[];\n";
+  OS << "extern const MCInstrDesc *const " << TargetName // @LOCALMOD
+     << "Insts;\n";                                      // @LOCALMOD
   OS << "extern const unsigned " << TargetName << "InstrNameIndices[];\n";
   OS << "extern const char " << TargetName << "InstrNameData[];\n";
   OS << ClassName << "::" << ClassName << "(int SO, int DO)\n"
@@ -476,7 +535,7 @@ void InstrInfoEmitter::emitRecord(const CodeGenInstruction &Inst, unsigned Num,
     MinOperands = Inst.Operands.back().MIOperandNo +
                   Inst.Operands.back().MINumOperands;
 
-  OS << "  { ";
+  OS << "    { "; // @LOCALMOD
   OS << Num << ",\t" << MinOperands << ",\t"
      << Inst.Operands.NumDefs << ",\t"
      << SchedModels.getSchedClassIdx(Inst) << ",\t"
@@ -527,25 +586,31 @@ void InstrInfoEmitter::emitRecord(const CodeGenInstruction &Inst, unsigned Num,
   OS.write_hex(Value);
   OS << "ULL, ";
 
+  // @LOCALMOD-BEGIN
   // Emit the implicit uses and defs lists...
+  std::string Prefix = StringRef(CDP.getTargetInfo().getName()).upper();
   std::vector<Record*> UseList = Inst.TheDef->getValueAsListOfDefs("Uses");
   if (UseList.empty())
-    OS << "NULL, ";
+    OS << "{0}, ";
   else
-    OS << "ImplicitList" << EmittedLists[UseList] << ", ";
+    OS << Prefix << "_IMPLICIT_LIST(" << Num << ", ImplicitUses, "
+       << EmittedLists[UseList] - 1 << "), ";
 
   std::vector<Record*> DefList = Inst.TheDef->getValueAsListOfDefs("Defs");
   if (DefList.empty())
-    OS << "NULL, ";
+    OS << "{0}, ";
   else
-    OS << "ImplicitList" << EmittedLists[DefList] << ", ";
+    OS << Prefix << "_IMPLICIT_LIST(" << Num << ", ImplicitDefs, "
+       << EmittedLists[DefList] - 1 << "), ";
 
   // Emit the operand info.
   std::vector<std::string> OperandInfo = GetOperandInfo(Inst);
   if (OperandInfo.empty())
-    OS << "0";
+    OS << "{0}";
   else
-    OS << "OperandInfo" << OpInfo.find(OperandInfo)->second;
+    OS << Prefix << "_OPERAND_INFO(" << Num << ", "
+       << OpInfo.find(OperandInfo)->second - 1 << ")";
+  // @LOCALMOD-END
 
   CodeGenTarget &Target = CDP.getTargetInfo();
   if (Inst.HasComplexDeprecationPredicate)